@@ -0,0 +1,958 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+#include "students_array_w_ops.h"
+#include "thread_pool_w_ops.h"
+#include "students_loader_w_ops.h"
+#include "students_view_w_ops.h"
+#include "surname_trigram_index_w_ops.h"
+#include "students_tree_w_ops.h"
+#include "students_shared_w_ops.h"
+#include "students_journal_w_ops.h"
+#include "students_groups_w_ops.h"
+#include "students_filter_w_ops.h"
+#include "students_top_k_w_ops.h"
+#include "students_bitmap_index_w_ops.h"
+#include "surname_sorted_index_w_ops.h"
+#include "students_aggregates_w_ops.h"
+
+/**
+ * Benchmarks for students_array operations.
+ * Usage: ./build/bench [max_power_of_ten]
+ *  (default is 7, i.e. the largest collection has 10^7 records)
+ * Load benchmark uses records with NULL strings, 
+ *  so only container costs are measured.
+ * Sort benchmarks use 10^(max_power_of_ten - 1) records 
+ *  with random 8-letter surnames, so does input benchmark 
+ *  (it writes them to a temporary file in four-line format).
+ * Ordered container benchmark uses 10 times fewer records,
+ *  so does concurrent reads benchmark
+*/
+
+#define DEFAULT_MAX_POWER 7
+
+static double now_seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static student make_student(size_t i) {
+    student s;
+    s.surname = NULL;
+    s.grade_book_num = (int) i;
+    s.faculty = NULL;
+    s.group = NULL;
+    return s;
+}
+
+/**
+ * Growth strategy st_add() used before: realloc() to capacity + 1
+ *  on every insertion. Kept here as a baseline
+*/
+static int legacy_add(students_array* collection, student entry) {
+    if (collection->students_num == collection->capacity) {
+        student* new_students_buf =
+            (student*) realloc(collection->students,
+                sizeof(*(collection->students))*(collection->capacity + 1));
+        if (NULL == new_students_buf) {
+            return STS_MEM_ALLOC_ERROR;
+        }
+        collection->students = new_students_buf;
+        collection->capacity++;
+    }
+    (collection->students)[collection->students_num] = entry;
+    collection->students_num++;
+    return 0;
+}
+
+static void free_container(students_array* collection) {
+    free(collection->students);
+    free(collection);
+}
+
+static void bench_load(size_t n) {
+    students_array* legacy = st_new_array(0);
+    students_array* added = st_new_array(0);
+    students_array* bulk = st_new_array(0);
+    student* entries = (student*) malloc(sizeof(*entries) * n);
+    if (NULL == legacy || NULL == added || NULL == bulk || NULL == entries) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        entries[i] = make_student(i);
+    }
+
+    double start = now_seconds();
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != legacy_add(legacy, entries[i])) {
+            fprintf(stderr, "legacy_add failed\n");
+            exit(1);
+        }
+    }
+    double legacy_time = now_seconds() - start;
+
+    start = now_seconds();
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != st_add(added, entries[i])) {
+            fprintf(stderr, "st_add failed\n");
+            exit(1);
+        }
+    }
+    double add_time = now_seconds() - start;
+
+    start = now_seconds();
+    if (0 != st_add_bulk(bulk, entries, n)) {
+        fprintf(stderr, "st_add_bulk failed\n");
+        exit(1);
+    }
+    double bulk_time = now_seconds() - start;
+
+    printf("%10zu %14.6f %14.6f %14.6f\n", n, legacy_time, add_time, bulk_time);
+
+    free(entries);
+    free_container(legacy);
+    free_container(added);
+    free_container(bulk);
+}
+
+#define SURNAME_LEN 8
+
+static int surname_asc(const void* arg1, const void* arg2) {
+    return strcmp(((const student*) arg1)->surname, 
+                  ((const student*) arg2)->surname);
+}
+
+/**
+ * Arena collection of 'n' students with random surnames
+*/
+static students_array* make_random_collection(size_t n) {
+    students_array* collection = st_new_array_arena(n);
+    if (NULL == collection) {
+        return NULL;
+    }
+    srand(42);
+    char surname[SURNAME_LEN + 1];
+    char faculty[] = "F";
+    char group[] = "G";
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < SURNAME_LEN; ++j) {
+            surname[j] = 'a' + rand() % 26;
+        }
+        surname[SURNAME_LEN] = '\0';
+        student s;
+        s.surname = surname;
+        s.grade_book_num = rand();
+        s.faculty = faculty;
+        s.group = group;
+        if (0 != st_add(collection, s)) {
+            sts_destroy_all(&collection);
+            return NULL;
+        }
+    }
+    return collection;
+}
+
+static void bench_parallel_sort(size_t n) {
+    students_array* collection = make_random_collection(n);
+    student* original = (student*) malloc(sizeof(*original) * n);
+    if (NULL == collection || NULL == original) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    memcpy(original, collection->students, sizeof(*original) * n);
+
+    printf("\nSort by surname, %zu records, seconds\n", n);
+    printf("%10s %14s %10s\n", "threads", "time", "speedup");
+    double serial_time = 0;
+    size_t cpus_num = tp_cpus_num();
+    size_t threads_num = 1;
+    while (threads_num <= cpus_num) {
+        memcpy(collection->students, original, sizeof(*original) * n);
+        double start = now_seconds();
+        sts_sort_any_parallel(collection, surname_asc, threads_num);
+        double time = now_seconds() - start;
+        if (1 == threads_num) {
+            serial_time = time;
+        }
+        printf("%10zu %14.6f %10.2f\n", threads_num, time, serial_time / time);
+        if ((threads_num < cpus_num) && (threads_num * 2 > cpus_num)) {
+            // Making sure the last row is for all CPUs
+            threads_num = cpus_num;
+        }
+        else {
+            threads_num *= 2;
+        }
+    }
+
+    free(original);
+    sts_destroy_all(&collection);
+}
+
+static int grade_book_num_asc(const void* arg1, const void* arg2) {
+    int num1 = ((const student*) arg1)->grade_book_num;
+    int num2 = ((const student*) arg2)->grade_book_num;
+    return (num1 > num2) - (num1 < num2);
+}
+
+static void bench_radix_sort(size_t n) {
+    students_array* collection = make_random_collection(n);
+    student* original = (student*) malloc(sizeof(*original) * n);
+    if (NULL == collection || NULL == original) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    memcpy(original, collection->students, sizeof(*original) * n);
+
+    printf("\nRadix sort vs qsort(), %zu records, seconds\n", n);
+    printf("%16s %14s %14s\n", "key", "qsort()", "radix");
+
+    double start = now_seconds();
+    qsort(collection->students, n, sizeof(*original), grade_book_num_asc);
+    double qsort_time = now_seconds() - start;
+    memcpy(collection->students, original, sizeof(*original) * n);
+    start = now_seconds();
+    sts_sort_grade_book_num_radix_asc(collection);
+    double radix_time = now_seconds() - start;
+    printf("%16s %14.6f %14.6f\n", "grade_book_num", qsort_time, radix_time);
+
+    memcpy(collection->students, original, sizeof(*original) * n);
+    start = now_seconds();
+    qsort(collection->students, n, sizeof(*original), surname_asc);
+    qsort_time = now_seconds() - start;
+    memcpy(collection->students, original, sizeof(*original) * n);
+    start = now_seconds();
+    sts_sort_surname_radix_asc(collection);
+    radix_time = now_seconds() - start;
+    printf("%16s %14.6f %14.6f\n", "surname", qsort_time, radix_time);
+
+    free(original);
+    sts_destroy_all(&collection);
+}
+
+static double time_interactive_input(FILE* input, FILE* null_stream) {
+    students_array* collection = st_new_array(0);
+    if (NULL == collection) {
+        fprintf(stderr, "st_new_array failed\n");
+        exit(1);
+    }
+    rewind(input);
+    double start = now_seconds();
+    while (0 == st_interactive_add(collection, input, null_stream)) {
+    }
+    double time = now_seconds() - start;
+    sts_destroy_all(&collection);
+    return time;
+}
+
+static double time_stream_load(FILE* input) {
+    students_array* collection = st_new_array_arena(0);
+    if (NULL == collection) {
+        fprintf(stderr, "st_new_array_arena failed\n");
+        exit(1);
+    }
+    rewind(input);
+    double start = now_seconds();
+    if (0 != st_load(collection, input, STS_FORMAT_LINES, stderr, NULL)) {
+        fprintf(stderr, "st_load failed\n");
+        exit(1);
+    }
+    double time = now_seconds() - start;
+    sts_destroy_all(&collection);
+    return time;
+}
+
+static void bench_input(size_t n) {
+    students_array* collection = make_random_collection(n);
+    FILE* input = tmpfile();
+    FILE* null_stream = fopen("/dev/null", "w");
+    if (NULL == collection || NULL == input || NULL == null_stream) {
+        fprintf(stderr, "Preparing input failed for n == %zu\n", n);
+        exit(1);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        student* s = collection->students + i;
+        fprintf(input, "%s\n%d\n%s\n%s\n", s->surname, s->grade_book_num, 
+                s->faculty, s->group);
+    }
+    sts_destroy_all(&collection);
+
+    printf("\nReading %zu records, seconds\n", n);
+    printf("%20s %14s\n", "st_interactive_add", "st_load");
+    double interactive_time = time_interactive_input(input, null_stream);
+    double load_time = time_stream_load(input);
+    printf("%20.6f %14.6f\n", interactive_time, load_time);
+
+    fclose(input);
+    fclose(null_stream);
+}
+
+static int faculty_group_surname_asc(const void* arg1, const void* arg2) {
+    const student* s1 = (const student*) arg1;
+    const student* s2 = (const student*) arg2;
+    int cmp_result = strcmp(s1->faculty, s2->faculty);
+    if (0 == cmp_result) {
+        cmp_result = strcmp(s1->group, s2->group);
+    }
+    return (0 != cmp_result) ? cmp_result : strcmp(s1->surname, s2->surname);
+}
+
+static void bench_multi_key_sort(size_t n) {
+    students_array* collection = make_random_collection(n);
+    student* original = (student*) malloc(sizeof(*original) * n);
+    if (NULL == collection || NULL == original) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    // Few distinct faculties and groups, so all three keys matter
+    for (size_t i = 0; i < n; ++i) {
+        collection->students[i].faculty = (i % 3) ? "FA" : "FB";
+        collection->students[i].group = (i % 7) ? "G1" : "G2";
+    }
+    memcpy(original, collection->students, sizeof(*original) * n);
+
+    printf("\nSort by faculty, group, surname, %zu records, seconds\n", n);
+    printf("%14s %14s\n", "qsort()", "kernel");
+    double start = now_seconds();
+    qsort(collection->students, n, sizeof(*original), faculty_group_surname_asc);
+    double qsort_time = now_seconds() - start;
+    memcpy(collection->students, original, sizeof(*original) * n);
+    students_sort_spec keys[] = {
+        {STS_SORTED_BY_FACULTY, false}, 
+        {STS_SORTED_BY_GROUP, false}, 
+        {STS_SORTED_BY_SURNAME, false}, 
+    };
+    start = now_seconds();
+    sts_sort_multi_key(collection, keys, sizeof(keys) / sizeof(*keys));
+    double kernel_time = now_seconds() - start;
+    printf("%14.6f %14.6f\n", qsort_time, kernel_time);
+
+    // Strings set above are not in arena, so they must not be freed
+    free(original);
+    sts_destroy_all(&collection);
+}
+
+#define FUZZY_QUERIES_NUM 100
+
+static void bench_fuzzy_search(size_t n) {
+    students_array* collection = make_random_collection(n);
+    if (NULL == collection) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    double start = now_seconds();
+    surname_trigram_index* index = sti_new(collection);
+    double build_time = now_seconds() - start;
+    if (NULL == index) {
+        fprintf(stderr, "sti_new failed\n");
+        exit(1);
+    }
+    printf("\nFuzzy surname search (1 edit), %zu records, "
+           "%d queries, seconds\n", n, FUZZY_QUERIES_NUM);
+    printf("%14s %14s %14s\n", "index build", "full scan", "index");
+    double scan_time = 0;
+    double index_time = 0;
+    for (size_t i = 0; i < FUZZY_QUERIES_NUM; ++i) {
+        // Existing surname with one letter changed
+        char query[SURNAME_LEN + 1];
+        strcpy(query, collection->students[i * (n / FUZZY_QUERIES_NUM)].surname);
+        query[i % SURNAME_LEN] = 'a' + (query[i % SURNAME_LEN] - 'a' + 1) % 26;
+        start = now_seconds();
+        students_view* scanned = st_view_fuzzy_surname(collection, query, 1);
+        scan_time += now_seconds() - start;
+        start = now_seconds();
+        students_view* found = sti_find_fuzzy(index, query, 1);
+        index_time += now_seconds() - start;
+        if (NULL == scanned || NULL == found || 
+            scanned->positions_num != found->positions_num) {
+            fprintf(stderr, "Fuzzy search failed\n");
+            exit(1);
+        }
+        stv_destroy(&scanned);
+        stv_destroy(&found);
+    }
+    printf("%14.6f %14.6f %14.6f\n", build_time, scan_time, index_time);
+    sti_destroy(&index);
+    sts_destroy_all(&collection);
+}
+
+#define ORDERED_BATCH_SIZE 1000
+
+/**
+ * Batches of insertions, each followed by an ordered read:
+ *  array has to be re-sorted before every read, tree stays sorted
+*/
+static void bench_ordered_inserts(size_t n) {
+    students_array* collection = st_new_array(0);
+    students_tree* tree = stt_new(STS_SORTED_BY_GRADE_BOOK_NUM);
+    if (NULL == collection || NULL == tree) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    printf("\nInsert %zu records in batches of %d, closest lookup "
+           "after every batch, seconds\n", n, ORDERED_BATCH_SIZE);
+    printf("%14s %14s\n", "st_add+sort", "students_tree");
+    srand(7);
+    double array_time = 0;
+    double tree_time = 0;
+    size_t found_num = 0;
+    for (size_t i = 0; i < n; ++i) {
+        student entry = make_student(rand());
+        double start = now_seconds();
+        if (0 != st_add(collection, entry)) {
+            fprintf(stderr, "st_add failed\n");
+            exit(1);
+        }
+        array_time += now_seconds() - start;
+        start = now_seconds();
+        if (0 != stt_insert(tree, entry)) {
+            fprintf(stderr, "stt_insert failed\n");
+            exit(1);
+        }
+        tree_time += now_seconds() - start;
+        if (0 != (i + 1) % ORDERED_BATCH_SIZE) {
+            continue;
+        }
+        student probe = make_student(rand());
+        start = now_seconds();
+        sts_sort_grade_book_num_asc(collection);
+        const student* array_found = 
+            st_find_one_closest_grade_book_num(collection, probe.grade_book_num);
+        array_time += now_seconds() - start;
+        start = now_seconds();
+        const student* tree_found = stt_find_closest(tree, &probe);
+        tree_time += now_seconds() - start;
+        found_num += (NULL != array_found) && (NULL != tree_found);
+    }
+    printf("%14.6f %14.6f\n", array_time, tree_time);
+    if (n / ORDERED_BATCH_SIZE != found_num) {
+        fprintf(stderr, "Closest lookup failed\n");
+        exit(1);
+    }
+    sts_destroy_all(&collection);
+    stt_destroy(&tree);
+}
+
+#define SHARED_READS_PER_THREAD 100000
+#define SHARED_BATCH_SIZE 100
+
+/**
+ * Either 'shared' or 'locked' (guarded by 'lock') is used
+*/
+typedef struct shared_reads_bench {
+    students_shared* shared;
+    students_array* locked;
+    pthread_rwlock_t lock;
+    atomic_size_t running_readers;
+} shared_reads_bench;
+
+static void* shared_reads_reader(void* arg) {
+    shared_reads_bench* bench = (shared_reads_bench*) arg;
+    size_t reader = (NULL == bench->shared) ? 
+        STSH_NO_READER : stsh_reader_register(bench->shared);
+    unsigned seed = (unsigned) (size_t) &reader;
+    for (size_t i = 0; i < SHARED_READS_PER_THREAD; ++i) {
+        size_t value = (size_t) rand_r(&seed);
+        if (STSH_NO_READER != reader) {
+            const students_array* version = 
+                stsh_read_begin(bench->shared, reader);
+            st_find_one_closest_grade_book_num(version, value);
+            stsh_read_end(bench->shared, reader);
+        }
+        else {
+            pthread_rwlock_rdlock(&bench->lock);
+            st_find_one_closest_grade_book_num(bench->locked, value);
+            pthread_rwlock_unlock(&bench->lock);
+        }
+    }
+    if (STSH_NO_READER != reader) {
+        stsh_reader_unregister(bench->shared, reader);
+    }
+    atomic_fetch_sub(&bench->running_readers, 1);
+    return NULL;
+}
+
+/**
+ * Readers do closest lookups while this thread keeps adding batches.
+ *  Returns seconds until all readers are done, *batches_num is set
+ *  to the number of batches written meanwhile
+*/
+static double time_shared_reads(shared_reads_bench* bench, 
+                                size_t readers_num, size_t* batches_num) {
+    pthread_t* readers = (pthread_t*) malloc(sizeof(*readers) * readers_num);
+    if (NULL == readers) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    atomic_store(&bench->running_readers, readers_num);
+    double start = now_seconds();
+    for (size_t i = 0; i < readers_num; ++i) {
+        if (0 != pthread_create(readers + i, NULL, shared_reads_reader, bench)) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(1);
+        }
+    }
+    *batches_num = 0;
+    char name[] = "new";
+    while (0 != atomic_load(&bench->running_readers)) {
+        if (NULL != bench->shared) {
+            for (size_t i = 0; i < SHARED_BATCH_SIZE; ++i) {
+                student entry = {name, rand(), name, name};
+                stsh_add(bench->shared, &entry);
+            }
+            stsh_publish(bench->shared);
+        }
+        else {
+            pthread_rwlock_wrlock(&bench->lock);
+            for (size_t i = 0; i < SHARED_BATCH_SIZE; ++i) {
+                student entry = {name, rand(), name, name};
+                st_add(bench->locked, entry);
+            }
+            sts_sort_grade_book_num_asc(bench->locked);
+            pthread_rwlock_unlock(&bench->lock);
+        }
+        ++*batches_num;
+    }
+    for (size_t i = 0; i < readers_num; ++i) {
+        pthread_join(readers[i], NULL);
+    }
+    free(readers);
+    return now_seconds() - start;
+}
+
+static void bench_shared_reads(size_t n) {
+    size_t readers_num = tp_cpus_num();
+    shared_reads_bench bench;
+    bench.locked = make_random_collection(n);
+    if (NULL == bench.locked) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    bench.shared = NULL;
+    pthread_rwlock_init(&bench.lock, NULL);
+    sts_sort_grade_book_num_asc(bench.locked);
+    printf("\nClosest lookups, %zu readers x %d, %zu records, "
+           "batches of %d added meanwhile, seconds (batches)\n", 
+           readers_num, SHARED_READS_PER_THREAD, n, SHARED_BATCH_SIZE);
+    printf("%24s %24s\n", "rwlock", "epoch snapshots");
+    size_t locked_batches = 0;
+    double locked_time = time_shared_reads(&bench, readers_num, &locked_batches);
+    students_shared* shared = 
+        stsh_new_from_array(bench.locked, STS_SORTED_BY_GRADE_BOOK_NUM);
+    if (NULL == shared) {
+        fprintf(stderr, "stsh_new_from_array failed\n");
+        exit(1);
+    }
+    bench.shared = shared;
+    size_t shared_batches = 0;
+    double shared_time = time_shared_reads(&bench, readers_num, &shared_batches);
+    printf("%14.6f (%7zu) %14.6f (%7zu)\n", locked_time, locked_batches, 
+           shared_time, shared_batches);
+    stsh_destroy(&shared);
+    pthread_rwlock_destroy(&bench.lock);
+    sts_destroy_all(&bench.locked);
+}
+
+#define JOURNAL_GROUP_SIZE 64
+#define JOURNAL_BENCH_PATH "./build/bench_journal.bin"
+
+/**
+ * Adds records of 'source' committing after every 'group_size' of them
+*/
+static double time_journal_adds(const students_array* source, size_t group_size, 
+                                size_t fsync_every_commits) {
+    remove(JOURNAL_BENCH_PATH);
+    remove(JOURNAL_BENCH_PATH ".journal");
+    students_journal_options options = stj_default_options();
+    options.fsync_every_commits = fsync_every_commits;
+    options.compact_threshold = 0;
+    int error = 0;
+    students_journal* journal = stj_open(JOURNAL_BENCH_PATH, &options, &error);
+    if (NULL == journal) {
+        fprintf(stderr, "stj_open failed, code == %d\n", error);
+        exit(1);
+    }
+    double start = now_seconds();
+    for (size_t i = 0; i < source->students_num; ++i) {
+        error = stj_add(journal, source->students[i]);
+        if ((0 == error) && (0 == (i + 1) % group_size)) {
+            error = stj_commit(journal);
+        }
+        if (0 != error) {
+            fprintf(stderr, "Journal append failed, code == %d\n", error);
+            exit(1);
+        }
+    }
+    error = stj_close(&journal);
+    double result = now_seconds() - start;
+    if (0 != error) {
+        fprintf(stderr, "stj_close failed, code == %d\n", error);
+        exit(1);
+    }
+    return result;
+}
+
+static void bench_journal(size_t n) {
+    students_array* source = make_random_collection(n);
+    if (NULL == source) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    printf("\nJournaled adds of %zu records, seconds\n", n);
+    printf("%20s %20s %20s\n", "fsync every record", "group commit (64)", 
+           "no fsync");
+    double single_time = time_journal_adds(source, 1, 1);
+    double group_time = time_journal_adds(source, JOURNAL_GROUP_SIZE, 1);
+    double no_fsync_time = time_journal_adds(source, JOURNAL_GROUP_SIZE, 0);
+    printf("%20.6f %20.6f %20.6f\n", single_time, group_time, no_fsync_time);
+    int error = 0;
+    students_journal* journal = stj_open(JOURNAL_BENCH_PATH, NULL, &error);
+    if ((NULL == journal) || (n != journal->collection->students_num)) {
+        fprintf(stderr, "Journal recovery failed, code == %d\n", error);
+        exit(1);
+    }
+    stj_close(&journal);
+    sts_destroy_all(&source);
+}
+
+#define GROUP_BY_FACULTIES_NUM 8
+
+static int faculty_asc(const void* arg1, const void* arg2) {
+    return strcmp(((const student*) arg1)->faculty, 
+                  ((const student*) arg2)->faculty);
+}
+
+/**
+ * The way it was done before: sort a copy by faculty, then scan runs
+*/
+static size_t sorted_faculty_counts(const students_array* collection, 
+                                    size_t* counts, int* max_nums) {
+    size_t n = collection->students_num;
+    student* sorted = (student*) malloc(sizeof(*sorted) * n);
+    if (NULL == sorted) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    memcpy(sorted, collection->students, sizeof(*sorted) * n);
+    qsort(sorted, n, sizeof(*sorted), faculty_asc);
+    size_t groups_num = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if ((0 == i) || (0 != strcmp(sorted[i - 1].faculty, sorted[i].faculty))) {
+            counts[groups_num] = 0;
+            max_nums[groups_num] = sorted[i].grade_book_num;
+            ++groups_num;
+        }
+        ++counts[groups_num - 1];
+        if (sorted[i].grade_book_num > max_nums[groups_num - 1]) {
+            max_nums[groups_num - 1] = sorted[i].grade_book_num;
+        }
+    }
+    free(sorted);
+    return groups_num;
+}
+
+static void bench_group_by(size_t n) {
+    static char* faculties[GROUP_BY_FACULTIES_NUM] = {
+        "FA", "FB", "FC", "FD", "FE", "FF", "FG", "FH"
+    };
+    students_array* collection = make_random_collection(n);
+    if (NULL == collection) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        collection->students[i].faculty = 
+            faculties[collection->students[i].grade_book_num % GROUP_BY_FACULTIES_NUM];
+    }
+    printf("\nCount and max grade book number per faculty, %zu records, "
+           "seconds\n", n);
+    printf("%14s %14s %14s\n", "qsort()+scan", "hash, serial", "hash, parallel");
+    size_t counts[GROUP_BY_FACULTIES_NUM];
+    int max_nums[GROUP_BY_FACULTIES_NUM];
+    double start = now_seconds();
+    size_t sorted_groups_num = sorted_faculty_counts(collection, counts, max_nums);
+    double sort_time = now_seconds() - start;
+    students_reducer aggregates[2] = {stg_count, stg_max_grade_book_num};
+    start = now_seconds();
+    students_groups* serial = sts_group_by(collection, stg_key_faculty, 
+                                           aggregates, 2, 1);
+    double serial_time = now_seconds() - start;
+    start = now_seconds();
+    students_groups* parallel = sts_group_by(collection, stg_key_faculty, 
+                                             aggregates, 2, 0);
+    double parallel_time = now_seconds() - start;
+    printf("%14.6f %14.6f %14.6f\n", sort_time, serial_time, parallel_time);
+    if ((NULL == serial) || (NULL == parallel) || 
+        (sorted_groups_num != serial->groups_num) || 
+        (serial->groups_num != parallel->groups_num)) {
+        fprintf(stderr, "Group-by failed\n");
+        exit(1);
+    }
+    stg_destroy(&serial);
+    stg_destroy(&parallel);
+    // Strings set above are not in arena, so they must not be freed
+    sts_destroy_all(&collection);
+}
+
+#define FILTER_QUERIES_NUM 100
+#define FILTER_GROUPS_NUM 50
+
+typedef struct filter_bench_query {
+    const char* faculty;
+    const char* group;
+    int from;
+    int to;
+} filter_bench_query;
+
+static bool filter_bench_matches(const student* entry, const void* ctx) {
+    const filter_bench_query* query = (const filter_bench_query*) ctx;
+    return (0 == strcmp(entry->faculty, query->faculty)) && 
+           (0 == strcmp(entry->group, query->group)) && 
+           (query->from <= entry->grade_book_num) && 
+           (entry->grade_book_num <= query->to);
+}
+
+static void bench_bitmap_filter(size_t n) {
+    static char* faculties[GROUP_BY_FACULTIES_NUM] = {
+        "FA", "FB", "FC", "FD", "FE", "FF", "FG", "FH"
+    };
+    static char groups[FILTER_GROUPS_NUM][4];
+    for (size_t i = 0; i < FILTER_GROUPS_NUM; ++i) {
+        sprintf(groups[i], "G%zu", i);
+    }
+    students_array* collection = make_random_collection(n);
+    if (NULL == collection) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        collection->students[i].faculty = faculties[rand() % GROUP_BY_FACULTIES_NUM];
+        collection->students[i].group = groups[rand() % FILTER_GROUPS_NUM];
+    }
+    printf("\n%d queries \"faculty = X AND group = Y AND grade_book_num "
+           "in [a, b]\", %zu records, seconds\n", FILTER_QUERIES_NUM, n);
+    printf("%14s %14s %14s\n", "predicate scan", "bitmap index", "index build");
+    double start = now_seconds();
+    students_bitmap_index* index = sbi_new(collection);
+    double build_time = now_seconds() - start;
+    if (NULL == index) {
+        fprintf(stderr, "sbi_new failed\n");
+        exit(1);
+    }
+    double scan_time = 0;
+    double index_time = 0;
+    srand(13);
+    for (size_t q = 0; q < FILTER_QUERIES_NUM; ++q) {
+        filter_bench_query query;
+        query.faculty = faculties[rand() % GROUP_BY_FACULTIES_NUM];
+        query.group = groups[rand() % FILTER_GROUPS_NUM];
+        query.from = rand();
+        query.to = query.from / 2 + RAND_MAX / 2;
+        students_filter* filter = stf_new();
+        if ((NULL == filter) || 
+            (0 != stf_faculty_eq(filter, query.faculty)) || 
+            (0 != stf_group_eq(filter, query.group)) || 
+            (0 != stf_and(filter)) || 
+            (0 != stf_grade_book_num_between(filter, query.from, query.to)) || 
+            (0 != stf_and(filter))) {
+            fprintf(stderr, "Filter building failed\n");
+            exit(1);
+        }
+        start = now_seconds();
+        size_t scan_matches = 0;
+        for (size_t i = 0; i < n; ++i) {
+            scan_matches += filter_bench_matches(collection->students + i, &query);
+        }
+        scan_time += now_seconds() - start;
+        start = now_seconds();
+        students_view* view = sbi_find_all(index, filter);
+        index_time += now_seconds() - start;
+        if ((NULL == view) || (view->positions_num != scan_matches)) {
+            fprintf(stderr, "Bitmap filter failed\n");
+            exit(1);
+        }
+        stv_destroy(&view);
+        stf_destroy(&filter);
+    }
+    printf("%14.6f %14.6f %14.6f\n", scan_time, index_time, build_time);
+    sbi_destroy(&index);
+    // Strings set above are not in arena, so they must not be freed
+    sts_destroy_all(&collection);
+}
+
+#define PREFIX_QUERIES_NUM 100
+
+static void bench_surname_prefix(size_t n) {
+    students_array* collection = make_random_collection(n);
+    if (NULL == collection) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    double start = now_seconds();
+    surname_sorted_index* index = ssi_new(collection);
+    double build_time = now_seconds() - start;
+    if (NULL == index) {
+        fprintf(stderr, "ssi_new failed\n");
+        exit(1);
+    }
+    printf("\nSurname prefix search (2 letters), %zu records, "
+           "%d queries, seconds\n", n, PREFIX_QUERIES_NUM);
+    printf("%14s %14s %14s\n", "index build", "full scan", "index");
+    double scan_time = 0;
+    double index_time = 0;
+    for (size_t i = 0; i < PREFIX_QUERIES_NUM; ++i) {
+        char prefix[3] = {'a' + i % 26, 'a' + (i * 7) % 26, '\0'};
+        start = now_seconds();
+        students_view* scanned = st_view_surname_prefix(collection, prefix);
+        scan_time += now_seconds() - start;
+        start = now_seconds();
+        students_view* found = ssi_find_prefix(index, prefix);
+        index_time += now_seconds() - start;
+        if (NULL == scanned || NULL == found || 
+            scanned->positions_num != found->positions_num) {
+            fprintf(stderr, "Prefix search failed\n");
+            exit(1);
+        }
+        stv_destroy(&scanned);
+        stv_destroy(&found);
+    }
+    printf("%14.6f %14.6f %14.6f\n", build_time, scan_time, index_time);
+    ssi_destroy(&index);
+    sts_destroy_all(&collection);
+}
+
+#define PAGE_SIZE 50
+
+/**
+ * First page and a page from the middle by surname: 
+ *  sorting the whole view vs selecting the page
+*/
+static void bench_page(size_t n) {
+    students_array* collection = make_random_collection(n);
+    students_view* sorted = (NULL == collection) ? NULL : stv_new(collection, n);
+    if (NULL == sorted) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    printf("\nPages of %d by surname, %zu records, seconds\n", PAGE_SIZE, n);
+    printf("%14s %14s %14s\n", "view sort", "first page", "middle page");
+    double start = now_seconds();
+    for (size_t i = 0; i < n; ++i) {
+        sorted->positions[i] = i;
+    }
+    stv_sort(sorted, surname_asc);
+    double sort_time = now_seconds() - start;
+    start = now_seconds();
+    students_view* first = st_view_top_k(collection, surname_asc, PAGE_SIZE);
+    double first_time = now_seconds() - start;
+    start = now_seconds();
+    students_view* middle = st_view_page(collection, surname_asc, n / 2, PAGE_SIZE);
+    double middle_time = now_seconds() - start;
+    if ((NULL == first) || (NULL == middle) || 
+        (0 != memcmp(first->positions, sorted->positions, 
+                     sizeof(size_t) * first->positions_num)) || 
+        (0 != memcmp(middle->positions, sorted->positions + n / 2, 
+                     sizeof(size_t) * middle->positions_num))) {
+        fprintf(stderr, "Page selection failed\n");
+        exit(1);
+    }
+    printf("%14.6f %14.6f %14.6f\n", sort_time, first_time, middle_time);
+    stv_destroy(&sorted);
+    stv_destroy(&first);
+    stv_destroy(&middle);
+    sts_destroy_all(&collection);
+}
+
+#define REFRESHES_NUM 1000
+
+static void* fold_sum(const student* entry, void* acc) {
+    if (NULL == acc) {
+        acc = calloc(1, sizeof(long long));
+        if (NULL == acc) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+    }
+    *((long long*) acc) += entry->grade_book_num;
+    return acc;
+}
+
+/**
+ * Dashboard refresh after every added entry: 
+ *  sts_fold() over the whole collection vs reading materialized sum
+*/
+static void bench_materialized_sum(size_t n) {
+    students_array* collection = make_random_collection(n);
+    size_t sum_id = 0;
+    if ((NULL == collection) || 
+        (0 != st_register_aggregate(collection, &sag_sum_grade_book_num, &sum_id))) {
+        fprintf(stderr, "Memory allocation failed for n == %zu\n", n);
+        exit(1);
+    }
+    printf("\nSum after every one of %d added entries, %zu records, seconds\n", 
+           REFRESHES_NUM, n);
+    printf("%14s %14s\n", "sts_fold", "materialized");
+    double fold_time = 0;
+    double materialized_time = 0;
+    student entry = {"Added", 0, "F", "G"};
+    for (size_t i = 0; i < REFRESHES_NUM; ++i) {
+        entry.grade_book_num = rand();
+        double start = now_seconds();
+        if (0 != st_add(collection, entry)) {
+            fprintf(stderr, "st_add failed\n");
+            exit(1);
+        }
+        const long long* sum = st_aggregate(collection, sum_id);
+        materialized_time += now_seconds() - start;
+        start = now_seconds();
+        long long* folded = (long long*) sts_fold(collection, fold_sum);
+        fold_time += now_seconds() - start;
+        if ((NULL == sum) || (*sum != *folded)) {
+            fprintf(stderr, "Materialized sum failed\n");
+            exit(1);
+        }
+        free(folded);
+    }
+    printf("%14.6f %14.6f\n", fold_time, materialized_time);
+    sts_destroy_all(&collection);
+}
+
+int main(int argc, char** argv) {
+    int max_power = DEFAULT_MAX_POWER;
+    if (argc > 1) {
+        max_power = atoi(argv[1]);
+    }
+
+    printf("Load time, seconds\n");
+    printf("%10s %14s %14s %14s\n", "records", "realloc(+1)", "st_add",
+           "st_add_bulk");
+    size_t n = 1000;
+    for (int power = 3; power <= max_power; ++power) {
+        bench_load(n);
+        n *= 10;
+    }
+
+    size_t sort_n = 1;
+    for (int power = 1; power < max_power; ++power) {
+        sort_n *= 10;
+    }
+    bench_parallel_sort(sort_n);
+    bench_radix_sort(sort_n);
+    bench_multi_key_sort(sort_n);
+    bench_input(sort_n);
+    bench_fuzzy_search(sort_n);
+    bench_ordered_inserts(sort_n / 10);
+    bench_shared_reads(sort_n / 10);
+    bench_journal(sort_n / 100);
+    bench_group_by(sort_n);
+    bench_bitmap_filter(sort_n);
+    bench_surname_prefix(sort_n);
+    bench_page(sort_n);
+    bench_materialized_sum(sort_n);
+    return 0;
+}
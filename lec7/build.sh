@@ -1,5 +1,16 @@
 #!/bin/bash
 
-mkdir ./build
+mkdir -p ./build
 
-gcc -Wall -pedantic -g -o ./build/test test.c student_w_ops.c students_array_w_ops.c
+SOURCES="student_w_ops.c students_array_w_ops.c string_arena_w_ops.c \
+string_dict_w_ops.c grade_book_index_w_ops.c thread_pool_w_ops.c \
+students_radix_sort.c students_columns_w_ops.c students_snapshot_w_ops.c \
+students_loader_w_ops.c students_view_w_ops.c \
+students_top_k_w_ops.c surname_trigram_index_w_ops.c small_string_w_ops.c \
+students_tree_w_ops.c students_shared_w_ops.c students_journal_w_ops.c \
+students_groups_w_ops.c students_filter_w_ops.c \
+students_bitmap_index_w_ops.c surname_sorted_index_w_ops.c \
+students_aggregates_w_ops.c"
+
+gcc -Wall -pedantic -g -pthread -o ./build/test test.c $SOURCES
+gcc -Wall -pedantic -O2 -g -pthread -o ./build/bench bench.c $SOURCES
@@ -0,0 +1,23 @@
+#ifndef GRADE_BOOK_INDEX_STRUCT_H
+#define GRADE_BOOK_INDEX_STRUCT_H
+
+#include <stddef.h>
+
+typedef struct grade_book_index_slot {
+    int key;
+    size_t pos; // Position of entry in students_array or special value
+} grade_book_index_slot;
+
+/**
+ * Open-addressing (linear probing) hash table
+ *  mapping grade_book_num to positions of entries.
+ * Equal keys are allowed, they just occupy separate slots
+*/
+typedef struct grade_book_index {
+    grade_book_index_slot* slots;
+    size_t capacity; // Power of 2
+    size_t live_num;
+    size_t used_num; // live_num + number of tombstones
+} grade_book_index;
+
+#endif
@@ -0,0 +1,183 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include "grade_book_index_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define GBI_EMPTY SIZE_MAX
+#define GBI_TOMBSTONE (SIZE_MAX - 1)
+#define GBI_MIN_CAPACITY 16
+
+static size_t gbi_hash(int key, size_t capacity) {
+    // Fibonacci hashing: multiplication spreads close keys over the table
+    uint64_t hash = (uint64_t) (uint32_t) key * UINT64_C(0x9E3779B97F4A7C15);
+    return (size_t) (hash >> 32) & (capacity - 1);
+}
+
+static grade_book_index_slot* gbi_new_slots(size_t capacity) {
+    grade_book_index_slot* slots = 
+        (grade_book_index_slot*) malloc(sizeof(*slots) * capacity);
+    if (NULL == slots) {
+        return NULL;
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+        slots[i].pos = GBI_EMPTY;
+    }
+    return slots;
+}
+
+/**
+ * Smallest power of 2 keeping load factor not greater than 1/2
+*/
+static size_t gbi_capacity_for(size_t entries_num) {
+    size_t capacity = GBI_MIN_CAPACITY;
+    while (capacity / 2 < entries_num) {
+        if (SIZE_MAX / 2 < capacity) {
+            return 0;
+        }
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+grade_book_index* gbi_new(size_t expected_num) {
+    size_t capacity = gbi_capacity_for(expected_num);
+    if (0 == capacity) {
+        return NULL;
+    }
+    grade_book_index* result = (grade_book_index*) malloc(sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    result->slots = gbi_new_slots(capacity);
+    if (NULL == result->slots) {
+        free(result);
+        return NULL;
+    }
+    result->capacity = capacity;
+    result->live_num = 0;
+    result->used_num = 0;
+    return result;
+}
+
+static void gbi_place(grade_book_index_slot* slots, size_t capacity, 
+                      int key, size_t pos) {
+    size_t slot = gbi_hash(key, capacity);
+    while (GBI_EMPTY != slots[slot].pos) {
+        slot = (slot + 1) & (capacity - 1);
+    }
+    slots[slot].key = key;
+    slots[slot].pos = pos;
+}
+
+/**
+ * Rehashes live slots into a table of 'new_capacity', dropping tombstones
+*/
+static int gbi_rehash(grade_book_index* index, size_t new_capacity) {
+    grade_book_index_slot* new_slots = gbi_new_slots(new_capacity);
+    if (NULL == new_slots) {
+        return 1;
+    }
+    for (size_t i = 0; i < index->capacity; ++i) {
+        size_t pos = index->slots[i].pos;
+        if ((GBI_EMPTY != pos) && (GBI_TOMBSTONE != pos)) {
+            gbi_place(new_slots, new_capacity, index->slots[i].key, pos);
+        }
+    }
+    free(index->slots);
+    index->slots = new_slots;
+    index->capacity = new_capacity;
+    index->used_num = index->live_num;
+    return 0;
+}
+
+int gbi_insert(grade_book_index* index, int key, size_t pos) {
+    assert(NULL != index);
+    assert(GBI_TOMBSTONE > pos);
+    if (index->capacity / 2 < index->used_num + 1) {
+        size_t new_capacity = gbi_capacity_for(index->live_num + 1);
+        if (0 == new_capacity) {
+            return 1;
+        }
+        if (0 != gbi_rehash(index, new_capacity)) {
+            return 1;
+        }
+    }
+    size_t slot = gbi_hash(key, index->capacity);
+    while ((GBI_EMPTY != index->slots[slot].pos) && 
+           (GBI_TOMBSTONE != index->slots[slot].pos)) {
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    if (GBI_EMPTY == index->slots[slot].pos) {
+        index->used_num++;
+    }
+    index->slots[slot].key = key;
+    index->slots[slot].pos = pos;
+    index->live_num++;
+    return 0;
+}
+
+void gbi_remove(grade_book_index* index, int key, size_t pos) {
+    assert(NULL != index);
+    size_t slot = gbi_hash(key, index->capacity);
+    while (GBI_EMPTY != index->slots[slot].pos) {
+        if ((pos == index->slots[slot].pos) && (key == index->slots[slot].key)) {
+            index->slots[slot].pos = GBI_TOMBSTONE;
+            index->live_num--;
+            return;
+        }
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+}
+
+void gbi_shift_down_after(grade_book_index* index, size_t pos) {
+    assert(NULL != index);
+    for (size_t i = 0; i < index->capacity; ++i) {
+        size_t slot_pos = index->slots[i].pos;
+        if ((GBI_TOMBSTONE > slot_pos) && (slot_pos > pos)) {
+            index->slots[i].pos--;
+        }
+    }
+}
+
+void gbi_clear(grade_book_index* index) {
+    assert(NULL != index);
+    for (size_t i = 0; i < index->capacity; ++i) {
+        index->slots[i].pos = GBI_EMPTY;
+    }
+    index->live_num = 0;
+    index->used_num = 0;
+}
+
+size_t gbi_lookup(const grade_book_index* index, int key, size_t* cursor) {
+    assert(NULL != index);
+    assert(NULL != cursor);
+    size_t start = gbi_hash(key, index->capacity);
+    while (*cursor < index->capacity) {
+        size_t slot = (start + *cursor) & (index->capacity - 1);
+        (*cursor)++;
+        size_t pos = index->slots[slot].pos;
+        if (GBI_EMPTY == pos) {
+            break;
+        }
+        if ((GBI_TOMBSTONE != pos) && (key == index->slots[slot].key)) {
+            return pos;
+        }
+    }
+    *cursor = index->capacity;
+    return GBI_NOT_FOUND;
+}
+
+void gbi_destroy(grade_book_index** index) {
+    assert(NULL != index);
+    if (NULL == *index) {
+        return;
+    }
+    free((*index)->slots);
+    free(*index);
+    *index = NULL;
+}
@@ -0,0 +1,53 @@
+#ifndef GRADE_BOOK_INDEX_W_OPS_H
+#define GRADE_BOOK_INDEX_W_OPS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "grade_book_index_struct.h"
+
+/**
+ * Returned by gbi_lookup() when there are no more matches
+*/
+#define GBI_NOT_FOUND SIZE_MAX
+
+/**
+ * Table is created big enough for 'expected_num' entries
+ * If memory allocation fails, returns NULL
+*/
+grade_book_index* gbi_new(size_t expected_num);
+
+/**
+ * Returns 0 or nonzero if memory allocation fails
+ *  (index is left unchanged then)
+*/
+int gbi_insert(grade_book_index* index, int key, size_t pos);
+
+/**
+ * Removes the slot with both 'key' and 'pos' if it exists
+*/
+void gbi_remove(grade_book_index* index, int key, size_t pos);
+
+/**
+ * Decrements all positions greater than 'pos',
+ *  used after an entry is removed from the middle of array
+*/
+void gbi_shift_down_after(grade_book_index* index, size_t pos);
+
+/**
+ * Removes everything, keeps allocated table
+*/
+void gbi_clear(grade_book_index* index);
+
+/**
+ * Iterates over positions stored for 'key' in no particular order.
+ * '*cursor' must be 0 before the first call, 
+ *  GBI_NOT_FOUND is returned when there are no more matches
+*/
+size_t gbi_lookup(const grade_book_index* index, int key, size_t* cursor);
+
+/**
+ * Sets *index to NULL after freeing
+*/
+void gbi_destroy(grade_book_index** index);
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef SMALL_STRING_STRUCT_H
+#define SMALL_STRING_STRUCT_H
+
+#include <stddef.h>
+
+#define SS_INLINE_CAPACITY 15
+#define SS_HEAP_TAG 0xFF
+
+/**
+ * 16 bytes string: up to SS_INLINE_CAPACITY chars are stored inline, 
+ *  longer values are spilled to the heap.
+ * Last byte is the tag: SS_INLINE_CAPACITY - length for inline strings
+ *  (so it doubles as '\0' of a full one) or SS_HEAP_TAG for spilled ones.
+ * Unused inline bytes are zero, so equal inline strings are equal bytewise
+*/
+typedef struct small_string {
+    union {
+        char inline_chars[SS_INLINE_CAPACITY + 1];
+        char* heap_chars;
+    };
+} small_string;
+
+_Static_assert(sizeof(small_string) == SS_INLINE_CAPACITY + 1, 
+               "small_string must fill exactly 16 bytes");
+
+#endif
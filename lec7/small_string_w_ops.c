@@ -0,0 +1,62 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "small_string_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+static void ss_set_inline(small_string* str, const char* value, 
+                          size_t value_len) {
+    assert(SS_INLINE_CAPACITY >= value_len);
+    memset(str->inline_chars, 0, sizeof(str->inline_chars));
+    memcpy(str->inline_chars, value, value_len);
+    str->inline_chars[SS_INLINE_CAPACITY] = 
+        (char) (SS_INLINE_CAPACITY - value_len);
+}
+
+static void ss_set_heap(small_string* str, char* value) {
+    memset(str->inline_chars, 0, sizeof(str->inline_chars));
+    str->heap_chars = value;
+    str->inline_chars[SS_INLINE_CAPACITY] = (char) SS_HEAP_TAG;
+}
+
+int ss_init(small_string* str, const char* value, size_t value_len) {
+    assert(NULL != str);
+    assert(NULL != value);
+    if (SS_INLINE_CAPACITY >= value_len) {
+        ss_set_inline(str, value, value_len);
+        return 0;
+    }
+    char* copy = (char*) malloc(value_len + 1);
+    if (NULL == copy) {
+        ss_set_inline(str, "", 0);
+        return 1;
+    }
+    memcpy(copy, value, value_len);
+    copy[value_len] = '\0';
+    ss_set_heap(str, copy);
+    return 0;
+}
+
+void ss_init_adopt(small_string* str, char* value) {
+    assert(NULL != str);
+    assert(NULL != value);
+    size_t value_len = strlen(value);
+    if (SS_INLINE_CAPACITY >= value_len) {
+        ss_set_inline(str, value, value_len);
+        free(value);
+        return;
+    }
+    ss_set_heap(str, value);
+}
+
+void ss_free(small_string* str) {
+    assert(NULL != str);
+    if (!ss_is_inline(str)) {
+        free(str->heap_chars);
+    }
+    ss_set_inline(str, "", 0);
+}
@@ -0,0 +1,56 @@
+#ifndef SMALL_STRING_W_OPS_H
+#define SMALL_STRING_W_OPS_H
+
+#include <stdbool.h>
+#include <string.h>
+#include "small_string_struct.h"
+
+/**
+ * Copies 'value', memory is allocated only if it is longer
+ *  than SS_INLINE_CAPACITY
+ * Returns 1 if memory allocation fails, 'str' is left empty then
+*/
+int ss_init(small_string* str, const char* value, size_t value_len);
+
+/**
+ * Takes ownership of malloc()'ed 'value': short one is copied inline
+ *  and freed, long one is kept as is. Never fails
+*/
+void ss_init_adopt(small_string* str, char* value);
+
+/**
+ * Frees spilled value, 'str' becomes empty
+*/
+void ss_free(small_string* str);
+
+static inline bool ss_is_inline(const small_string* str) {
+    return SS_HEAP_TAG != (unsigned char) str->inline_chars[SS_INLINE_CAPACITY];
+}
+
+/**
+ * Pointer is valid while 'str' is neither moved nor freed
+*/
+static inline const char* ss_cstr(const small_string* str) {
+    return ss_is_inline(str) ? str->inline_chars : str->heap_chars;
+}
+
+/**
+ * Inline values are compared without leaving the 16 bytes of 'str'
+*/
+static inline bool ss_equals_cstr(const small_string* str, 
+                                  const char* value, size_t value_len) {
+    if (ss_is_inline(str)) {
+        size_t len = SS_INLINE_CAPACITY - 
+            (unsigned char) str->inline_chars[SS_INLINE_CAPACITY];
+        return (len == value_len) && (0 == memcmp(str->inline_chars, value, len));
+    }
+    return (SS_INLINE_CAPACITY < value_len) && 
+           (0 == strcmp(str->heap_chars, value));
+}
+
+static inline int ss_compare(const small_string* str1, 
+                             const small_string* str2) {
+    return strcmp(ss_cstr(str1), ss_cstr(str2));
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef STRING_ARENA_STRUCT_H
+#define STRING_ARENA_STRUCT_H
+
+#include <stddef.h>
+
+typedef struct string_arena_chunk {
+    struct string_arena_chunk* next;
+    size_t used;
+    size_t size;
+    char data[];
+} string_arena_chunk;
+
+/**
+ * Bump allocator for strings: bytes are placed one after another
+ *  into big chunks and are released all together on sa_destroy()
+*/
+typedef struct string_arena {
+    string_arena_chunk* chunks; // Head is the chunk being filled now
+    size_t chunk_size;
+} string_arena;
+
+#endif
@@ -0,0 +1,104 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include "string_arena_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define SA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+string_arena* sa_new(size_t chunk_size) {
+    string_arena* result = (string_arena*) malloc(sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    result->chunks = NULL;
+    result->chunk_size = (0 == chunk_size) ? SA_DEFAULT_CHUNK_SIZE : chunk_size;
+    return result;
+}
+
+static string_arena_chunk* sa_new_chunk(size_t size) {
+    if (SIZE_MAX - sizeof(string_arena_chunk) < size) {
+        return NULL;
+    }
+    string_arena_chunk* chunk = 
+        (string_arena_chunk*) malloc(sizeof(*chunk) + size);
+    if (NULL == chunk) {
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->used = 0;
+    chunk->size = size;
+    return chunk;
+}
+
+char* sa_strndup(string_arena* arena, const char* str, size_t len) {
+    assert(NULL != arena);
+    assert(NULL != str);
+    if (SIZE_MAX == len) {
+        return NULL;
+    }
+    size_t needed = len + 1;
+    string_arena_chunk* chunk = arena->chunks;
+    if ((NULL == chunk) || (chunk->size - chunk->used < needed)) {
+        if (needed > arena->chunk_size) {
+            /**
+             * Big string gets a dedicated chunk, which is linked 
+             *  after the current one, so free space left in current chunk
+             *  is not wasted
+            */
+            string_arena_chunk* big_chunk = sa_new_chunk(needed);
+            if (NULL == big_chunk) {
+                return NULL;
+            }
+            big_chunk->used = needed;
+            if (NULL == chunk) {
+                arena->chunks = big_chunk;
+            }
+            else {
+                big_chunk->next = chunk->next;
+                chunk->next = big_chunk;
+            }
+            memcpy(big_chunk->data, str, len);
+            big_chunk->data[len] = '\0';
+            return big_chunk->data;
+        }
+        string_arena_chunk* new_chunk = sa_new_chunk(arena->chunk_size);
+        if (NULL == new_chunk) {
+            return NULL;
+        }
+        new_chunk->next = chunk;
+        arena->chunks = new_chunk;
+        chunk = new_chunk;
+    }
+    char* result = chunk->data + chunk->used;
+    memcpy(result, str, len);
+    result[len] = '\0';
+    chunk->used += needed;
+    return result;
+}
+
+char* sa_strdup(string_arena* arena, const char* str) {
+    assert(NULL != arena);
+    assert(NULL != str);
+    return sa_strndup(arena, str, strlen(str));
+}
+
+void sa_destroy(string_arena** arena) {
+    assert(NULL != arena);
+    if (NULL == *arena) {
+        return;
+    }
+    string_arena_chunk* chunk = (*arena)->chunks;
+    while (NULL != chunk) {
+        string_arena_chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(*arena);
+    *arena = NULL;
+}
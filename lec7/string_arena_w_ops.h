@@ -0,0 +1,26 @@
+#ifndef STRING_ARENA_W_OPS_H
+#define STRING_ARENA_W_OPS_H
+
+#include "string_arena_struct.h"
+
+/**
+ * If 'chunk_size' is 0, default chunk size is used
+ * If memory allocation fails, returns NULL
+*/
+string_arena* sa_new(size_t chunk_size);
+
+/**
+ * Copies 'len' bytes of 'str' into arena and appends '\0'
+ *  (strings longer than chunk size get their own chunk)
+ * Returns NULL if memory allocation fails
+*/
+char* sa_strndup(string_arena* arena, const char* str, size_t len);
+
+char* sa_strdup(string_arena* arena, const char* str);
+
+/**
+ * Frees all chunks at once, sets *arena to NULL
+*/
+void sa_destroy(string_arena** arena);
+
+#endif
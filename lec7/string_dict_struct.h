@@ -0,0 +1,22 @@
+#ifndef STRING_DICT_STRUCT_H
+#define STRING_DICT_STRUCT_H
+
+#include <stddef.h>
+
+/**
+ * Interned string together with its code.
+ * Codes are ranks of strings in strcmp() order, 
+ *  so comparing codes is the same as comparing strings
+*/
+typedef struct string_dict_entry {
+    size_t code;
+    char str[];
+} string_dict_entry;
+
+typedef struct string_dict {
+    string_dict_entry** entries; // Sorted by str, entries[i]->code == i
+    size_t size;
+    size_t capacity;
+} string_dict;
+
+#endif
@@ -0,0 +1,103 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#include "string_dict_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+string_dict* sd_new() {
+    string_dict* result = (string_dict*) malloc(sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    result->entries = NULL;
+    result->size = 0;
+    result->capacity = 0;
+    return result;
+}
+
+/**
+ * Returns position of 'str' in dict->entries or position where
+ *  it should be inserted, *found tells which one of them it is
+*/
+static size_t sd_lower_bound(const string_dict* dict, const char* str, 
+                             bool* found) {
+    size_t left = 0;
+    size_t right = dict->size;
+    while (left < right) {
+        size_t middle = left + (right - left) / 2;
+        int cmp_result = strcmp(dict->entries[middle]->str, str);
+        if (0 == cmp_result) {
+            *found = true;
+            return middle;
+        }
+        if (cmp_result < 0) {
+            left = middle + 1;
+        }
+        else {
+            right = middle;
+        }
+    }
+    *found = false;
+    return left;
+}
+
+const char* sd_find(const string_dict* dict, const char* str) {
+    assert(NULL != dict);
+    assert(NULL != str);
+    bool found = false;
+    size_t pos = sd_lower_bound(dict, str, &found);
+    return found ? dict->entries[pos]->str : NULL;
+}
+
+const char* sd_intern(string_dict* dict, const char* str) {
+    assert(NULL != dict);
+    assert(NULL != str);
+    bool found = false;
+    size_t pos = sd_lower_bound(dict, str, &found);
+    if (found) {
+        return dict->entries[pos]->str;
+    }
+    if (dict->size == dict->capacity) {
+        size_t new_capacity = (0 == dict->capacity) ? 16 : dict->capacity * 2;
+        string_dict_entry** new_entries = (string_dict_entry**) 
+            realloc(dict->entries, sizeof(*new_entries) * new_capacity);
+        if (NULL == new_entries) {
+            return NULL;
+        }
+        dict->entries = new_entries;
+        dict->capacity = new_capacity;
+    }
+    size_t len = strlen(str);
+    string_dict_entry* entry = 
+        (string_dict_entry*) malloc(sizeof(*entry) + len + 1);
+    if (NULL == entry) {
+        return NULL;
+    }
+    memcpy(entry->str, str, len + 1);
+    memmove(dict->entries + pos + 1, dict->entries + pos, 
+            sizeof(*(dict->entries)) * (dict->size - pos));
+    dict->entries[pos] = entry;
+    dict->size++;
+    for (size_t i = pos; i < dict->size; ++i) {
+        dict->entries[i]->code = i;
+    }
+    return entry->str;
+}
+
+void sd_destroy(string_dict** dict) {
+    assert(NULL != dict);
+    if (NULL == *dict) {
+        return;
+    }
+    for (size_t i = 0; i < (*dict)->size; ++i) {
+        free((*dict)->entries[i]);
+    }
+    free((*dict)->entries);
+    free(*dict);
+    *dict = NULL;
+}
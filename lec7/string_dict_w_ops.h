@@ -0,0 +1,43 @@
+#ifndef STRING_DICT_W_OPS_H
+#define STRING_DICT_W_OPS_H
+
+#include <stddef.h>
+#include "string_dict_struct.h"
+
+/**
+ * Dictionary for low-cardinality string columns:
+ *  every distinct value is stored once and gets a small integer code.
+ * Codes of all entries are renumbered when a new value is interned,
+ *  which is cheap while there are only a few dozen distinct values
+*/
+
+/**
+ * If memory allocation fails, returns NULL
+*/
+string_dict* sd_new();
+
+/**
+ * Returns dictionary's copy of 'str', adding it if needed,
+ *  or NULL if memory allocation fails
+*/
+const char* sd_intern(string_dict* dict, const char* str);
+
+/**
+ * Returns dictionary's copy of 'str' or NULL if there is no such value
+*/
+const char* sd_find(const string_dict* dict, const char* str);
+
+/**
+ * 'interned' must be a pointer returned by sd_intern()/sd_find()
+*/
+static inline size_t sd_code_of(const char* interned) {
+    return ((const string_dict_entry*) 
+            (interned - offsetof(string_dict_entry, str)))->code;
+}
+
+/**
+ * Frees all interned strings, sets *dict to NULL
+*/
+void sd_destroy(string_dict** dict);
+
+#endif
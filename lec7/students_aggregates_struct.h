@@ -0,0 +1,84 @@
+#ifndef STUDENTS_AGGREGATES_STRUCT_H
+#define STUDENTS_AGGREGATES_STRUCT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "students_struct.h"
+
+#define SAG_MAX_AGGREGATES 8
+
+/**
+ * Description of an aggregate collection keeps up to date on every change
+ *  (see st_register_aggregate()). Accumulator is 'acc_size' bytes: 
+ *  'init' makes an empty one, 'insert' and 'remove' account an entry
+ *  added to or removed from collection ('remove' only gets entries
+ *  'insert' got before), 'destroy' (may be NULL) frees what they allocated.
+ * 'init', 'insert' and 'remove' return nonzero if memory allocation fails
+*/
+typedef struct students_aggregate {
+    size_t acc_size;
+    int (*init)(void* acc);
+    int (*insert)(void* acc, const student* entry);
+    int (*remove)(void* acc, const student* entry);
+    void (*destroy)(void* acc);
+} students_aggregate;
+
+/**
+ * Open-addressing (linear probing) table of value multiplicities.
+ *  Values whose count drops to 0 keep their slots until the table is rebuilt
+*/
+typedef struct students_int_counts {
+    int* keys;
+    size_t* counts; // 0 for both free and emptied slots
+    bool* used;
+    size_t capacity; // Power of 2
+    size_t used_num;
+} students_int_counts;
+
+typedef struct students_int_heap {
+    int* items;
+    size_t size;
+    size_t capacity;
+} students_int_heap;
+
+/**
+ * Accumulator of sag_grade_book_num_extremes.
+ * Removed values stay in heaps until they reach the top: 
+ *  top is popped while its count in 'values' is 0
+*/
+typedef struct students_extremes {
+    size_t values_num; // 'min' and 'max' are valid only if nonzero
+    int min;
+    int max;
+    students_int_counts values;
+    students_int_heap min_heap;
+    students_int_heap max_heap;
+} students_extremes;
+
+/**
+ * Accumulator of sag_faculty_counts: open-addressing table
+ *  of key copies and numbers of entries having them.
+ *  Keys whose count drops to 0 stay in the table
+*/
+typedef struct students_key_counts {
+    char** keys; // NULL for free slots
+    size_t* counts;
+    size_t capacity; // Power of 2
+    size_t keys_num;
+} students_key_counts;
+
+/**
+ * Aggregates registered on a collection, in registration order
+*/
+typedef struct students_aggregates {
+    students_aggregate aggregates[SAG_MAX_AGGREGATES];
+    void* accs[SAG_MAX_AGGREGATES];
+    size_t aggregates_num;
+    /**
+     * Set when an update failed to allocate memory, 
+     *  accumulators are recomputed by the next st_aggregate()
+    */
+    bool stale;
+} students_aggregates;
+
+#endif
@@ -0,0 +1,517 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include "students_aggregates_w_ops.h"
+#include "students_array_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define SAG_INITIAL_CAPACITY 16
+#define SAG_FNV_OFFSET 14695981039346656037ULL
+#define SAG_FNV_PRIME 1099511628211ULL
+// Heaps are rebuilt when removed values make them that much bigger
+#define SAG_HEAP_SLACK 64
+
+/******************** Count and sum ********************/
+
+static int sag_count_init(void* acc) {
+    *((size_t*) acc) = 0;
+    return 0;
+}
+
+static int sag_count_insert(void* acc, const student* entry) {
+    (void) entry;
+    ++*((size_t*) acc);
+    return 0;
+}
+
+static int sag_count_remove(void* acc, const student* entry) {
+    (void) entry;
+    --*((size_t*) acc);
+    return 0;
+}
+
+static int sag_sum_init(void* acc) {
+    *((long long*) acc) = 0;
+    return 0;
+}
+
+static int sag_sum_insert(void* acc, const student* entry) {
+    *((long long*) acc) += entry->grade_book_num;
+    return 0;
+}
+
+static int sag_sum_remove(void* acc, const student* entry) {
+    *((long long*) acc) -= entry->grade_book_num;
+    return 0;
+}
+
+const students_aggregate sag_count = {
+    sizeof(size_t), sag_count_init, sag_count_insert, sag_count_remove, NULL
+};
+const students_aggregate sag_sum_grade_book_num = {
+    sizeof(long long), sag_sum_init, sag_sum_insert, sag_sum_remove, NULL
+};
+
+/******************** Value multiplicities ********************/
+
+static size_t sag_int_slot(int key, size_t capacity) {
+    return (size_t) (((uint64_t) (uint32_t) key * 0x9E3779B97F4A7C15ULL) >> 32) & 
+        (capacity - 1);
+}
+
+static void sag_counts_free(students_int_counts* counts) {
+    free(counts->keys);
+    free(counts->counts);
+    free(counts->used);
+    counts->keys = NULL;
+    counts->counts = NULL;
+    counts->used = NULL;
+    counts->capacity = 0;
+    counts->used_num = 0;
+}
+
+static int sag_counts_alloc(students_int_counts* counts, size_t capacity) {
+    counts->keys = (int*) malloc(sizeof(*(counts->keys)) * capacity);
+    counts->counts = (size_t*) calloc(capacity, sizeof(*(counts->counts)));
+    counts->used = (bool*) calloc(capacity, sizeof(*(counts->used)));
+    counts->capacity = capacity;
+    counts->used_num = 0;
+    if (NULL == counts->keys || NULL == counts->counts || NULL == counts->used) {
+        sag_counts_free(counts);
+        return 1;
+    }
+    return 0;
+}
+
+static size_t sag_counts_find(const students_int_counts* counts, int key) {
+    size_t slot = sag_int_slot(key, counts->capacity);
+    while (counts->used[slot] && (counts->keys[slot] != key)) {
+        slot = (slot + 1) & (counts->capacity - 1);
+    }
+    return slot;
+}
+
+/**
+ * Moves values still present into a table sized for them, 
+ *  returns nonzero if memory allocation fails (table is not changed then)
+*/
+static int sag_counts_rehash(students_int_counts* counts) {
+    size_t live_num = 0;
+    for (size_t i = 0; i < counts->capacity; ++i) {
+        live_num += (0 != counts->counts[i]);
+    }
+    size_t capacity = SAG_INITIAL_CAPACITY;
+    while (capacity < 2 * (live_num + 1)) {
+        capacity *= 2;
+    }
+    students_int_counts rehashed;
+    if (0 != sag_counts_alloc(&rehashed, capacity)) {
+        return 1;
+    }
+    for (size_t i = 0; i < counts->capacity; ++i) {
+        if (0 != counts->counts[i]) {
+            size_t slot = sag_counts_find(&rehashed, counts->keys[i]);
+            rehashed.used[slot] = true;
+            rehashed.keys[slot] = counts->keys[i];
+            rehashed.counts[slot] = counts->counts[i];
+            rehashed.used_num++;
+        }
+    }
+    sag_counts_free(counts);
+    *counts = rehashed;
+    return 0;
+}
+
+static int sag_counts_add(students_int_counts* counts, int key) {
+    size_t slot = sag_counts_find(counts, key);
+    if (!counts->used[slot]) {
+        if (4 * (counts->used_num + 1) > 3 * counts->capacity) {
+            if (0 != sag_counts_rehash(counts)) {
+                return 1;
+            }
+            slot = sag_counts_find(counts, key);
+        }
+        counts->used[slot] = true;
+        counts->keys[slot] = key;
+        counts->used_num++;
+    }
+    counts->counts[slot]++;
+    return 0;
+}
+
+static size_t sag_counts_get(const students_int_counts* counts, int key) {
+    size_t slot = sag_counts_find(counts, key);
+    return counts->used[slot] ? counts->counts[slot] : 0;
+}
+
+/******************** Min and max ********************/
+
+static bool sag_heap_before(int val1, int val2, bool max) {
+    return max ? (val1 > val2) : (val1 < val2);
+}
+
+static int sag_heap_push(students_int_heap* heap, int value, bool max) {
+    if (heap->size == heap->capacity) {
+        size_t new_capacity = 
+            (0 == heap->capacity) ? SAG_INITIAL_CAPACITY : heap->capacity * 2;
+        int* items = (int*) realloc(heap->items, sizeof(*items) * new_capacity);
+        if (NULL == items) {
+            return 1;
+        }
+        heap->items = items;
+        heap->capacity = new_capacity;
+    }
+    size_t i = heap->size++;
+    while (0 < i) {
+        size_t parent = (i - 1) / 2;
+        if (!sag_heap_before(value, heap->items[parent], max)) {
+            break;
+        }
+        heap->items[i] = heap->items[parent];
+        i = parent;
+    }
+    heap->items[i] = value;
+    return 0;
+}
+
+static void sag_heap_pop(students_int_heap* heap, bool max) {
+    int value = heap->items[--heap->size];
+    size_t i = 0;
+    while (true) {
+        size_t child = 2 * i + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if ((child + 1 < heap->size) && 
+            sag_heap_before(heap->items[child + 1], heap->items[child], max)) {
+            ++child;
+        }
+        if (!sag_heap_before(heap->items[child], value, max)) {
+            break;
+        }
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    if (0 != heap->size) {
+        heap->items[i] = value;
+    }
+}
+
+/**
+ * Pops removed values off the top, 
+ *  so heap's top is the current min (max)
+*/
+static void sag_heap_clean(students_int_heap* heap, 
+                           const students_int_counts* values, bool max) {
+    while ((0 != heap->size) && (0 == sag_counts_get(values, heap->items[0]))) {
+        sag_heap_pop(heap, max);
+    }
+}
+
+/**
+ * Refills heaps with one copy of every value present.
+ *  They already have room for that, so this never allocates
+*/
+static void sag_extremes_rebuild_heaps(students_extremes* extremes) {
+    extremes->min_heap.size = 0;
+    extremes->max_heap.size = 0;
+    for (size_t i = 0; i < extremes->values.capacity; ++i) {
+        if (0 != extremes->values.counts[i]) {
+            int key = extremes->values.keys[i];
+            int push_result = sag_heap_push(&(extremes->min_heap), key, false) | 
+                sag_heap_push(&(extremes->max_heap), key, true);
+            assert(0 == push_result);
+            (void) push_result;
+        }
+    }
+}
+
+static void sag_extremes_update(students_extremes* extremes) {
+    if (0 != extremes->values_num) {
+        extremes->min = extremes->min_heap.items[0];
+        extremes->max = extremes->max_heap.items[0];
+    }
+}
+
+static void sag_extremes_destroy(void* acc) {
+    students_extremes* extremes = (students_extremes*) acc;
+    sag_counts_free(&(extremes->values));
+    free(extremes->min_heap.items);
+    free(extremes->max_heap.items);
+    memset(extremes, 0, sizeof(*extremes));
+}
+
+static int sag_extremes_init(void* acc) {
+    students_extremes* extremes = (students_extremes*) acc;
+    memset(extremes, 0, sizeof(*extremes));
+    return sag_counts_alloc(&(extremes->values), SAG_INITIAL_CAPACITY);
+}
+
+static int sag_extremes_insert(void* acc, const student* entry) {
+    students_extremes* extremes = (students_extremes*) acc;
+    int value = entry->grade_book_num;
+    // Every value present has at least one copy in each heap
+    if ((0 != sag_counts_add(&(extremes->values), value)) || 
+        (0 != sag_heap_push(&(extremes->min_heap), value, false)) || 
+        (0 != sag_heap_push(&(extremes->max_heap), value, true))) {
+        return 1;
+    }
+    extremes->values_num++;
+    sag_extremes_update(extremes);
+    return 0;
+}
+
+static int sag_extremes_remove(void* acc, const student* entry) {
+    students_extremes* extremes = (students_extremes*) acc;
+    size_t slot = sag_counts_find(&(extremes->values), entry->grade_book_num);
+    assert(0 != extremes->values.counts[slot]);
+    extremes->values.counts[slot]--;
+    extremes->values_num--;
+    if (extremes->min_heap.size > 2 * extremes->values_num + SAG_HEAP_SLACK) {
+        sag_extremes_rebuild_heaps(extremes);
+    }
+    else {
+        sag_heap_clean(&(extremes->min_heap), &(extremes->values), false);
+        sag_heap_clean(&(extremes->max_heap), &(extremes->values), true);
+    }
+    sag_extremes_update(extremes);
+    return 0;
+}
+
+const students_aggregate sag_grade_book_num_extremes = {
+    sizeof(students_extremes), sag_extremes_init, sag_extremes_insert, 
+    sag_extremes_remove, sag_extremes_destroy
+};
+
+/******************** Counts by faculty ********************/
+
+static size_t sag_str_slot(const char* key, size_t capacity) {
+    uint64_t hash = SAG_FNV_OFFSET;
+    for (const unsigned char* c = (const unsigned char*) key; '\0' != *c; ++c) {
+        hash ^= *c;
+        hash *= SAG_FNV_PRIME;
+    }
+    return (size_t) hash & (capacity - 1);
+}
+
+static size_t sag_key_slot(const students_key_counts* counts, const char* key) {
+    size_t slot = sag_str_slot(key, counts->capacity);
+    while ((NULL != counts->keys[slot]) && (0 != strcmp(counts->keys[slot], key))) {
+        slot = (slot + 1) & (counts->capacity - 1);
+    }
+    return slot;
+}
+
+static void sag_key_counts_destroy(void* acc) {
+    students_key_counts* counts = (students_key_counts*) acc;
+    for (size_t i = 0; (NULL != counts->keys) && (i < counts->capacity); ++i) {
+        free(counts->keys[i]);
+    }
+    free(counts->keys);
+    free(counts->counts);
+    memset(counts, 0, sizeof(*counts));
+}
+
+static int sag_key_counts_alloc(students_key_counts* counts, size_t capacity) {
+    counts->keys = (char**) calloc(capacity, sizeof(*(counts->keys)));
+    counts->counts = (size_t*) calloc(capacity, sizeof(*(counts->counts)));
+    counts->capacity = capacity;
+    counts->keys_num = 0;
+    if (NULL == counts->keys || NULL == counts->counts) {
+        sag_key_counts_destroy(counts);
+        return 1;
+    }
+    return 0;
+}
+
+static int sag_key_counts_init(void* acc) {
+    students_key_counts* counts = (students_key_counts*) acc;
+    return sag_key_counts_alloc(counts, SAG_INITIAL_CAPACITY);
+}
+
+static int sag_key_counts_grow(students_key_counts* counts) {
+    students_key_counts grown;
+    if (0 != sag_key_counts_alloc(&grown, counts->capacity * 2)) {
+        return 1;
+    }
+    for (size_t i = 0; i < counts->capacity; ++i) {
+        if (NULL != counts->keys[i]) {
+            size_t slot = sag_key_slot(&grown, counts->keys[i]);
+            grown.keys[slot] = counts->keys[i];
+            grown.counts[slot] = counts->counts[i];
+        }
+    }
+    grown.keys_num = counts->keys_num;
+    free(counts->keys);
+    free(counts->counts);
+    *counts = grown;
+    return 0;
+}
+
+static int sag_faculty_insert(void* acc, const student* entry) {
+    students_key_counts* counts = (students_key_counts*) acc;
+    size_t slot = sag_key_slot(counts, entry->faculty);
+    if (NULL == counts->keys[slot]) {
+        if (4 * (counts->keys_num + 1) > 3 * counts->capacity) {
+            if (0 != sag_key_counts_grow(counts)) {
+                return 1;
+            }
+            slot = sag_key_slot(counts, entry->faculty);
+        }
+        counts->keys[slot] = strdup(entry->faculty);
+        if (NULL == counts->keys[slot]) {
+            return 1;
+        }
+        counts->keys_num++;
+    }
+    counts->counts[slot]++;
+    return 0;
+}
+
+static int sag_faculty_remove(void* acc, const student* entry) {
+    students_key_counts* counts = (students_key_counts*) acc;
+    size_t slot = sag_key_slot(counts, entry->faculty);
+    assert((NULL != counts->keys[slot]) && (0 != counts->counts[slot]));
+    counts->counts[slot]--;
+    return 0;
+}
+
+const students_aggregate sag_faculty_counts = {
+    sizeof(students_key_counts), sag_key_counts_init, sag_faculty_insert, 
+    sag_faculty_remove, sag_key_counts_destroy
+};
+
+size_t sag_key_count(const students_key_counts* counts, const char* key) {
+    assert(NULL != counts);
+    assert(NULL != key);
+    size_t slot = sag_key_slot(counts, key);
+    return (NULL == counts->keys[slot]) ? 0 : counts->counts[slot];
+}
+
+/******************** Registration ********************/
+
+static void sag_free_acc(const students_aggregate* aggregate, void* acc) {
+    if (NULL != aggregate->destroy) {
+        aggregate->destroy(acc);
+    }
+    free(acc);
+}
+
+/**
+ * Accounts all current entries in freshly initialized 'acc'
+*/
+static int sag_insert_all(const students_array* collection, 
+                          const students_aggregate* aggregate, void* acc) {
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != aggregate->insert(acc, collection->students + i)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int st_register_aggregate(students_array* collection, 
+                          const students_aggregate* aggregate, size_t* id) {
+    assert(NULL != collection);
+    assert(NULL != aggregate);
+    assert(NULL != id);
+    assert(0 != aggregate->acc_size);
+    if (NULL == collection->aggregates) {
+        collection->aggregates = 
+            (students_aggregates*) calloc(1, sizeof(*(collection->aggregates)));
+        if (NULL == collection->aggregates) {
+            return STS_MEM_ALLOC_ERROR;
+        }
+    }
+    students_aggregates* aggregates = collection->aggregates;
+    if (SAG_MAX_AGGREGATES == aggregates->aggregates_num) {
+        return ST_INVALID_DATA;
+    }
+    void* acc = calloc(1, aggregate->acc_size);
+    if (NULL == acc) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if ((0 != aggregate->init(acc)) || 
+        (0 != sag_insert_all(collection, aggregate, acc))) {
+        sag_free_acc(aggregate, acc);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    aggregates->aggregates[aggregates->aggregates_num] = *aggregate;
+    aggregates->accs[aggregates->aggregates_num] = acc;
+    *id = aggregates->aggregates_num++;
+    return 0;
+}
+
+/**
+ * Returns nonzero if memory allocation fails, aggregates stay stale then
+*/
+static int sag_recompute(const students_array* collection, 
+                         students_aggregates* aggregates) {
+    for (size_t a = 0; a < aggregates->aggregates_num; ++a) {
+        const students_aggregate* aggregate = aggregates->aggregates + a;
+        void* acc = aggregates->accs[a];
+        if (NULL != aggregate->destroy) {
+            aggregate->destroy(acc);
+        }
+        memset(acc, 0, aggregate->acc_size);
+        if ((0 != aggregate->init(acc)) || 
+            (0 != sag_insert_all(collection, aggregate, acc))) {
+            return 1;
+        }
+    }
+    aggregates->stale = false;
+    return 0;
+}
+
+const void* st_aggregate(students_array* collection, size_t id) {
+    assert(NULL != collection);
+    students_aggregates* aggregates = collection->aggregates;
+    assert((NULL != aggregates) && (id < aggregates->aggregates_num));
+    if (aggregates->stale && (0 != sag_recompute(collection, aggregates))) {
+        return NULL;
+    }
+    return aggregates->accs[id];
+}
+
+void st_drop_aggregates(students_array* collection) {
+    assert(NULL != collection);
+    sag_destroy(&(collection->aggregates));
+}
+
+void sag_insert(students_aggregates* aggregates, const student* entry) {
+    assert(NULL != aggregates);
+    assert(NULL != entry);
+    for (size_t a = 0; (a < aggregates->aggregates_num) && !aggregates->stale; ++a) {
+        if (0 != aggregates->aggregates[a].insert(aggregates->accs[a], entry)) {
+            aggregates->stale = true;
+        }
+    }
+}
+
+void sag_remove(students_aggregates* aggregates, const student* entry) {
+    assert(NULL != aggregates);
+    assert(NULL != entry);
+    for (size_t a = 0; (a < aggregates->aggregates_num) && !aggregates->stale; ++a) {
+        if (0 != aggregates->aggregates[a].remove(aggregates->accs[a], entry)) {
+            aggregates->stale = true;
+        }
+    }
+}
+
+void sag_destroy(students_aggregates** aggregates) {
+    assert(NULL != aggregates);
+    if (NULL == *aggregates) {
+        return;
+    }
+    for (size_t a = 0; a < (*aggregates)->aggregates_num; ++a) {
+        sag_free_acc((*aggregates)->aggregates + a, (*aggregates)->accs[a]);
+    }
+    free(*aggregates);
+    *aggregates = NULL;
+}
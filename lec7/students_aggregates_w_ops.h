@@ -0,0 +1,68 @@
+#ifndef STUDENTS_AGGREGATES_W_OPS_H
+#define STUDENTS_AGGREGATES_W_OPS_H
+
+#include <stddef.h>
+#include "students_aggregates_struct.h"
+#include "students_array_struct.h"
+
+/**
+ * Materialized aggregates: registered once, then updated by st_add*(), 
+ *  st_del_where(), st_del_all_where*() and st_replace_where*() for every
+ *  entry they add, delete or replace, so reading them is O(1)
+ *  instead of sts_fold() over the whole collection.
+ * Sorting doesn't change them. Code changing 'students' directly
+ *  has to drop and register aggregates again
+*/
+
+/**
+ * Ready aggregates, accumulator types are in comments
+*/
+extern const students_aggregate sag_count; // size_t
+extern const students_aggregate sag_sum_grade_book_num; // long long
+/**
+ * students_extremes, updates are O(log n) amortized
+*/
+extern const students_aggregate sag_grade_book_num_extremes;
+/**
+ * students_key_counts by faculty, see sag_key_count()
+*/
+extern const students_aggregate sag_faculty_counts;
+
+/**
+ * Number of entries having 'key', 0 if there are none
+*/
+size_t sag_key_count(const students_key_counts* counts, const char* key);
+
+/**
+ * Computes 'aggregate' over current entries and keeps it up to date
+ *  from now on, its index for st_aggregate() goes to *id.
+ * Returns 0, STS_MEM_ALLOC_ERROR or ST_INVALID_DATA
+ *  (SAG_MAX_AGGREGATES are already registered)
+*/
+int st_register_aggregate(students_array* collection, 
+                          const students_aggregate* aggregate, size_t* id);
+
+/**
+ * Accumulator of aggregate 'id'. If some update failed to allocate memory, 
+ *  all aggregates are recomputed first, NULL is returned if that fails too
+*/
+const void* st_aggregate(students_array* collection, size_t id);
+
+/**
+ * Unregisters all aggregates
+*/
+void st_drop_aggregates(students_array* collection);
+
+/**
+ * Used by collection functions on every added and removed entry, 
+ *  failures mark aggregates stale
+*/
+void sag_insert(students_aggregates* aggregates, const student* entry);
+void sag_remove(students_aggregates* aggregates, const student* entry);
+
+/**
+ * Sets *aggregates to NULL after freeing
+*/
+void sag_destroy(students_aggregates** aggregates);
+
+#endif
@@ -2,12 +2,79 @@
 #define STUDENTS_ARRAY_STRUCT_H
 
 #include <stddef.h>
+#include <stdbool.h>
 #include "students_struct.h"
+#include "string_arena_struct.h"
+#include "string_dict_struct.h"
+#include "grade_book_index_struct.h"
+#include "students_aggregates_struct.h"
+
+/**
+ * Who is responsible for freeing entries' strings
+*/
+enum students_strings_ownership {
+    // Every string is separately malloc()'ed and freed by collection
+    STS_OWNS_STRINGS = 0,
+    // Strings are copied into collection's arena and freed all at once
+    STS_ARENA_STRINGS,
+    // Strings belong to somebody else (e.g. to the array subarray was found in)
+    STS_BORROWS_STRINGS,
+};
+
+/**
+ * Key collection is currently known to be sorted by
+*/
+enum students_sort_key {
+    STS_NOT_SORTED = 0,
+    STS_SORTED_BY_SURNAME,
+    STS_SORTED_BY_GRADE_BOOK_NUM,
+    STS_SORTED_BY_FACULTY,
+    STS_SORTED_BY_GROUP,
+};
+
+/**
+ * One key of a multi-key sort, see sts_sort_multi_key()
+*/
+typedef struct students_sort_spec {
+    enum students_sort_key key;
+    bool desc;
+} students_sort_spec;
 
 typedef struct students_array {
     student* students;
     size_t students_num;
     size_t capacity;
+    enum students_strings_ownership ownership;
+    string_arena* arena; // NULL unless ownership == STS_ARENA_STRINGS
+    /**
+     * If not NULL, 'faculty' and 'group' of every entry point into
+     *  these dictionaries (see st_enable_dictionary())
+    */
+    string_dict* faculty_dict;
+    string_dict* group_dict;
+    // Optional hash index on grade_book_num, see st_build_grade_book_index()
+    grade_book_index* gb_index;
+    // Optional materialized aggregates, see st_register_aggregate()
+    students_aggregates* aggregates;
+    /**
+     * Set by predefined sts_sort_* functions, reset by mutations
+     *  that can break the order. Lets searches by that key use binary search
+    */
+    enum students_sort_key sort_key;
+    bool sort_desc;
+    /**
+     * Incremented whenever existing entries are changed, deleted 
+     *  or moved (appending doesn't count), so lazily built structures 
+     *  know when positions they remember became stale.
+     * Code changing 'students' directly should increment it too
+    */
+    size_t generation;
+    /**
+     * Read-only snapshot mapping strings point into
+     *  (see sts_snapshot_load()), unmapped by sts_destroy_all()
+    */
+    void* snapshot_map;
+    size_t snapshot_map_size;
 } students_array;
 
 #endif
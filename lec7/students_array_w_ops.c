@@ -3,9 +3,20 @@
 #include <string.h>
 #include <assert.h>
 #include <limits.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/mman.h>
 
 #include "students_array_w_ops.h"
 #include "student_w_ops.h"
+#include "string_arena_w_ops.h"
+#include "string_dict_w_ops.h"
+#include "grade_book_index_w_ops.h"
+#include "students_aggregates_w_ops.h"
+#include "thread_pool_w_ops.h"
+#include "students_radix_sort.h"
+#include "students_view_w_ops.h"
+#include "students_sort_kernel.h"
 
 /**
  * All general comments are in header file
@@ -30,40 +41,456 @@ students_array* st_new_array(size_t initial_capacity) {
     }
     result->capacity = initial_capacity;
     result->students_num = 0;
+    result->ownership = STS_OWNS_STRINGS;
+    result->arena = NULL;
+    result->faculty_dict = NULL;
+    result->group_dict = NULL;
+    result->gb_index = NULL;
+    result->aggregates = NULL;
+    result->sort_key = STS_NOT_SORTED;
+    result->sort_desc = false;
+    result->generation = 0;
+    result->snapshot_map = NULL;
+    result->snapshot_map_size = 0;
     return result;
 }
 
-int st_add(students_array* collection, student entry) {
+students_array* st_new_array_arena(size_t initial_capacity) {
+    students_array* result = st_new_array(initial_capacity);
+    if (NULL == result) {
+        return NULL;
+    }
+    result->arena = sa_new(0);
+    if (NULL == result->arena) {
+        free(result->students);
+        free(result);
+        return NULL;
+    }
+    result->ownership = STS_ARENA_STRINGS;
+    return result;
+}
+
+students_array* st_new_array_borrowing(size_t initial_capacity) {
+    students_array* result = st_new_array(initial_capacity);
+    if (NULL == result) {
+        return NULL;
+    }
+    result->ownership = STS_BORROWS_STRINGS;
+    return result;
+}
+
+/**
+ * Makes entry's strings belong to collection according to its mode:
+ *  in arena mode they are replaced with arena copies,
+ *  faculty and group are replaced with interned ones if dictionaries are on
+ *  (originals are freed then if collection owns strings),
+ *  otherwise pointers are kept as is.
+ * On failure entry is left untouched
+*/
+static int st_adopt_strings(students_array* collection, student* entry) {
     assert(NULL != collection);
-    if (NULL == collection->students) {
-        // Collection is empty
-        student* students_buf = 
-            (student*) malloc(sizeof(*students_buf));
-        if (NULL == students_buf) {
+    assert(NULL != entry);
+    char* surname = entry->surname;
+    char* faculty = entry->faculty;
+    char* group = entry->group;
+    if (NULL != collection->faculty_dict) {
+        faculty = (char*) sd_intern(collection->faculty_dict, entry->faculty);
+        group = (char*) sd_intern(collection->group_dict, entry->group);
+        if (NULL == faculty || NULL == group) {
+            // Values already interned just stay in dictionaries
             return STS_MEM_ALLOC_ERROR;
         }
-        collection->students = students_buf;
-        collection->capacity = 1;
-        collection->students_num = 0;
     }
-    if (collection->students_num < collection->capacity) {
-        (collection->students)[collection->students_num] = entry;
+    if (STS_ARENA_STRINGS == collection->ownership) {
+        surname = sa_strdup(collection->arena, entry->surname);
+        if (NULL == collection->faculty_dict) {
+            faculty = sa_strdup(collection->arena, entry->faculty);
+            group = sa_strdup(collection->arena, entry->group);
+        }
+        if (NULL == surname || NULL == faculty || NULL == group) {
+            // Bytes already copied stay in arena until it is destroyed
+            return STS_MEM_ALLOC_ERROR;
+        }
+    }
+    if ((NULL != collection->faculty_dict) && 
+        (STS_OWNS_STRINGS == collection->ownership)) {
+        free(entry->faculty);
+        free(entry->group);
+    }
+    entry->surname = surname;
+    entry->faculty = faculty;
+    entry->group = group;
+    return 0;
+}
+
+/**
+ * Replaces entry's strings with collection's own copies
+ *  (interned, copied into arena or strdup()'ed), 
+ *  caller's strings are left untouched
+*/
+static int st_copy_strings(students_array* collection, student* entry) {
+    assert(NULL != collection);
+    assert(NULL != entry);
+    assert(STS_BORROWS_STRINGS != collection->ownership);
+    char* surname = NULL;
+    char* faculty = NULL;
+    char* group = NULL;
+    bool owns = (STS_OWNS_STRINGS == collection->ownership);
+    if (NULL != collection->faculty_dict) {
+        faculty = (char*) sd_intern(collection->faculty_dict, entry->faculty);
+        group = (char*) sd_intern(collection->group_dict, entry->group);
     }
     else {
-        student* new_students_buf = 
-            (student*) realloc(collection->students, 
-                sizeof(*(collection->students))*(collection->capacity + 1));
-        if (NULL == new_students_buf) {
+        faculty = owns ? strdup(entry->faculty) : 
+            sa_strdup(collection->arena, entry->faculty);
+        group = owns ? strdup(entry->group) : 
+            sa_strdup(collection->arena, entry->group);
+    }
+    surname = owns ? strdup(entry->surname) : 
+        sa_strdup(collection->arena, entry->surname);
+    if (NULL == surname || NULL == faculty || NULL == group) {
+        // Interned values and arena bytes just stay where they are
+        if (owns) {
+            free(surname);
+            if (NULL == collection->faculty_dict) {
+                free(faculty);
+                free(group);
+            }
+        }
+        return STS_MEM_ALLOC_ERROR;
+    }
+    entry->surname = surname;
+    entry->faculty = faculty;
+    entry->group = group;
+    return 0;
+}
+
+/**
+ * Frees entry's strings if collection is the one responsible for it
+*/
+static void st_release_strings(students_array* collection, student* entry) {
+    assert(NULL != collection);
+    assert(NULL != entry);
+    if (STS_OWNS_STRINGS != collection->ownership) {
+        return;
+    }
+    free(entry->surname);
+    if (NULL == collection->faculty_dict) {
+        free(entry->faculty);
+        free(entry->group);
+    }
+}
+
+int st_enable_dictionary(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL != collection->faculty_dict) {
+        return 0;
+    }
+    string_dict* faculty_dict = sd_new();
+    string_dict* group_dict = sd_new();
+    if (NULL == faculty_dict || NULL == group_dict) {
+        sd_destroy(&faculty_dict);
+        sd_destroy(&group_dict);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    // Interning everything first, so nothing is changed on failure
+    for (size_t i = 0; i < collection->students_num; ++i) {
+        student* entry = collection->students + i;
+        if ((NULL == sd_intern(faculty_dict, entry->faculty)) || 
+            (NULL == sd_intern(group_dict, entry->group))) {
+            sd_destroy(&faculty_dict);
+            sd_destroy(&group_dict);
             return STS_MEM_ALLOC_ERROR;
         }
-        collection->students = new_students_buf;
-        (collection->students)[collection->students_num] = entry;
-        collection->capacity++;
     }
+    for (size_t i = 0; i < collection->students_num; ++i) {
+        student* entry = collection->students + i;
+        char* faculty = (char*) sd_find(faculty_dict, entry->faculty);
+        char* group = (char*) sd_find(group_dict, entry->group);
+        if (STS_OWNS_STRINGS == collection->ownership) {
+            free(entry->faculty);
+            free(entry->group);
+        }
+        entry->faculty = faculty;
+        entry->group = group;
+    }
+    collection->faculty_dict = faculty_dict;
+    collection->group_dict = group_dict;
+    return 0;
+}
+
+/**
+ * Growth factor for st_add(): capacity is doubled when buffer is full,
+ *  so N insertions cost O(N) copying in total instead of O(N^2)
+*/
+#define STS_GROWTH_FACTOR 2
+#define STS_MIN_CAPACITY 4
+
+static int st_realloc_buf(students_array* collection, size_t new_capacity) {
+    assert(NULL != collection);
+    assert(new_capacity >= collection->students_num);
+    if (0 == new_capacity) {
+        free(collection->students);
+        collection->students = NULL;
+        collection->capacity = 0;
+        return 0;
+    }
+    if (SIZE_MAX / sizeof(*(collection->students)) < new_capacity) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    student* new_students_buf = 
+        (student*) realloc(collection->students, 
+                           sizeof(*(collection->students)) * new_capacity);
+    if (NULL == new_students_buf) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    collection->students = new_students_buf;
+    collection->capacity = new_capacity;
+    return 0;
+}
+
+/**
+ * Makes sure there is space for at least 'min_capacity' entries,
+ *  growing geometrically (never less than STS_GROWTH_FACTOR times)
+*/
+static int st_grow_to(students_array* collection, size_t min_capacity) {
+    assert(NULL != collection);
+    if ((NULL != collection->students) && 
+        (min_capacity <= collection->capacity)) {
+        return 0;
+    }
+    size_t new_capacity = STS_MIN_CAPACITY;
+    if (NULL != collection->students) {
+        new_capacity = (SIZE_MAX / STS_GROWTH_FACTOR < collection->capacity) ? 
+            SIZE_MAX : collection->capacity * STS_GROWTH_FACTOR;
+    }
+    if (new_capacity < min_capacity) {
+        new_capacity = min_capacity;
+    }
+    return st_realloc_buf(collection, new_capacity);
+}
+
+/**
+ * Compares entries by 'key' in ascending order,
+ *  gives the same result as the corresponding sts_sort_*_asc comparator
+*/
+static int st_compare_by_key(enum students_sort_key key, 
+                             const student* s1, const student* s2) {
+    assert(NULL != s1);
+    assert(NULL != s2);
+    switch (key) {
+        case STS_SORTED_BY_SURNAME:
+            return strcmp(s1->surname, s2->surname);
+        case STS_SORTED_BY_GRADE_BOOK_NUM:
+            return (s1->grade_book_num > s2->grade_book_num) - 
+                   (s1->grade_book_num < s2->grade_book_num);
+        case STS_SORTED_BY_FACULTY:
+            return strcmp(s1->faculty, s2->faculty);
+        case STS_SORTED_BY_GROUP:
+            return strcmp(s1->group, s2->group);
+        default:
+            assert(false);
+            return 0;
+    }
+}
+
+/**
+ * Resets sort state unless entries at positions [from, students_num),
+ *  which have just been appended, keep the order
+*/
+static void st_check_order_appended(students_array* collection, size_t from) {
+    assert(NULL != collection);
+    if (STS_NOT_SORTED == collection->sort_key) {
+        return;
+    }
+    for (size_t i = (0 == from) ? 1 : from; i < collection->students_num; ++i) {
+        int cmp_result = st_compare_by_key(collection->sort_key, 
+                                           collection->students + i - 1, 
+                                           collection->students + i);
+        if (collection->sort_desc ? (cmp_result < 0) : (cmp_result > 0)) {
+            collection->sort_key = STS_NOT_SORTED;
+            return;
+        }
+    }
+}
+
+/**
+ * Accounts entries at positions [from, students_num) in aggregates,
+ *  called only for entries just appended
+*/
+static void st_aggregate_appended(students_array* collection, size_t from) {
+    assert(NULL != collection);
+    if (NULL == collection->aggregates) {
+        return;
+    }
+    for (size_t i = from; i < collection->students_num; ++i) {
+        sag_insert(collection->aggregates, collection->students + i);
+    }
+}
+
+/**
+ * Adds entries at positions [from, students_num) to grade book index.
+ * Index is dropped if it cannot be updated, 
+ *  lookups fall back to linear scan then
+*/
+static void st_index_appended(students_array* collection, size_t from) {
+    assert(NULL != collection);
+    if (NULL == collection->gb_index) {
+        return;
+    }
+    for (size_t i = from; i < collection->students_num; ++i) {
+        if (0 != gbi_insert(collection->gb_index, 
+                            collection->students[i].grade_book_num, i)) {
+            gbi_destroy(&(collection->gb_index));
+            return;
+        }
+    }
+}
+
+/**
+ * Refills grade book index after entries were reordered.
+ * Table is already big enough, so this never allocates
+*/
+static void st_index_rebuild(const students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->gb_index) {
+        return;
+    }
+    gbi_clear(collection->gb_index);
+    for (size_t i = 0; i < collection->students_num; ++i) {
+        int insertion_result = gbi_insert(collection->gb_index, 
+                                collection->students[i].grade_book_num, i);
+        assert(0 == insertion_result);
+        (void) insertion_result;
+    }
+}
+
+int st_build_grade_book_index(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL != collection->gb_index) {
+        return 0;
+    }
+    collection->gb_index = gbi_new(collection->students_num);
+    if (NULL == collection->gb_index) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    st_index_appended(collection, 0);
+    return (NULL == collection->gb_index) ? STS_MEM_ALLOC_ERROR : 0;
+}
+
+void st_drop_grade_book_index(students_array* collection) {
+    assert(NULL != collection);
+    gbi_destroy(&(collection->gb_index));
+}
+
+int st_add(students_array* collection, student entry) {
+    assert(NULL != collection);
+    if (collection->students_num == SIZE_MAX) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (0 != st_grow_to(collection, collection->students_num + 1)) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (0 != st_adopt_strings(collection, &entry)) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    (collection->students)[collection->students_num] = entry;
     collection->students_num++;
+    st_index_appended(collection, collection->students_num - 1);
+    st_aggregate_appended(collection, collection->students_num - 1);
+    st_check_order_appended(collection, collection->students_num - 1);
     return 0;
 }
 
+int st_add_bulk(students_array* collection, const student* entries, size_t n) {
+    assert(NULL != collection);
+    assert((NULL != entries) || (0 == n));
+    if (0 == n) {
+        return 0;
+    }
+    if (SIZE_MAX - collection->students_num < n) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (0 != st_grow_to(collection, collection->students_num + n)) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    /**
+     * In owning mode adoption frees originals of interned strings, 
+     *  so everything is interned first: then adoption can only fail 
+     *  in arena mode, where caller's strings are never freed
+    */
+    if (NULL != collection->faculty_dict) {
+        for (size_t i = 0; i < n; ++i) {
+            if ((NULL == sd_intern(collection->faculty_dict, entries[i].faculty)) || 
+                (NULL == sd_intern(collection->group_dict, entries[i].group))) {
+                return STS_MEM_ALLOC_ERROR;
+            }
+        }
+    }
+    student* dest = collection->students + collection->students_num;
+    memcpy(dest, entries, sizeof(*entries) * n);
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != st_adopt_strings(collection, dest + i)) {
+            return STS_MEM_ALLOC_ERROR;
+        }
+    }
+    collection->students_num += n;
+    st_index_appended(collection, collection->students_num - n);
+    st_aggregate_appended(collection, collection->students_num - n);
+    st_check_order_appended(collection, collection->students_num - n);
+    return 0;
+}
+
+int st_add_bulk_copy(students_array* collection, const student* entries, 
+                     size_t n) {
+    assert(NULL != collection);
+    assert((NULL != entries) || (0 == n));
+    if (0 == n) {
+        return 0;
+    }
+    if (SIZE_MAX - collection->students_num < n) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (0 != st_grow_to(collection, collection->students_num + n)) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    student* dest = collection->students + collection->students_num;
+    memcpy(dest, entries, sizeof(*entries) * n);
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != st_copy_strings(collection, dest + i)) {
+            for (size_t j = 0; j < i; ++j) {
+                st_release_strings(collection, dest + j);
+            }
+            return STS_MEM_ALLOC_ERROR;
+        }
+    }
+    collection->students_num += n;
+    st_index_appended(collection, collection->students_num - n);
+    st_aggregate_appended(collection, collection->students_num - n);
+    st_check_order_appended(collection, collection->students_num - n);
+    return 0;
+}
+
+int st_reserve(students_array* collection, size_t capacity) {
+    assert(NULL != collection);
+    if ((NULL != collection->students) && (capacity <= collection->capacity)) {
+        return 0;
+    }
+    if (0 == capacity) {
+        return 0;
+    }
+    return st_realloc_buf(collection, capacity);
+}
+
+int st_shrink_to_fit(students_array* collection) {
+    assert(NULL != collection);
+    if ((NULL == collection->students) || 
+        (collection->students_num == collection->capacity)) {
+        return 0;
+    }
+    return st_realloc_buf(collection, collection->students_num);
+}
+
 void sts_destroy_all(students_array** collection) {
     assert(NULL != collection);
     if (NULL == *collection) {
@@ -72,13 +499,21 @@ void sts_destroy_all(students_array** collection) {
     if (NULL != ((*collection)->students)) {
         student* students_arr = (*collection)->students;
         size_t students_num = (*collection)->students_num;
-        for (size_t i = 0; i < students_num; ++i) {
-            free(students_arr[i].surname);
-            free(students_arr[i].faculty);
-            free(students_arr[i].group);
+        if (STS_OWNS_STRINGS == (*collection)->ownership) {
+            for (size_t i = 0; i < students_num; ++i) {
+                st_release_strings(*collection, students_arr + i);
+            }
         }
         free((*collection)->students);
     }
+    sa_destroy(&((*collection)->arena));
+    sd_destroy(&((*collection)->faculty_dict));
+    sd_destroy(&((*collection)->group_dict));
+    gbi_destroy(&((*collection)->gb_index));
+    sag_destroy(&((*collection)->aggregates));
+    if (NULL != (*collection)->snapshot_map) {
+        munmap((*collection)->snapshot_map, (*collection)->snapshot_map_size);
+    }
     free(*collection);
     *collection = NULL;
 }
@@ -92,36 +527,139 @@ void st_del_where(students_array* collection, bool (*predicate)(const student*))
     student* students_arr = collection->students;
     for (size_t i = 0; i < collection->students_num; ++i) {
         if (predicate(students_arr + i)) {
-            free(students_arr[i].surname);
-            free(students_arr[i].faculty);
-            free(students_arr[i].group);
+            if (NULL != collection->gb_index) {
+                gbi_remove(collection->gb_index, 
+                           students_arr[i].grade_book_num, i);
+                gbi_shift_down_after(collection->gb_index, i);
+            }
+            if (NULL != collection->aggregates) {
+                sag_remove(collection->aggregates, students_arr + i);
+            }
+            st_release_strings(collection, students_arr + i);
             if (collection->students_num - 1 != i) {
                 memmove(students_arr + i, students_arr + i + 1, 
                         sizeof(*(collection->students)) * (collection->students_num - 1 - i));
             }
             collection->students_num--;
+            collection->generation++;
             return;
         }
     }
 }
 
-void st_replace_where(students_array* collection, 
-                     bool (*predicate)(const student*),
-                     student new_entry) {
+size_t st_del_all_where_ctx(students_array* collection, 
+                            bool (*predicate)(const student*, const void*), 
+                            const void* ctx) {
     assert(NULL != collection);
     assert(NULL != predicate);
     if ((NULL == collection->students) || (0 == collection->students_num)) {
-        return;
+        return 0;
     }
     student* students_arr = collection->students;
+    size_t kept_num = 0;
     for (size_t i = 0; i < collection->students_num; ++i) {
-        if (predicate(students_arr + i)) {
-            free(students_arr[i].surname);
-            free(students_arr[i].faculty);
-            free(students_arr[i].group);
-            students_arr[i] = new_entry;
+        if (predicate(students_arr + i, ctx)) {
+            if (NULL != collection->aggregates) {
+                sag_remove(collection->aggregates, students_arr + i);
+            }
+            st_release_strings(collection, students_arr + i);
+            continue;
+        }
+        if (kept_num != i) {
+            students_arr[kept_num] = students_arr[i];
         }
+        kept_num++;
     }
+    size_t removed_num = collection->students_num - kept_num;
+    collection->students_num = kept_num;
+    if (0 != removed_num) {
+        // Compaction is stable, so sort order is kept, positions are not
+        st_index_rebuild(collection);
+        collection->generation++;
+    }
+    return removed_num;
+}
+
+/**
+ * Adapter letting st_del_all_where() and st_replace_where() reuse
+ *  their *_ctx versions: ctx is the address of the context-free predicate
+*/
+typedef struct st_plain_predicate {
+    bool (*predicate)(const student*);
+} st_plain_predicate;
+
+static bool st_call_plain_predicate(const student* entry, const void* ctx) {
+    return ((const st_plain_predicate*) ctx)->predicate(entry);
+}
+
+size_t st_del_all_where(students_array* collection, 
+                        bool (*predicate)(const student*)) {
+    assert(NULL != collection);
+    assert(NULL != predicate);
+    st_plain_predicate plain = {predicate};
+    return st_del_all_where_ctx(collection, st_call_plain_predicate, &plain);
+}
+
+int st_replace_where_ctx(students_array* collection, 
+                         bool (*predicate)(const student*, const void*), 
+                         const void* ctx, student new_entry) {
+    assert(NULL != collection);
+    assert(NULL != predicate);
+    student* students_arr = collection->students;
+    size_t n = (NULL == students_arr) ? 0 : collection->students_num;
+    size_t replaced_num = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (!predicate(students_arr + i, ctx)) {
+            continue;
+        }
+        student replacement = new_entry;
+        if (0 == replaced_num) {
+            // In arena mode strings are copied once for all matches
+            if (0 != st_adopt_strings(collection, &new_entry)) {
+                return STS_MEM_ALLOC_ERROR;
+            }
+            replacement = new_entry;
+        }
+        else if (STS_OWNS_STRINGS == collection->ownership) {
+            // Every entry of owning collection frees its own strings
+            if (0 != st_copy_strings(collection, &replacement)) {
+                return STS_MEM_ALLOC_ERROR;
+            }
+        }
+        if (NULL != collection->aggregates) {
+            sag_remove(collection->aggregates, students_arr + i);
+            sag_insert(collection->aggregates, &replacement);
+        }
+        st_release_strings(collection, students_arr + i);
+        if (NULL != collection->gb_index) {
+            gbi_remove(collection->gb_index, 
+                       students_arr[i].grade_book_num, i);
+            if (0 != gbi_insert(collection->gb_index, 
+                                replacement.grade_book_num, i)) {
+                gbi_destroy(&(collection->gb_index));
+            }
+        }
+        students_arr[i] = replacement;
+        collection->sort_key = STS_NOT_SORTED;
+        collection->generation++;
+        replaced_num++;
+    }
+    if ((0 == replaced_num) && (STS_OWNS_STRINGS == collection->ownership)) {
+        // Strings were handed over just like to st_add()
+        free(new_entry.surname);
+        free(new_entry.faculty);
+        free(new_entry.group);
+    }
+    return 0;
+}
+
+int st_replace_where(students_array* collection, 
+                     bool (*predicate)(const student*),
+                     student new_entry) {
+    assert(NULL != predicate);
+    st_plain_predicate plain = {predicate};
+    return st_replace_where_ctx(collection, st_call_plain_predicate, &plain, 
+                                new_entry);
 }
 
 static int st_interactive_get(FILE* istream, FILE* ostream, student* entry_got) {
@@ -171,7 +709,6 @@ static int st_interactive_get(FILE* istream, FILE* ostream, student* entry_got)
     size_t faculty_len = getline(&faculty, &buf_len, istream);
     if (-1 == faculty_len) {
         free(surname);
-        free(grade_book_num_str);
         free(faculty);
         return STS_READING_INPUT_ERROR;
     }
@@ -183,7 +720,6 @@ static int st_interactive_get(FILE* istream, FILE* ostream, student* entry_got)
     size_t group_len = getline(&group, &buf_len, istream);
     if (-1 == group_len) {
         free(surname);
-        free(grade_book_num_str);
         free(faculty);
         free(group);
         return STS_READING_INPUT_ERROR;
@@ -202,12 +738,20 @@ int st_interactive_add(students_array* collection, FILE* istream, FILE* ostream)
     assert(NULL != collection);
     assert(NULL != istream);
     assert(NULL != ostream);
+    assert(STS_BORROWS_STRINGS != collection->ownership);
     student new_entry;
     int getting_result = st_interactive_get(istream, ostream, &new_entry);
     if (0 != getting_result) {
         return getting_result;
     }
-    return st_add(collection, new_entry);
+    int adding_result = st_add(collection, new_entry);
+    if ((0 != adding_result) || (STS_ARENA_STRINGS == collection->ownership)) {
+        // Strings were either not stored at all or copied into arena
+        free(new_entry.surname);
+        free(new_entry.faculty);
+        free(new_entry.group);
+    }
+    return adding_result;
 }
 
 void sts_formatted_print_all(const students_array* collection, FILE* ostream) {
@@ -230,156 +774,756 @@ void* sts_fold(students_array* collection,
     assert(NULL != collection);
     assert(NULL != operation);
     if (NULL == collection->students) {
-        return NULL;
+        return NULL;
+    }
+    void* accumulator = NULL;
+    for (size_t i = 0; i < collection->students_num; ++i) {
+        accumulator = operation(collection->students + i, accumulator);
+    }
+    return accumulator;
+}
+
+
+
+/**
+ * Smaller collections are reduced in the calling thread
+*/
+#define STS_PARALLEL_REDUCE_THRESHOLD (1 << 14)
+// Partial results up to this size in total live on stack
+#define STS_REDUCE_STACK_BUF_SIZE 1024
+
+typedef struct st_reduce_job {
+    const students_array* collection;
+    const students_reducer* reducer;
+    char* partials;
+    size_t partial_stride;
+    size_t chunk_len;
+} st_reduce_job;
+
+static void st_reduce_range(const students_array* collection, 
+                            const students_reducer* reducer, void* acc, 
+                            size_t from, size_t to) {
+    memcpy(acc, reducer->init, reducer->acc_size);
+    for (size_t i = from; i < to; ++i) {
+        reducer->step(acc, collection->students + i);
+    }
+}
+
+static void st_reduce_chunk_task(size_t task_idx, void* ctx) {
+    st_reduce_job* job = (st_reduce_job*) ctx;
+    size_t n = job->collection->students_num;
+    size_t from = task_idx * job->chunk_len;
+    if (from > n) {
+        from = n;
+    }
+    size_t to = (n - from > job->chunk_len) ? from + job->chunk_len : n;
+    st_reduce_range(job->collection, job->reducer, 
+                    job->partials + task_idx * job->partial_stride, from, to);
+}
+
+int sts_reduce(const students_array* collection, 
+               const students_reducer* reducer, void* result, 
+               size_t threads_num) {
+    assert(NULL != collection);
+    assert(NULL != reducer);
+    assert(NULL != reducer->init);
+    assert(NULL != reducer->step);
+    assert(NULL != reducer->combine);
+    assert(NULL != result);
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    if (0 == threads_num) {
+        threads_num = tp_cpus_num();
+    }
+    thread_pool* pool = NULL;
+    if ((1 < threads_num) && (STS_PARALLEL_REDUCE_THRESHOLD <= n)) {
+        pool = tp_default();
+    }
+    if (NULL == pool) {
+        st_reduce_range(collection, reducer, result, 0, n);
+        return 0;
+    }
+    // Partial results are aligned like anything malloc() returns
+    size_t alignment = _Alignof(max_align_t);
+    size_t stride = (reducer->acc_size + alignment - 1) / alignment * alignment;
+    if (0 == stride) {
+        stride = alignment;
+    }
+    union {
+        max_align_t alignment_holder;
+        char bytes[STS_REDUCE_STACK_BUF_SIZE];
+    } stack_buf;
+    char* partials = stack_buf.bytes;
+    if (SIZE_MAX / stride < threads_num) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (stride * threads_num > sizeof(stack_buf.bytes)) {
+        partials = (char*) malloc(stride * threads_num);
+        if (NULL == partials) {
+            return STS_MEM_ALLOC_ERROR;
+        }
+    }
+    st_reduce_job job;
+    job.collection = collection;
+    job.reducer = reducer;
+    job.partials = partials;
+    job.partial_stride = stride;
+    job.chunk_len = (n + threads_num - 1) / threads_num;
+    tp_run(pool, threads_num, st_reduce_chunk_task, &job);
+    // Combining in chunk order, so 'combine' need not be commutative
+    memcpy(result, partials, reducer->acc_size);
+    for (size_t i = 1; i < threads_num; ++i) {
+        reducer->combine(result, partials + i * stride);
+    }
+    if (partials != stack_buf.bytes) {
+        free(partials);
+    }
+    return 0;
+}
+
+
+
+/*************** Beginning of sort functions ***************/
+
+/**
+ * Collections smaller than this are sorted by a single qsort() call:
+ *  waking up threads and merging would cost more than it saves
+*/
+#define STS_PARALLEL_SORT_THRESHOLD (1 << 15)
+
+/**
+ * Parallel merge sort: chunks are sorted with qsort() concurrently,
+ *  then sorted runs are merged pairwise, every merge being a separate task
+*/
+typedef struct st_parallel_sort_job {
+    student* src;
+    student* dst;
+    size_t students_num;
+    size_t run_len;
+    int (*comparator)(const void*, const void*);
+} st_parallel_sort_job;
+
+static void st_sort_chunk_task(size_t task_idx, void* ctx) {
+    st_parallel_sort_job* job = (st_parallel_sort_job*) ctx;
+    size_t from = task_idx * job->run_len;
+    if (from >= job->students_num) {
+        return;
+    }
+    size_t len = job->students_num - from;
+    if (len > job->run_len) {
+        len = job->run_len;
+    }
+    qsort(job->src + from, len, sizeof(*(job->src)), job->comparator);
+}
+
+static void st_merge_runs_task(size_t task_idx, void* ctx) {
+    st_parallel_sort_job* job = (st_parallel_sort_job*) ctx;
+    size_t n = job->students_num;
+    size_t left = 2 * task_idx * job->run_len;
+    size_t middle = (n - left > job->run_len) ? left + job->run_len : n;
+    size_t right = (n - middle > job->run_len) ? middle + job->run_len : n;
+    size_t i = left;
+    size_t j = middle;
+    size_t k = left;
+    while ((i < middle) && (j < right)) {
+        // Taking from the left run on ties
+        if (job->comparator(job->src + j, job->src + i) < 0) {
+            job->dst[k++] = job->src[j++];
+        }
+        else {
+            job->dst[k++] = job->src[i++];
+        }
+    }
+    memcpy(job->dst + k, job->src + i, sizeof(*(job->src)) * (middle - i));
+    k += middle - i;
+    memcpy(job->dst + k, job->src + j, sizeof(*(job->src)) * (right - j));
+}
+
+/**
+ * Returns false if sorting was not done (e.g. memory allocation failed)
+*/
+static bool st_parallel_sort(students_array* collection, 
+                             int (*comparator)(const void*, const void*), 
+                             size_t threads_num) {
+    thread_pool* pool = tp_default();
+    if (NULL == pool) {
+        return false;
+    }
+    size_t n = collection->students_num;
+    student* buf = (student*) malloc(sizeof(*buf) * n);
+    if (NULL == buf) {
+        return false;
+    }
+    st_parallel_sort_job job;
+    job.src = collection->students;
+    job.dst = buf;
+    job.students_num = n;
+    job.run_len = (n + threads_num - 1) / threads_num;
+    job.comparator = comparator;
+    tp_run(pool, threads_num, st_sort_chunk_task, &job);
+    while (job.run_len < n) {
+        size_t pairs_num = (n + 2 * job.run_len - 1) / (2 * job.run_len);
+        tp_run(pool, pairs_num, st_merge_runs_task, &job);
+        student* tmp = job.src;
+        job.src = job.dst;
+        job.dst = tmp;
+        job.run_len = (n - job.run_len < job.run_len) ? n : 2 * job.run_len;
+    }
+    if (job.src != collection->students) {
+        memcpy(collection->students, job.src, sizeof(*buf) * n);
+    }
+    free(buf);
+    return true;
+}
+
+/**
+ * 'threads_num' == 0 means "as many as there are CPUs"
+*/
+static void st_sort_with_threads(students_array* collection, 
+                                 int (*comparator)(const void*, const void*), 
+                                 size_t threads_num) {
+    assert(NULL != collection);
+    assert(NULL != comparator);
+    if (0 == threads_num) {
+        threads_num = tp_cpus_num();
+    }
+    if ((1 == threads_num) || 
+        (STS_PARALLEL_SORT_THRESHOLD > collection->students_num) || 
+        !st_parallel_sort(collection, comparator, threads_num)) {
+        qsort(collection->students, collection->students_num, 
+              sizeof(*(collection->students)), comparator);
+    }
+    st_index_rebuild(collection);
+    collection->generation++;
+}
+
+static void st_sort_with(students_array* collection, 
+                         int (*comparator)(const void*, const void*)) {
+    st_sort_with_threads(collection, comparator, 0);
+}
+
+/**
+ * Sorts with one of the kernels defined below for predefined sorts
+ *  and remembers the order, so searches by 'key' can use binary search
+*/
+static void st_sort_by_kernel(students_array* collection, 
+                              void (*kernel)(student*, size_t, const void*), 
+                              enum students_sort_key key, bool desc) {
+    assert(NULL != collection);
+    kernel(collection->students, collection->students_num, NULL);
+    st_index_rebuild(collection);
+    collection->generation++;
+    collection->sort_key = key;
+    collection->sort_desc = desc;
+}
+
+void sts_sort_any(students_array* collection, 
+                  int (*comparator)(const void*, const void*)) {
+    assert(NULL != collection);
+    assert(NULL != comparator);
+    if (NULL == collection->students) {
+        return;
+    }
+    st_sort_with(collection, comparator);
+    // Nothing is known about arbitrary comparator's order
+    collection->sort_key = STS_NOT_SORTED;
+}
+
+void sts_sort_any_parallel(students_array* collection, 
+                           int (*comparator)(const void*, const void*), 
+                           size_t threads_num) {
+    assert(NULL != collection);
+    assert(NULL != comparator);
+    if (NULL == collection->students) {
+        return;
+    }
+    st_sort_with_threads(collection, comparator, threads_num);
+    collection->sort_key = STS_NOT_SORTED;
+}
+
+/**
+ * Predefined sorts switch to radix sort from this size on:
+ *  below it comparison kernels are fast enough and radix buffers 
+ *  are not worth it
+*/
+#define STS_RADIX_SORT_THRESHOLD (1 << 11)
+
+static uint32_t st_radix_key_grade_book_num(const student* entry) {
+    // Flipping sign bit makes unsigned order match signed one
+    return (uint32_t) entry->grade_book_num ^ UINT32_C(0x80000000);
+}
+
+static uint32_t st_radix_key_faculty_code(const student* entry) {
+    return (uint32_t) sd_code_of(entry->faculty);
+}
+
+static uint32_t st_radix_key_group_code(const student* entry) {
+    return (uint32_t) sd_code_of(entry->group);
+}
+
+/**
+ * Radix sorts collection by 'key' and remembers the order
+ *  (dictionary codes are sorted instead of strings when possible).
+ * Returns false if buffers could not be allocated, nothing is changed then
+*/
+static bool st_radix_sort_by_key(students_array* collection, 
+                                 enum students_sort_key key, bool desc) {
+    assert(NULL != collection);
+    thread_pool* pool = NULL;
+    size_t threads_num = tp_cpus_num();
+    if ((1 < threads_num) && 
+        (STS_PARALLEL_SORT_THRESHOLD <= collection->students_num)) {
+        pool = tp_default();
+    }
+    student* students = collection->students;
+    size_t n = collection->students_num;
+    int sorting_result = 0;
+    switch (key) {
+        case STS_SORTED_BY_SURNAME:
+            sorting_result = srs_sort_by_string(students, n, 
+                offsetof(student, surname), desc, pool, threads_num);
+            break;
+        case STS_SORTED_BY_GRADE_BOOK_NUM:
+            sorting_result = srs_sort_by_uint_key(students, n, 
+                st_radix_key_grade_book_num, desc, pool, threads_num);
+            break;
+        case STS_SORTED_BY_FACULTY:
+            sorting_result = (NULL != collection->faculty_dict) ? 
+                srs_sort_by_uint_key(students, n, 
+                    st_radix_key_faculty_code, desc, pool, threads_num) : 
+                srs_sort_by_string(students, n, 
+                    offsetof(student, faculty), desc, pool, threads_num);
+            break;
+        case STS_SORTED_BY_GROUP:
+            sorting_result = (NULL != collection->group_dict) ? 
+                srs_sort_by_uint_key(students, n, 
+                    st_radix_key_group_code, desc, pool, threads_num) : 
+                srs_sort_by_string(students, n, 
+                    offsetof(student, group), desc, pool, threads_num);
+            break;
+        default:
+            assert(false);
+    }
+    if (0 != sorting_result) {
+        return false;
+    }
+    st_index_rebuild(collection);
+    collection->generation++;
+    collection->sort_key = key;
+    collection->sort_desc = desc;
+    return true;
+}
+
+static inline bool st_less_surname_asc(const student* s1, const student* s2, 
+                                       const void* ctx) {
+    (void) ctx;
+    return strcmp(s1->surname, s2->surname) < 0;
+}
+
+STS_DEFINE_SORT_KERNEL(st_kernel_surname_asc, void, st_less_surname_asc)
+
+/**
+ * st_sort_*_comparison() functions are used by radix variants 
+ *  when buffers cannot be allocated and by regular ones for small collections
+*/
+static void st_sort_surname_asc_comparison(students_array* collection) {
+    st_sort_by_kernel(collection, st_kernel_surname_asc, 
+                      STS_SORTED_BY_SURNAME, false);
+}
+
+void sts_sort_surname_asc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (STS_RADIX_SORT_THRESHOLD <= collection->students_num) {
+        sts_sort_surname_radix_asc(collection);
+        return;
+    }
+    st_sort_surname_asc_comparison(collection);
+}
+
+void sts_sort_surname_radix_asc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (!st_radix_sort_by_key(collection, STS_SORTED_BY_SURNAME, false)) {
+        st_sort_surname_asc_comparison(collection);
+    }
+}
+
+static inline bool st_less_surname_desc(const student* s1, const student* s2, 
+                                        const void* ctx) {
+    (void) ctx;
+    return strcmp(s1->surname, s2->surname) > 0;
+}
+
+STS_DEFINE_SORT_KERNEL(st_kernel_surname_desc, void, st_less_surname_desc)
+
+static void st_sort_surname_desc_comparison(students_array* collection) {
+    st_sort_by_kernel(collection, st_kernel_surname_desc, 
+                      STS_SORTED_BY_SURNAME, true);
+}
+
+void sts_sort_surname_desc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (STS_RADIX_SORT_THRESHOLD <= collection->students_num) {
+        sts_sort_surname_radix_desc(collection);
+        return;
+    }
+    st_sort_surname_desc_comparison(collection);
+}
+
+void sts_sort_surname_radix_desc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (!st_radix_sort_by_key(collection, STS_SORTED_BY_SURNAME, true)) {
+        st_sort_surname_desc_comparison(collection);
+    }
+}
+
+static inline bool st_less_grade_book_num_asc(const student* s1, const student* s2, 
+                                              const void* ctx) {
+    (void) ctx;
+    return s1->grade_book_num < s2->grade_book_num;
+}
+
+STS_DEFINE_SORT_KERNEL(st_kernel_grade_book_num_asc, void, st_less_grade_book_num_asc)
+
+static void st_sort_grade_book_num_asc_comparison(students_array* collection) {
+    st_sort_by_kernel(collection, st_kernel_grade_book_num_asc, 
+                      STS_SORTED_BY_GRADE_BOOK_NUM, false);
+}
+
+void sts_sort_grade_book_num_asc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (STS_RADIX_SORT_THRESHOLD <= collection->students_num) {
+        sts_sort_grade_book_num_radix_asc(collection);
+        return;
+    }
+    st_sort_grade_book_num_asc_comparison(collection);
+}
+
+void sts_sort_grade_book_num_radix_asc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (!st_radix_sort_by_key(collection, STS_SORTED_BY_GRADE_BOOK_NUM, false)) {
+        st_sort_grade_book_num_asc_comparison(collection);
+    }
+}
+
+static inline bool st_less_grade_book_num_desc(const student* s1, const student* s2, 
+                                               const void* ctx) {
+    (void) ctx;
+    return s1->grade_book_num > s2->grade_book_num;
+}
+
+STS_DEFINE_SORT_KERNEL(st_kernel_grade_book_num_desc, void, st_less_grade_book_num_desc)
+
+static void st_sort_grade_book_num_desc_comparison(students_array* collection) {
+    st_sort_by_kernel(collection, st_kernel_grade_book_num_desc, 
+                      STS_SORTED_BY_GRADE_BOOK_NUM, true);
+}
+
+void sts_sort_grade_book_num_desc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (STS_RADIX_SORT_THRESHOLD <= collection->students_num) {
+        sts_sort_grade_book_num_radix_desc(collection);
+        return;
+    }
+    st_sort_grade_book_num_desc_comparison(collection);
+}
+
+void sts_sort_grade_book_num_radix_desc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (!st_radix_sort_by_key(collection, STS_SORTED_BY_GRADE_BOOK_NUM, true)) {
+        st_sort_grade_book_num_desc_comparison(collection);
+    }
+}
+
+static inline bool st_less_faculty_asc(const student* s1, const student* s2, 
+                                       const void* ctx) {
+    (void) ctx;
+    return strcmp(s1->faculty, s2->faculty) < 0;
+}
+
+STS_DEFINE_SORT_KERNEL(st_kernel_faculty_asc, void, st_less_faculty_asc)
+
+static inline bool st_less_faculty_code_asc(const student* s1, const student* s2, 
+                                            const void* ctx) {
+    (void) ctx;
+    return sd_code_of(s1->faculty) < sd_code_of(s2->faculty);
+}
+
+STS_DEFINE_SORT_KERNEL(st_kernel_faculty_code_asc, void, st_less_faculty_code_asc)
+
+static void st_sort_faculty_asc_comparison(students_array* collection) {
+    if (NULL != collection->faculty_dict) {
+        st_sort_by_kernel(collection, st_kernel_faculty_code_asc, 
+                          STS_SORTED_BY_FACULTY, false);
+        return;
+    }
+    st_sort_by_kernel(collection, st_kernel_faculty_asc, 
+                      STS_SORTED_BY_FACULTY, false);
+}
+
+void sts_sort_faculty_asc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (STS_RADIX_SORT_THRESHOLD <= collection->students_num) {
+        sts_sort_faculty_radix_asc(collection);
+        return;
+    }
+    st_sort_faculty_asc_comparison(collection);
+}
+
+void sts_sort_faculty_radix_asc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
     }
-    void* accumulator = NULL;
-    for (size_t i = 0; i < collection->students_num; ++i) {
-        accumulator = operation(collection->students + i, accumulator);
+    if (!st_radix_sort_by_key(collection, STS_SORTED_BY_FACULTY, false)) {
+        st_sort_faculty_asc_comparison(collection);
     }
-    return accumulator;
 }
 
+static inline bool st_less_faculty_desc(const student* s1, const student* s2, 
+                                        const void* ctx) {
+    (void) ctx;
+    return strcmp(s1->faculty, s2->faculty) > 0;
+}
 
+STS_DEFINE_SORT_KERNEL(st_kernel_faculty_desc, void, st_less_faculty_desc)
 
-/*************** Beginning of sort functions ***************/
+static inline bool st_less_faculty_code_desc(const student* s1, const student* s2, 
+                                             const void* ctx) {
+    (void) ctx;
+    return sd_code_of(s1->faculty) > sd_code_of(s2->faculty);
+}
 
-void sts_sort_any(const students_array* collection, 
-                  int (*comparator)(const void*, const void*)) {
-    assert(NULL != collection);
-    assert(NULL != comparator);
-    if (NULL == collection->students) {
+STS_DEFINE_SORT_KERNEL(st_kernel_faculty_code_desc, void, st_less_faculty_code_desc)
+
+static void st_sort_faculty_desc_comparison(students_array* collection) {
+    if (NULL != collection->faculty_dict) {
+        st_sort_by_kernel(collection, st_kernel_faculty_code_desc, 
+                          STS_SORTED_BY_FACULTY, true);
         return;
     }
-    qsort(collection->students, collection->students_num, 
-          sizeof(*(collection->students)), comparator);
-}
-
-static int st_comparator_surname_asc(const void* arg1, const void* arg2) {
-    assert(NULL != arg1);
-    assert(NULL != arg2);
-    student* s1 = (student*) arg1;
-    student* s2 = (student*) arg2;
-    return strcmp(s1->surname, s2->surname);
+    st_sort_by_kernel(collection, st_kernel_faculty_desc, 
+                      STS_SORTED_BY_FACULTY, true);
 }
 
-void sts_sort_surname_asc(const students_array* collection) {
+void sts_sort_faculty_desc(students_array* collection) {
     assert(NULL != collection);
     if (NULL == collection->students) {
         return;
     }
-    sts_sort_any(collection, st_comparator_surname_asc);
-}
-
-static int st_comparator_surname_desc(const void* arg1, const void* arg2) {
-    assert(NULL != arg1);
-    assert(NULL != arg2);
-    student* s1 = (student*) arg1;
-    student* s2 = (student*) arg2;
-    return -strcmp(s1->surname, s2->surname);
+    if (STS_RADIX_SORT_THRESHOLD <= collection->students_num) {
+        sts_sort_faculty_radix_desc(collection);
+        return;
+    }
+    st_sort_faculty_desc_comparison(collection);
 }
 
-void sts_sort_surname_desc(const students_array* collection) {
+void sts_sort_faculty_radix_desc(students_array* collection) {
     assert(NULL != collection);
     if (NULL == collection->students) {
         return;
     }
-    sts_sort_any(collection, st_comparator_surname_desc);
+    if (!st_radix_sort_by_key(collection, STS_SORTED_BY_FACULTY, true)) {
+        st_sort_faculty_desc_comparison(collection);
+    }
 }
 
-static int st_comparator_grade_book_num_asc(const void* arg1, const void* arg2) {
-    assert(NULL != arg1);
-    assert(NULL != arg2);
-    student* s1 = (student*) arg1;
-    student* s2 = (student*) arg2;
-    return (s1->grade_book_num - s2->grade_book_num);
+static inline bool st_less_group_asc(const student* s1, const student* s2, 
+                                     const void* ctx) {
+    (void) ctx;
+    return strcmp(s1->group, s2->group) < 0;
 }
 
-void sts_sort_grade_book_num_asc(const students_array* collection) {
-    assert(NULL != collection);
-    if (NULL == collection->students) {
+STS_DEFINE_SORT_KERNEL(st_kernel_group_asc, void, st_less_group_asc)
+
+static inline bool st_less_group_code_asc(const student* s1, const student* s2, 
+                                          const void* ctx) {
+    (void) ctx;
+    return sd_code_of(s1->group) < sd_code_of(s2->group);
+}
+
+STS_DEFINE_SORT_KERNEL(st_kernel_group_code_asc, void, st_less_group_code_asc)
+
+static void st_sort_group_asc_comparison(students_array* collection) {
+    if (NULL != collection->group_dict) {
+        st_sort_by_kernel(collection, st_kernel_group_code_asc, 
+                          STS_SORTED_BY_GROUP, false);
         return;
     }
-    sts_sort_any(collection, st_comparator_grade_book_num_asc);
+    st_sort_by_kernel(collection, st_kernel_group_asc, 
+                      STS_SORTED_BY_GROUP, false);
 }
 
-static int st_comparator_grade_book_num_desc(const void* arg1, const void* arg2) {
-    assert(NULL != arg1);
-    assert(NULL != arg2);
-    student* s1 = (student*) arg1;
-    student* s2 = (student*) arg2;
-    return (s2->grade_book_num - s1->grade_book_num);
+void sts_sort_group_asc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (STS_RADIX_SORT_THRESHOLD <= collection->students_num) {
+        sts_sort_group_radix_asc(collection);
+        return;
+    }
+    st_sort_group_asc_comparison(collection);
 }
 
-void sts_sort_grade_book_num_desc(const students_array* collection) {
+void sts_sort_group_radix_asc(students_array* collection) {
     assert(NULL != collection);
     if (NULL == collection->students) {
         return;
     }
-    sts_sort_any(collection, st_comparator_grade_book_num_desc);
+    if (!st_radix_sort_by_key(collection, STS_SORTED_BY_GROUP, false)) {
+        st_sort_group_asc_comparison(collection);
+    }
 }
 
-static int st_comparator_faculty_asc(const void* arg1, const void* arg2) {
-    assert(NULL != arg1);
-    assert(NULL != arg2);
-    student* s1 = (student*) arg1;
-    student* s2 = (student*) arg2;
-    return strcmp(s1->faculty, s2->faculty);
+static inline bool st_less_group_desc(const student* s1, const student* s2, 
+                                      const void* ctx) {
+    (void) ctx;
+    return strcmp(s1->group, s2->group) > 0;
 }
 
-void sts_sort_faculty_asc(const students_array* collection) {
-    assert(NULL != collection);
-    if (NULL == collection->students) {
+STS_DEFINE_SORT_KERNEL(st_kernel_group_desc, void, st_less_group_desc)
+
+static inline bool st_less_group_code_desc(const student* s1, const student* s2, 
+                                           const void* ctx) {
+    (void) ctx;
+    return sd_code_of(s1->group) > sd_code_of(s2->group);
+}
+
+STS_DEFINE_SORT_KERNEL(st_kernel_group_code_desc, void, st_less_group_code_desc)
+
+static void st_sort_group_desc_comparison(students_array* collection) {
+    if (NULL != collection->group_dict) {
+        st_sort_by_kernel(collection, st_kernel_group_code_desc, 
+                          STS_SORTED_BY_GROUP, true);
         return;
     }
-    sts_sort_any(collection, st_comparator_faculty_asc);
+    st_sort_by_kernel(collection, st_kernel_group_desc, 
+                      STS_SORTED_BY_GROUP, true);
 }
 
-static int st_comparator_faculty_desc(const void* arg1, const void* arg2) {
-    assert(NULL != arg1);
-    assert(NULL != arg2);
-    student* s1 = (student*) arg1;
-    student* s2 = (student*) arg2;
-    return -strcmp(s1->faculty, s2->faculty);
+void sts_sort_group_desc(students_array* collection) {
+    assert(NULL != collection);
+    if (NULL == collection->students) {
+        return;
+    }
+    if (STS_RADIX_SORT_THRESHOLD <= collection->students_num) {
+        sts_sort_group_radix_desc(collection);
+        return;
+    }
+    st_sort_group_desc_comparison(collection);
 }
 
-void sts_sort_faculty_desc(const students_array* collection) {
+void sts_sort_group_radix_desc(students_array* collection) {
     assert(NULL != collection);
     if (NULL == collection->students) {
         return;
     }
-    sts_sort_any(collection, st_comparator_faculty_desc);
+    if (!st_radix_sort_by_key(collection, STS_SORTED_BY_GROUP, true)) {
+        st_sort_group_desc_comparison(collection);
+    }
 }
 
-static int st_comparator_group_asc(const void* arg1, const void* arg2) {
-    assert(NULL != arg1);
-    assert(NULL != arg2);
-    student* s1 = (student*) arg1;
-    student* s2 = (student*) arg2;
-    return strcmp(s1->group, s2->group);
+typedef struct st_multi_key_ctx {
+    students_sort_spec keys[STS_MAX_SORT_KEYS];
+    size_t keys_num;
+    // Dictionary codes are compared instead of strings when possible
+    bool faculty_codes;
+    bool group_codes;
+} st_multi_key_ctx;
+
+static inline int st_compare_codes(const char* interned1, const char* interned2) {
+    size_t code1 = sd_code_of(interned1);
+    size_t code2 = sd_code_of(interned2);
+    return (code1 > code2) - (code1 < code2);
 }
 
-void sts_sort_group_asc(const students_array* collection) {
-    assert(NULL != collection);
-    if (NULL == collection->students) {
-        return;
+// Repeated values are often one shared string (borrowed literals, arena dedup)
+static inline int st_compare_shared_strings(const char* str1, const char* str2) {
+    return (str1 == str2) ? 0 : strcmp(str1, str2);
+}
+
+static inline int st_compare_by_spec_key(const student* s1, const student* s2, 
+                                         enum students_sort_key key, 
+                                         const st_multi_key_ctx* ctx) {
+    switch (key) {
+        case STS_SORTED_BY_SURNAME:
+            return strcmp(s1->surname, s2->surname);
+        case STS_SORTED_BY_GRADE_BOOK_NUM:
+            return (s1->grade_book_num > s2->grade_book_num) - 
+                   (s1->grade_book_num < s2->grade_book_num);
+        case STS_SORTED_BY_FACULTY:
+            return ctx->faculty_codes ? 
+                st_compare_codes(s1->faculty, s2->faculty) : 
+                st_compare_shared_strings(s1->faculty, s2->faculty);
+        case STS_SORTED_BY_GROUP:
+            return ctx->group_codes ? 
+                st_compare_codes(s1->group, s2->group) : 
+                st_compare_shared_strings(s1->group, s2->group);
+        default:
+            return 0;
     }
-    sts_sort_any(collection, st_comparator_group_asc);
 }
 
-static int st_comparator_group_desc(const void* arg1, const void* arg2) {
-    assert(NULL != arg1);
-    assert(NULL != arg2);
-    student* s1 = (student*) arg1;
-    student* s2 = (student*) arg2;
-    return -strcmp(s1->group, s2->group);
+static inline bool st_less_multi_key(const student* s1, const student* s2, 
+                                     const st_multi_key_ctx* ctx) {
+    for (size_t i = 0; i < ctx->keys_num; ++i) {
+        int cmp_result = st_compare_by_spec_key(s1, s2, ctx->keys[i].key, ctx);
+        if (0 != cmp_result) {
+            return ctx->keys[i].desc ? (0 < cmp_result) : (0 > cmp_result);
+        }
+    }
+    return false;
 }
 
-void sts_sort_group_desc(const students_array* collection) {
+STS_DEFINE_SORT_KERNEL(st_kernel_multi_key, st_multi_key_ctx, st_less_multi_key)
+
+void sts_sort_multi_key(students_array* collection, 
+                        const students_sort_spec* keys, size_t keys_num) {
     assert(NULL != collection);
-    if (NULL == collection->students) {
+    assert((NULL != keys) || (0 == keys_num));
+    assert(STS_MAX_SORT_KEYS >= keys_num);
+    if ((NULL == collection->students) || (0 == keys_num)) {
         return;
     }
-    sts_sort_any(collection, st_comparator_group_desc);
+    st_multi_key_ctx ctx;
+    for (size_t i = 0; i < keys_num; ++i) {
+        assert(STS_NOT_SORTED != keys[i].key);
+        ctx.keys[i] = keys[i];
+    }
+    ctx.keys_num = keys_num;
+    ctx.faculty_codes = (NULL != collection->faculty_dict);
+    ctx.group_codes = (NULL != collection->group_dict);
+    st_kernel_multi_key(collection->students, collection->students_num, &ctx);
+    st_index_rebuild(collection);
+    collection->generation++;
+    collection->sort_key = keys[0].key;
+    collection->sort_desc = keys[0].desc;
 }
 
 /****************** End of sort functions ******************/
@@ -388,6 +1532,143 @@ void sts_sort_group_desc(const students_array* collection) {
 
 /************** Beginning of search functions **************/
 
+/**
+ * Binary search helpers for collections with known sort order.
+ * 'value' is 'const int*' for grade_book_num and 'const char*' otherwise
+*/
+static int st_compare_key_to_value(enum students_sort_key key, 
+                                   const student* entry, const void* value) {
+    assert(NULL != entry);
+    assert(NULL != value);
+    switch (key) {
+        case STS_SORTED_BY_SURNAME:
+            return strcmp(entry->surname, (const char*) value);
+        case STS_SORTED_BY_GRADE_BOOK_NUM: {
+            int int_value = *((const int*) value);
+            return (entry->grade_book_num > int_value) - 
+                   (entry->grade_book_num < int_value);
+        }
+        case STS_SORTED_BY_FACULTY:
+            return strcmp(entry->faculty, (const char*) value);
+        case STS_SORTED_BY_GROUP:
+            return strcmp(entry->group, (const char*) value);
+        default:
+            assert(false);
+            return 0;
+    }
+}
+
+static bool st_is_sorted_by(const students_array* collection, 
+                            enum students_sort_key key) {
+    return (NULL != collection->students) && (key == collection->sort_key);
+}
+
+/**
+ * Returns position of the first entry not preceding 'value'
+ *  (or, if 'upper' is set, of the first entry following it)
+ *  in collection's current order
+*/
+static size_t st_sorted_bound(const students_array* collection, 
+                              const void* value, bool upper) {
+    size_t left = 0;
+    size_t right = collection->students_num;
+    while (left < right) {
+        size_t middle = left + (right - left) / 2;
+        int cmp_result = st_compare_key_to_value(collection->sort_key, 
+                                        collection->students + middle, value);
+        if (collection->sort_desc) {
+            cmp_result = -cmp_result;
+        }
+        if (upper ? (cmp_result <= 0) : (cmp_result < 0)) {
+            left = middle + 1;
+        }
+        else {
+            right = middle;
+        }
+    }
+    return left;
+}
+
+static void st_sorted_equal_range(const students_array* collection, 
+                                  const void* value, 
+                                  size_t* from, size_t* to) {
+    *from = st_sorted_bound(collection, value, false);
+    *to = st_sorted_bound(collection, value, true);
+}
+
+static student* st_sorted_find_one_exact(const students_array* collection, 
+                                         const void* value) {
+    size_t from = 0;
+    size_t to = 0;
+    st_sorted_equal_range(collection, value, &from, &to);
+    return (from < to) ? collection->students + from : NULL;
+}
+
+static students_view* st_sorted_view_all_exact(
+                                        const students_array* collection, 
+                                        const void* value) {
+    size_t from = 0;
+    size_t to = 0;
+    st_sorted_equal_range(collection, value, &from, &to);
+    students_view* result = stv_new(collection, to - from);
+    if (NULL == result) {
+        return NULL;
+    }
+    for (size_t i = from; i < to; ++i) {
+        result->positions[i - from] = i;
+    }
+    return result;
+}
+
+/**
+ * For collection sorted by grade_book_num finds ranges of entries 
+ *  closest to 'value'. There can be two of them: for value - d and value + d.
+ *  Ranges are returned in array order, second one may be empty
+*/
+static void st_sorted_closest_grade_book_num(const students_array* collection, 
+                                             int value, size_t ranges[2][2]) {
+    assert(0 != collection->students_num);
+    size_t pos = st_sorted_bound(collection, &value, false);
+    // Closest entries are neighbours of the place 'value' would be inserted to
+    long long min_distance = LLONG_MAX;
+    if (pos < collection->students_num) {
+        min_distance = 
+            llabs((long long) collection->students[pos].grade_book_num - value);
+    }
+    if (0 < pos) {
+        long long prev_distance = 
+            llabs((long long) collection->students[pos - 1].grade_book_num - value);
+        if (prev_distance < min_distance) {
+            min_distance = prev_distance;
+        }
+    }
+    /**
+     * Out of range bound has no entries: clamping keeps the cast 
+     *  from wrapping it onto the other bound's value
+    */
+    long long lower = value - min_distance;
+    long long upper = value + min_distance;
+    int lower_value = (INT_MIN > lower) ? INT_MIN : (int) lower;
+    int upper_value = (INT_MAX < upper) ? INT_MAX : (int) upper;
+    st_sorted_equal_range(collection, &lower_value, 
+                          &(ranges[0][0]), &(ranges[0][1]));
+    if ((0 == min_distance) || (lower_value == upper_value)) {
+        ranges[1][0] = ranges[1][1] = 0;
+        return;
+    }
+    st_sorted_equal_range(collection, &upper_value, 
+                          &(ranges[1][0]), &(ranges[1][1]));
+    if ((ranges[0][0] == ranges[0][1]) || 
+        ((ranges[1][0] < ranges[1][1]) && (ranges[1][0] < ranges[0][0]))) {
+        size_t tmp_from = ranges[0][0];
+        size_t tmp_to = ranges[0][1];
+        ranges[0][0] = ranges[1][0];
+        ranges[0][1] = ranges[1][1];
+        ranges[1][0] = tmp_from;
+        ranges[1][1] = tmp_to;
+    }
+}
+
 student* st_find_one_closest_any(const students_array* collection, 
                                  int (*distance)(const student*, const void*), 
                                  const void* arg) {
@@ -425,67 +1706,83 @@ student* st_find_one_exact_any(const students_array* collection,
     return NULL;
 }
 
-students_array* st_find_all_closest_any(
+students_view* st_view_all_closest_any(
                                 const students_array* collection, 
                                 int (*distance)(const student*, const void*), 
                                 const void* arg) {
     assert(NULL != collection);
     assert(NULL != distance);
-    students_array* result = st_new_array(0);
     if ((NULL == collection->students) || (0 == collection->students_num)) {
-        return result;
+        return stv_new(collection, 0);
+    }
+    // Single pass: distance is called once per entry
+    students_view* result = stv_new(collection, collection->students_num);
+    if (NULL == result) {
+        return NULL;
     }
     int min_distance = distance(collection->students, arg);
+    result->positions[0] = 0;
+    size_t matches_num = 1;
     for (size_t i = 1; i < collection->students_num; ++i) {
         int cur_distance = distance(collection->students + i, arg);
         if (min_distance > cur_distance) {
             min_distance = cur_distance;
+            matches_num = 0;
         }
-    }
-    for (size_t i = 0; i < collection->students_num; ++i) {
-        int cur_distance = distance(collection->students + i, arg);
         if (min_distance == cur_distance) {
-            if (st_add(result, (collection->students)[i])) {
-                /**
-                 * We did not duplicate strings, 
-                 * so should not call sts_destroy_all(result) 
-                */
-                free(result->students);
-                free(result);
-                return NULL;
-            }
+            result->positions[matches_num++] = i;
         }
     }
-    return result;
+    return stv_truncate(result, matches_num);
 }
 
-students_array* st_find_all_exact_any(
+students_view* st_view_all_exact_any(
                                 const students_array* collection, 
                                 int (*distance)(const student*, const void*), 
                                 const void* arg) {
     assert(NULL != collection);
     assert(NULL != distance);
-    students_array* result = st_new_array(0);
-    if ((NULL == collection->students) || (0 == collection->students_num)) {
-        return result;
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    // Single pass: distance is called once per entry
+    students_view* result = stv_new(collection, n);
+    if (NULL == result) {
+        return NULL;
     }
-    for (size_t i = 0; i < collection->students_num; ++i) {
-        int cur_distance = distance(collection->students + i, arg);
-        if (0 == cur_distance) {
-            if (st_add(result, (collection->students)[i])) {
-                /**
-                 * We did not duplicate strings, 
-                 * so should not call sts_destroy_all(result) 
-                */
-                free(result->students);
-                free(result);
-                return NULL;
-            }
+    size_t matches_num = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (0 == distance(collection->students + i, arg)) {
+            result->positions[matches_num++] = i;
         }
     }
+    return stv_truncate(result, matches_num);
+}
+
+/**
+ * Turns view into a borrowing subarray, view is destroyed
+*/
+static students_array* st_array_from_view(students_view* view) {
+    if (NULL == view) {
+        return NULL;
+    }
+    students_array* result = stv_to_array(view);
+    stv_destroy(&view);
     return result;
 }
 
+students_array* st_find_all_closest_any(
+                                const students_array* collection, 
+                                int (*distance)(const student*, const void*), 
+                                const void* arg) {
+    return st_array_from_view(st_view_all_closest_any(collection, distance, arg));
+}
+
+students_array* st_find_all_exact_any(
+                                const students_array* collection, 
+                                int (*distance)(const student*, const void*), 
+                                const void* arg) {
+    return st_array_from_view(st_view_all_exact_any(collection, distance, arg));
+}
+
 static int st_distance_surname(const student* student, const void* value) {
     assert(NULL != student);
     assert(NULL != value);
@@ -504,6 +1801,9 @@ student* st_find_one_exact_surname(const students_array* collection,
                                    const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_SURNAME)) {
+        return st_sorted_find_one_exact(collection, value);
+    }
     return st_find_one_exact_any(collection, st_distance_surname, value);
 }
 
@@ -517,6 +1817,12 @@ static int st_distance_grade_book_num(const student* student, const void* value)
 student* st_find_one_closest_grade_book_num(const students_array* collection, 
                                             size_t value) {
     assert(NULL != collection);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_GRADE_BOOK_NUM) && 
+        (0 != collection->students_num) && (INT_MAX >= value)) {
+        size_t ranges[2][2];
+        st_sorted_closest_grade_book_num(collection, (int) value, ranges);
+        return collection->students + ranges[0][0];
+    }
     size_t saved_val = value;
     return st_find_one_closest_any(collection, st_distance_grade_book_num, &saved_val);
 }
@@ -524,6 +1830,28 @@ student* st_find_one_closest_grade_book_num(const students_array* collection,
 student* st_find_one_exact_grade_book_num(const students_array* collection, 
                                           size_t value) {
     assert(NULL != collection);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_GRADE_BOOK_NUM) && 
+        (INT_MAX >= value)) {
+        int int_value = (int) value;
+        return st_sorted_find_one_exact(collection, &int_value);
+    }
+    if (NULL != collection->gb_index) {
+        if (INT_MAX < value) {
+            return NULL;
+        }
+        // First in array order is needed, so all matches are checked
+        size_t first_pos = GBI_NOT_FOUND;
+        size_t cursor = 0;
+        size_t pos = GBI_NOT_FOUND;
+        while (GBI_NOT_FOUND != 
+               (pos = gbi_lookup(collection->gb_index, (int) value, &cursor))) {
+            if (pos < first_pos) {
+                first_pos = pos;
+            }
+        }
+        return (GBI_NOT_FOUND == first_pos) ? 
+            NULL : collection->students + first_pos;
+    }
     size_t saved_val = value;
     return st_find_one_exact_any(collection, st_distance_grade_book_num, &saved_val);
 }
@@ -535,6 +1863,17 @@ static int st_distance_faculty(const student* student, const void* value) {
     return abs(strcmp(student->faculty, faculty));
 }
 
+/**
+ * 'value' must be interned into collection's dictionary,
+ *  then equal strings are equal pointers
+*/
+static int st_distance_faculty_interned(const student* student, 
+                                        const void* value) {
+    assert(NULL != student);
+    assert(NULL != value);
+    return (student->faculty != (const char*) value);
+}
+
 student* st_find_one_closest_faculty(const students_array* collection, 
                                      const char* value) {
     assert(NULL != collection);
@@ -546,6 +1885,17 @@ student* st_find_one_exact_faculty(const students_array* collection,
                                    const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_FACULTY)) {
+        return st_sorted_find_one_exact(collection, value);
+    }
+    if (NULL != collection->faculty_dict) {
+        const char* interned = sd_find(collection->faculty_dict, value);
+        if (NULL == interned) {
+            return NULL;
+        }
+        return st_find_one_exact_any(collection, st_distance_faculty_interned, 
+                                     interned);
+    }
     return st_find_one_exact_any(collection, st_distance_faculty, value);
 }
 
@@ -556,6 +1906,17 @@ static int st_distance_group(const student* student, const void* value) {
     return abs(strcmp(student->group, group));
 }
 
+/**
+ * 'value' must be interned into collection's dictionary,
+ *  then equal strings are equal pointers
+*/
+static int st_distance_group_interned(const student* student, 
+                                      const void* value) {
+    assert(NULL != student);
+    assert(NULL != value);
+    return (student->group != (const char*) value);
+}
+
 student* st_find_one_closest_group(const students_array* collection, 
                                      const char* value) {
     assert(NULL != collection);
@@ -567,63 +1928,207 @@ student* st_find_one_exact_group(const students_array* collection,
                                    const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_GROUP)) {
+        return st_sorted_find_one_exact(collection, value);
+    }
+    if (NULL != collection->group_dict) {
+        const char* interned = sd_find(collection->group_dict, value);
+        if (NULL == interned) {
+            return NULL;
+        }
+        return st_find_one_exact_any(collection, st_distance_group_interned, 
+                                     interned);
+    }
     return st_find_one_exact_any(collection, st_distance_group, value);
 }
 
-students_array* st_find_all_closest_surname(const students_array* collection, 
-                                            const char* value) {
+students_view* st_view_all_closest_surname(const students_array* collection, 
+                                           const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
-    return st_find_all_closest_any(collection, st_distance_surname, value);
+    return st_view_all_closest_any(collection, st_distance_surname, value);
 }
 
-students_array* st_find_all_exact_surname(const students_array* collection, 
-                                          const char* value) {
+students_view* st_view_all_exact_surname(const students_array* collection, 
+                                         const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
-    return st_find_all_exact_any(collection, st_distance_surname, value);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_SURNAME)) {
+        return st_sorted_view_all_exact(collection, value);
+    }
+    return st_view_all_exact_any(collection, st_distance_surname, value);
 }
 
-students_array* st_find_all_closest_grade_book_num(const students_array* collection, 
-                                                   size_t value) {
+students_view* st_view_all_closest_grade_book_num(
+                                        const students_array* collection, 
+                                        size_t value) {
     assert(NULL != collection);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_GRADE_BOOK_NUM) && 
+        (0 != collection->students_num) && (INT_MAX >= value)) {
+        size_t ranges[2][2];
+        st_sorted_closest_grade_book_num(collection, (int) value, ranges);
+        students_view* result = stv_new(collection, 
+                                        (ranges[0][1] - ranges[0][0]) + 
+                                        (ranges[1][1] - ranges[1][0]));
+        if (NULL == result) {
+            return NULL;
+        }
+        size_t matches_added = 0;
+        for (size_t i = 0; i < 2; ++i) {
+            for (size_t pos = ranges[i][0]; pos < ranges[i][1]; ++pos) {
+                result->positions[matches_added++] = pos;
+            }
+        }
+        return result;
+    }
     size_t saved_val = value;
-    return st_find_all_closest_any(collection, st_distance_grade_book_num, &saved_val);
+    return st_view_all_closest_any(collection, st_distance_grade_book_num, &saved_val);
 }
 
-students_array* st_find_all_exact_grade_book_num(const students_array* collection, 
-                                                 size_t value) {
+static int st_comparator_size_t_asc(const void* arg1, const void* arg2) {
+    assert(NULL != arg1);
+    assert(NULL != arg2);
+    size_t val1 = *((const size_t*) arg1);
+    size_t val2 = *((const size_t*) arg2);
+    return (val1 > val2) - (val1 < val2);
+}
+
+/**
+ * Collects matches found in grade book index in array order.
+ * Matches are counted first, so view is allocated once
+*/
+static students_view* st_view_indexed_grade_book_num(
+                                        const students_array* collection, 
+                                        int value) {
+    assert(NULL != collection);
+    assert(NULL != collection->gb_index);
+    size_t matches_num = 0;
+    size_t cursor = 0;
+    while (GBI_NOT_FOUND != gbi_lookup(collection->gb_index, value, &cursor)) {
+        matches_num++;
+    }
+    students_view* result = stv_new(collection, matches_num);
+    if ((NULL == result) || (0 == matches_num)) {
+        return result;
+    }
+    cursor = 0;
+    for (size_t i = 0; i < matches_num; ++i) {
+        result->positions[i] = gbi_lookup(collection->gb_index, value, &cursor);
+    }
+    qsort(result->positions, matches_num, sizeof(*(result->positions)), 
+          st_comparator_size_t_asc);
+    return result;
+}
+
+students_view* st_view_all_exact_grade_book_num(
+                                        const students_array* collection, 
+                                        size_t value) {
     assert(NULL != collection);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_GRADE_BOOK_NUM) && 
+        (INT_MAX >= value)) {
+        int int_value = (int) value;
+        return st_sorted_view_all_exact(collection, &int_value);
+    }
+    if (NULL != collection->gb_index) {
+        if (INT_MAX < value) {
+            return stv_new(collection, 0);
+        }
+        return st_view_indexed_grade_book_num(collection, (int) value);
+    }
     size_t saved_val = value;
-    return st_find_all_exact_any(collection, st_distance_grade_book_num, &saved_val);
+    return st_view_all_exact_any(collection, st_distance_grade_book_num, &saved_val);
 }
 
-students_array* st_find_all_closest_faculty(const students_array* collection, 
-                                     const char* value) {
+students_view* st_view_all_closest_faculty(const students_array* collection, 
+                                           const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
-    return st_find_all_closest_any(collection, st_distance_faculty, value);
+    return st_view_all_closest_any(collection, st_distance_faculty, value);
 }
 
-students_array* st_find_all_exact_faculty(const students_array* collection, 
-                                   const char* value) {
+students_view* st_view_all_exact_faculty(const students_array* collection, 
+                                         const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
-    return st_find_all_exact_any(collection, st_distance_faculty, value);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_FACULTY)) {
+        return st_sorted_view_all_exact(collection, value);
+    }
+    if (NULL != collection->faculty_dict) {
+        const char* interned = sd_find(collection->faculty_dict, value);
+        if (NULL == interned) {
+            return stv_new(collection, 0);
+        }
+        return st_view_all_exact_any(collection, st_distance_faculty_interned, 
+                                     interned);
+    }
+    return st_view_all_exact_any(collection, st_distance_faculty, value);
 }
 
-students_array* st_find_all_closest_group(const students_array* collection, 
-                                     const char* value) {
+students_view* st_view_all_closest_group(const students_array* collection, 
+                                         const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
-    return st_find_all_closest_any(collection, st_distance_group, value);
+    return st_view_all_closest_any(collection, st_distance_group, value);
 }
 
-students_array* st_find_all_exact_group(const students_array* collection, 
-                                   const char* value) {
+students_view* st_view_all_exact_group(const students_array* collection, 
+                                       const char* value) {
     assert(NULL != collection);
     assert(NULL != value);
-    return st_find_all_exact_any(collection, st_distance_group, value);
+    if (st_is_sorted_by(collection, STS_SORTED_BY_GROUP)) {
+        return st_sorted_view_all_exact(collection, value);
+    }
+    if (NULL != collection->group_dict) {
+        const char* interned = sd_find(collection->group_dict, value);
+        if (NULL == interned) {
+            return stv_new(collection, 0);
+        }
+        return st_view_all_exact_any(collection, st_distance_group_interned, 
+                                     interned);
+    }
+    return st_view_all_exact_any(collection, st_distance_group, value);
+}
+
+students_array* st_find_all_closest_surname(const students_array* collection, 
+                                            const char* value) {
+    return st_array_from_view(st_view_all_closest_surname(collection, value));
+}
+
+students_array* st_find_all_exact_surname(const students_array* collection, 
+                                          const char* value) {
+    return st_array_from_view(st_view_all_exact_surname(collection, value));
+}
+
+students_array* st_find_all_closest_grade_book_num(const students_array* collection, 
+                                                   size_t value) {
+    return st_array_from_view(st_view_all_closest_grade_book_num(collection, 
+                                                                 value));
+}
+
+students_array* st_find_all_exact_grade_book_num(const students_array* collection, 
+                                                 size_t value) {
+    return st_array_from_view(st_view_all_exact_grade_book_num(collection, 
+                                                               value));
+}
+
+students_array* st_find_all_closest_faculty(const students_array* collection, 
+                                            const char* value) {
+    return st_array_from_view(st_view_all_closest_faculty(collection, value));
+}
+
+students_array* st_find_all_exact_faculty(const students_array* collection, 
+                                          const char* value) {
+    return st_array_from_view(st_view_all_exact_faculty(collection, value));
+}
+
+students_array* st_find_all_closest_group(const students_array* collection, 
+                                          const char* value) {
+    return st_array_from_view(st_view_all_closest_group(collection, value));
+}
+
+students_array* st_find_all_exact_group(const students_array* collection, 
+                                        const char* value) {
+    return st_array_from_view(st_view_all_exact_group(collection, value));
 }
 
 /***************** End of search functions *****************/
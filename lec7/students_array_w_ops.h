@@ -4,11 +4,16 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include "students_array_struct.h"
+#include "students_reducer_struct.h"
+#include "students_view_struct.h"
 
 enum students_array_ops_return_codes {
     STS_MEM_ALLOC_ERROR = 1,
     STS_READING_INPUT_ERROR,
     ST_INVALID_DATA,
+    STS_IO_ERROR,
+    STS_BAD_SNAPSHOT,
+    STS_SNAPSHOT_TOO_BIG,
 };
 
 /**
@@ -19,22 +24,133 @@ enum students_array_ops_return_codes {
 */
 students_array* st_new_array(size_t initial_capacity);
 
+/**
+ * Same as st_new_array(), but collection works in arena mode:
+ *  all strings are copied into big contiguous chunks owned by collection,
+ *  so they are freed all at once by sts_destroy_all()
+ *  and entries' strings lie close to each other in memory.
+ * Strings of deleted or replaced entries are not reclaimed until then
+*/
+students_array* st_new_array_arena(size_t initial_capacity);
+
+/**
+ * Same as st_new_array(), but collection never frees entries' strings,
+ *  they are owned by somebody else
+ *  (st_find_all* functions return such collections).
+ * sts_destroy_all() is safe to call on it: only the buffer is freed
+*/
+students_array* st_new_array_borrowing(size_t initial_capacity);
+
+/**
+ * Ownership of entry's strings depends on collection's mode:
+ *  - default: collection takes ownership of malloc()'ed strings
+ *  - arena: strings are copied, caller keeps ownership of its own ones
+ *  - borrowing: pointers are stored as is, nobody frees them here
+ * Buffer grows geometrically, so a series of st_add() calls
+ *  costs amortized O(1) per call
+*/
 int st_add(students_array* collection, student entry);
 
+/**
+ * Appends 'n' entries from 'entries' with at most one reallocation,
+ *  takes ownership of their strings just like st_add()
+ * On failure nothing is appended and no strings of 'entries' are freed
+*/
+int st_add_bulk(students_array* collection, const student* entries, size_t n);
+
+/**
+ * Same as st_add_bulk(), but entries' strings are copied
+ *  (or interned) by collection, caller keeps its own ones.
+ * Not applicable to borrowing collections
+*/
+int st_add_bulk_copy(students_array* collection, const student* entries, 
+                     size_t n);
+
+/**
+ * Makes capacity at least 'capacity', never shrinks the buffer
+*/
+int st_reserve(students_array* collection, size_t capacity);
+
+/**
+ * Reduces capacity to students_num (buffer is freed if collection is empty)
+*/
+int st_shrink_to_fit(students_array* collection);
+
+/**
+ * Turns on dictionary encoding of 'faculty' and 'group':
+ *  every distinct value is stored once per collection 
+ *  and entries point to the shared copy.
+ *  Originals are freed if collection owns strings.
+ * Dictionaries keep values ordered, so sorting and exact search
+ *  by these fields compare small integer codes instead of calling strcmp().
+ * After this call 'faculty' and 'group' of stored entries
+ *  must not be reassigned directly, only through st_* functions.
+ * Returns 0 or STS_MEM_ALLOC_ERROR (collection is unchanged then)
+*/
+int st_enable_dictionary(students_array* collection);
+
+/**
+ * Builds open-addressing hash index on grade_book_num.
+ * st_add*(), st_del_where(), st_replace_where() and sorts keep it up to date,
+ *  st_find_*_exact_grade_book_num() use it instead of linear scan.
+ * If index cannot be updated because memory allocation fails, it is dropped
+ *  (lookups keep working, just slower)
+ * Returns 0 or STS_MEM_ALLOC_ERROR
+*/
+int st_build_grade_book_index(students_array* collection);
+
+void st_drop_grade_book_index(students_array* collection);
+
 /**
  * After freeing data, sets *collection to NULL
 */
 void sts_destroy_all(students_array** collection);
 
+/**
+ * Deletes the first entry where predicate(entry) is true
+*/
 void st_del_where(students_array* collection, bool (*predicate)(const student*));
 
+/**
+ * Deletes all entries where predicate(entry) is true in a single pass,
+ *  keeping the order of the rest. Returns number of deleted entries
+*/
+size_t st_del_all_where(students_array* collection, 
+                        bool (*predicate)(const student*));
+
+/**
+ * Same as st_del_all_where(), but predicate gets 'ctx' as second argument,
+ *  so it can be parameterized without global variables
+*/
+size_t st_del_all_where_ctx(students_array* collection, 
+                            bool (*predicate)(const student*, const void*), 
+                            const void* ctx);
+
 /**
  * Replaces all entries where predicate(entry) is true
+ * Strings of new_entry are handed over just like to st_add():
+ *  owning collection takes them (and frees them right away 
+ *  if nothing matches), the first replaced entry gets them 
+ *  and every further one gets its own copy; in arena mode they are 
+ *  copied once and shared by all replaced entries.
+ * Returns 0 or STS_MEM_ALLOC_ERROR. If nothing was replaced then, 
+ *  new_entry's strings are still caller's, otherwise entries replaced 
+ *  before the failure keep new values and the strings belong to collection
 */
-void st_replace_where(students_array* collection, 
+int st_replace_where(students_array* collection, 
                      bool (*predicate)(const student*),
                      student new_entry);
 
+/**
+ * Same as st_replace_where(), but predicate gets 'ctx' as second argument
+*/
+int st_replace_where_ctx(students_array* collection, 
+                         bool (*predicate)(const student*, const void*), 
+                         const void* ctx, student new_entry);
+
+/**
+ * Not applicable to borrowing collections
+*/
 int st_interactive_add(students_array* collection, FILE* istream, FILE* ostream);
 
 void sts_formatted_print_all(const students_array* collection, FILE* ostream);
@@ -47,27 +163,92 @@ void sts_formatted_print_all(const students_array* collection, FILE* ostream);
 void* sts_fold(students_array* collection, 
                 void* operation(const student*, void*));
 
+/**
+ * Typed, parallel alternative to sts_fold():
+ *  collection is split into 'threads_num' chunks 
+ *  ('threads_num' == 0 means "one per CPU"), every chunk is folded 
+ *  with reducer->step starting from a copy of reducer->init 
+ *  on the shared thread pool, then partial results are merged 
+ *  with reducer->combine in chunk order. Result is written to 'result'
+ *  (reducer->acc_size bytes). 
+ * Small collections are reduced serially without any allocations.
+ * Aggregates read often are cheaper to keep up to date on every change,
+ *  see students_aggregates_w_ops.h.
+ * Returns 0 or STS_MEM_ALLOC_ERROR
+*/
+int sts_reduce(const students_array* collection, 
+               const students_reducer* reducer, void* result, 
+               size_t threads_num);
+
 /*************** Beginning of sort functions ***************/
 
 /** 
  * comparator()'s arg type is 'const void*' and not 'const student*'
  *  in order to match libc's qsort() definition
 */
-void sts_sort_any(const students_array* collection, 
+void sts_sort_any(students_array* collection, 
                   int (*comparator)(const void*, const void*));
 
+/**
+ * Same as sts_sort_any(), but chunks of collection are sorted 
+ *  by 'threads_num' threads and then merged 
+ *  ('threads_num' == 0 means "one per CPU").
+ * Small collections are sorted serially, as well as when 
+ *  threads or a temporary buffer of collection's size are not available.
+ * sts_sort_any() uses it with one thread per CPU
+*/
+void sts_sort_any_parallel(students_array* collection, 
+                           int (*comparator)(const void*, const void*), 
+                           size_t threads_num);
+
 /**
  * Some predefined sorts by field for convenience
  * For strings order is determined by strcmp() implementation 
+ * Collection remembers the key and direction it was sorted by
+ *  (see 'sort_key' field), until st_add*() or st_replace_where() break it.
+ *  While it is known, st_find_*_exact_* by that key 
+ *  and st_find_*_closest_grade_book_num() use binary search.
+ *  Closest searches by strings can't: strcmp() distance is not monotonic
+ *  in sorted order
 */
-void sts_sort_surname_asc(const students_array* collection);
-void sts_sort_surname_desc(const students_array* collection);
-void sts_sort_grade_book_num_asc(const students_array* collection);
-void sts_sort_grade_book_num_desc(const students_array* collection);
-void sts_sort_faculty_asc(const students_array* collection);
-void sts_sort_faculty_desc(const students_array* collection);
-void sts_sort_group_asc(const students_array* collection);
-void sts_sort_group_desc(const students_array* collection);
+void sts_sort_surname_asc(students_array* collection);
+void sts_sort_surname_desc(students_array* collection);
+void sts_sort_grade_book_num_asc(students_array* collection);
+void sts_sort_grade_book_num_desc(students_array* collection);
+void sts_sort_faculty_asc(students_array* collection);
+void sts_sort_faculty_desc(students_array* collection);
+void sts_sort_group_asc(students_array* collection);
+void sts_sort_group_desc(students_array* collection);
+
+/**
+ * Radix sort variants of predefined sorts: LSD radix sort for grade_book_num
+ *  (and for faculty/group dictionary codes, see st_enable_dictionary()), 
+ *  MSD radix sort for strings. No comparator calls are made.
+ * Predefined sorts above switch to them for big collections automatically.
+ * If temporary buffers cannot be allocated, they fall back to 
+ *  comparison sort
+*/
+void sts_sort_surname_radix_asc(students_array* collection);
+void sts_sort_surname_radix_desc(students_array* collection);
+void sts_sort_grade_book_num_radix_asc(students_array* collection);
+void sts_sort_grade_book_num_radix_desc(students_array* collection);
+void sts_sort_faculty_radix_asc(students_array* collection);
+void sts_sort_faculty_radix_desc(students_array* collection);
+void sts_sort_group_radix_asc(students_array* collection);
+void sts_sort_group_radix_desc(students_array* collection);
+
+#define STS_MAX_SORT_KEYS 4
+
+/**
+ * Sorts by keys[0], entries equal by it by keys[1] and so on
+ *  (e.g. by faculty, then group, then surname), every key 
+ *  in its own direction. Whole chain is compared inline 
+ *  by an introsort kernel, without comparator calls through pointers.
+ * At most STS_MAX_SORT_KEYS keys, none of them STS_NOT_SORTED.
+ * Collection remembers keys[0] as its sort key
+*/
+void sts_sort_multi_key(students_array* collection, 
+                        const students_sort_spec* keys, size_t keys_num);
 
 /****************** End of sort functions ******************/
 
@@ -99,6 +280,11 @@ student* st_find_one_exact_any(const students_array* collection,
  * st_find_all* functions' only difference is that they return
  *  students_array* - subarray of matching elements 
  *  instead of the first occuring one.
+ * Subarray borrows strings from 'collection' (see st_new_array_borrowing()),
+ *  so it has to be destroyed with sts_destroy_all() 
+ *  before 'collection' entries are deleted or replaced.
+ * NULL is returned if memory allocation fails.
+ * st_view_all* functions below find the same entries without copying them
 */
 students_array* st_find_all_closest_any(
                                 const students_array* collection, 
@@ -121,6 +307,8 @@ students_array* st_find_all_exact_any(
  *   due to the fact that in ASCII all capital letters precede all usual ones.
  *  However, the task does not specify certain way of distance calculation,
  *   so I consider it normal.
+ *  Edit-distance surname search is in surname_trigram_index_w_ops.h.
+ *  Prefix and range search on surname is in surname_sorted_index_w_ops.h.
  * 
 */
 student* st_find_one_closest_surname(const students_array* collection, 
@@ -159,6 +347,40 @@ students_array* st_find_all_closest_group(const students_array* collection,
 students_array* st_find_all_exact_group(const students_array* collection, 
                                         const char* value);
 
+/**
+ * Same as st_find_all* functions, but return view of 'collection'
+ *  (see students_view_struct.h): positions of matches in array order,
+ *  allocated at once after matches are counted.
+ * View is freed with stv_destroy(), 'collection' is never touched by it.
+ * NULL is returned if memory allocation fails
+*/
+students_view* st_view_all_closest_any(
+                                const students_array* collection, 
+                                int (*distance)(const student*, const void*), 
+                                const void* arg);
+students_view* st_view_all_exact_any(
+                                const students_array* collection, 
+                                int (*distance)(const student*, const void*), 
+                                const void* arg);
+
+students_view* st_view_all_closest_surname(const students_array* collection, 
+                                           const char* value);
+students_view* st_view_all_exact_surname(const students_array* collection, 
+                                         const char* value);
+students_view* st_view_all_closest_grade_book_num(
+                                        const students_array* collection, 
+                                        size_t value);
+students_view* st_view_all_exact_grade_book_num(
+                                        const students_array* collection, 
+                                        size_t value);
+students_view* st_view_all_closest_faculty(const students_array* collection, 
+                                           const char* value);
+students_view* st_view_all_exact_faculty(const students_array* collection, 
+                                         const char* value);
+students_view* st_view_all_closest_group(const students_array* collection, 
+                                         const char* value);
+students_view* st_view_all_exact_group(const students_array* collection, 
+                                       const char* value);
 
 /***************** End of search functions *****************/
 
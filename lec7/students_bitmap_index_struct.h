@@ -0,0 +1,36 @@
+#ifndef STUDENTS_BITMAP_INDEX_STRUCT_H
+#define STUDENTS_BITMAP_INDEX_STRUCT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "students_array_struct.h"
+
+/**
+ * Columns with more distinct values than that are not indexed
+*/
+#define SBI_MAX_VALUES 256
+
+/**
+ * Bitmap of every distinct value of a string field: 
+ *  bit p of bitmaps[i] (word p / 64, bit p % 64) is set
+ *  if entry p has values[i]
+*/
+typedef struct students_bitmap_column {
+    char** values; // Copies, ascending
+    uint64_t** bitmaps;
+    size_t values_num;
+    bool overflow; // Too many distinct values, column is not indexed
+} students_bitmap_column;
+
+typedef struct students_bitmap_index {
+    students_array* collection;
+    bool built;
+    size_t generation; // collection->generation index was built for
+    size_t indexed_num; // Entries before that are in bitmaps
+    size_t words_capacity; // Every bitmap has room for that many words
+    students_bitmap_column faculty;
+    students_bitmap_column group;
+} students_bitmap_index;
+
+#endif
@@ -0,0 +1,419 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "students_bitmap_index_w_ops.h"
+#include "students_filter_w_ops.h"
+#include "students_array_w_ops.h"
+#include "students_view_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define SBI_WORD_BITS 64
+#define SBI_INITIAL_WORDS_NUM 16
+
+static size_t sbi_words_num(size_t entries_num) {
+    return (entries_num + SBI_WORD_BITS - 1) / SBI_WORD_BITS;
+}
+
+/******************** Columns ********************/
+
+static void sbi_free_column(students_bitmap_column* column) {
+    for (size_t i = 0; i < column->values_num; ++i) {
+        free(column->values[i]);
+        free(column->bitmaps[i]);
+    }
+    free(column->values);
+    free(column->bitmaps);
+    column->values = NULL;
+    column->bitmaps = NULL;
+    column->values_num = 0;
+    column->overflow = false;
+}
+
+static void sbi_free_columns(students_bitmap_index* index) {
+    sbi_free_column(&index->faculty);
+    sbi_free_column(&index->group);
+    index->words_capacity = 0;
+    index->indexed_num = 0;
+}
+
+static const char* sbi_field(const student* entry, enum students_filter_op op) {
+    return (STF_FACULTY_EQ == op) ? entry->faculty : entry->group;
+}
+
+/**
+ * Position of the first value not less than 'str'
+*/
+static size_t sbi_lower_bound(const students_bitmap_column* column, 
+                              const char* str) {
+    size_t left = 0;
+    size_t right = column->values_num;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        if (0 > strcmp(column->values[mid], str)) {
+            left = mid + 1;
+        }
+        else {
+            right = mid;
+        }
+    }
+    return left;
+}
+
+/**
+ * Bitmap of 'str' or NULL if no entry has it
+*/
+static const uint64_t* sbi_find_bitmap(const students_bitmap_column* column, 
+                                       const char* str) {
+    size_t i = sbi_lower_bound(column, str);
+    if ((i == column->values_num) || (0 != strcmp(column->values[i], str))) {
+        return NULL;
+    }
+    return column->bitmaps[i];
+}
+
+static bool sbi_insert_value(students_bitmap_column* column, size_t pos, 
+                             const char* str, size_t words_capacity) {
+    if (NULL == column->values) {
+        column->values = (char**) malloc(sizeof(char*) * SBI_MAX_VALUES);
+    }
+    if (NULL == column->bitmaps) {
+        column->bitmaps = (uint64_t**) malloc(sizeof(uint64_t*) * SBI_MAX_VALUES);
+    }
+    if ((NULL == column->values) || (NULL == column->bitmaps)) {
+        return false;
+    }
+    char* value = strdup(str);
+    uint64_t* bitmap = (uint64_t*) calloc(words_capacity, sizeof(*bitmap));
+    if ((NULL == value) || (NULL == bitmap)) {
+        free(value);
+        free(bitmap);
+        return false;
+    }
+    size_t tail = column->values_num - pos;
+    memmove(column->values + pos + 1, column->values + pos, sizeof(char*) * tail);
+    memmove(column->bitmaps + pos + 1, column->bitmaps + pos, 
+            sizeof(uint64_t*) * tail);
+    column->values[pos] = value;
+    column->bitmaps[pos] = bitmap;
+    column->values_num++;
+    return true;
+}
+
+/**
+ * Sets bits of entries [from, to) in bitmaps of their values.
+ *  Column with too many values is dropped and marked as overflown
+*/
+static bool sbi_add_entries(students_bitmap_index* index, 
+                            students_bitmap_column* column, 
+                            enum students_filter_op op, size_t from, size_t to) {
+    const student* students = index->collection->students;
+    const char* last_str = NULL;
+    size_t last_pos = 0;
+    for (size_t p = from; (p < to) && !column->overflow; ++p) {
+        const char* str = sbi_field(students + p, op);
+        // Dictionary-enabled collections repeat pointers, not just values
+        if ((NULL == last_str) || (str != last_str)) {
+            last_pos = sbi_lower_bound(column, str);
+            if ((last_pos == column->values_num) || 
+                (0 != strcmp(column->values[last_pos], str))) {
+                if (SBI_MAX_VALUES == column->values_num) {
+                    sbi_free_column(column);
+                    column->overflow = true;
+                    break;
+                }
+                if (!sbi_insert_value(column, last_pos, str, 
+                                      index->words_capacity)) {
+                    return false;
+                }
+            }
+            last_str = str;
+        }
+        column->bitmaps[last_pos][p / SBI_WORD_BITS] |= 
+            (uint64_t) 1 << (p % SBI_WORD_BITS);
+    }
+    return true;
+}
+
+static bool sbi_reserve_words(students_bitmap_index* index, size_t words_num) {
+    if (words_num <= index->words_capacity) {
+        return true;
+    }
+    size_t new_capacity = (0 == index->words_capacity) ? 
+        SBI_INITIAL_WORDS_NUM : index->words_capacity * 2;
+    if (new_capacity < words_num) {
+        new_capacity = words_num;
+    }
+    students_bitmap_column* columns[2] = {&index->faculty, &index->group};
+    for (size_t c = 0; c < 2; ++c) {
+        for (size_t i = 0; i < columns[c]->values_num; ++i) {
+            uint64_t* bitmap = (uint64_t*)
+                realloc(columns[c]->bitmaps[i], sizeof(*bitmap) * new_capacity);
+            if (NULL == bitmap) {
+                return false;
+            }
+            memset(bitmap + index->words_capacity, 0, 
+                   sizeof(*bitmap) * (new_capacity - index->words_capacity));
+            columns[c]->bitmaps[i] = bitmap;
+        }
+    }
+    index->words_capacity = new_capacity;
+    return true;
+}
+
+/**
+ * Rebuilds index if it is stale, then adds appended entries.
+ *  Returns nonzero if memory allocation fails, index is rebuilt next time
+*/
+static int sbi_refresh(students_bitmap_index* index) {
+    const students_array* collection = index->collection;
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    if (!index->built || (index->generation != collection->generation)) {
+        sbi_free_columns(index);
+        index->generation = collection->generation;
+        index->built = true;
+    }
+    if (index->indexed_num == n) {
+        return 0;
+    }
+    if (!sbi_reserve_words(index, sbi_words_num(n)) || 
+        !sbi_add_entries(index, &index->faculty, STF_FACULTY_EQ, 
+                         index->indexed_num, n) || 
+        !sbi_add_entries(index, &index->group, STF_GROUP_EQ, 
+                         index->indexed_num, n)) {
+        sbi_free_columns(index);
+        index->built = false;
+        return STS_MEM_ALLOC_ERROR;
+    }
+    index->indexed_num = n;
+    return 0;
+}
+
+students_bitmap_index* sbi_new(students_array* collection) {
+    assert(NULL != collection);
+    students_bitmap_index* index = (students_bitmap_index*) malloc(sizeof(*index));
+    if (NULL == index) {
+        return NULL;
+    }
+    memset(index, 0, sizeof(*index));
+    index->collection = collection;
+    if (0 != sbi_refresh(index)) {
+        sbi_destroy(&index);
+    }
+    return index;
+}
+
+void sbi_destroy(students_bitmap_index** index) {
+    assert(NULL != index);
+    if (NULL == *index) {
+        return;
+    }
+    sbi_free_columns(*index);
+    free(*index);
+    *index = NULL;
+}
+
+/******************** Filter evaluation ********************/
+
+/**
+ * Indexed column term 'instr' is over, NULL for other terms
+*/
+static const students_bitmap_column* sbi_column_of(
+        const students_bitmap_index* index, const students_filter_instr* instr) {
+    const students_bitmap_column* column = NULL;
+    if (STF_FACULTY_EQ == instr->op) {
+        column = &index->faculty;
+    }
+    else if (STF_GROUP_EQ == instr->op) {
+        column = &index->group;
+    }
+    return ((NULL == column) || column->overflow) ? NULL : column;
+}
+
+static void sbi_eval_term(const students_bitmap_index* index, 
+                          const students_filter_instr* instr, uint64_t* dst, 
+                          size_t n) {
+    size_t words_num = sbi_words_num(n);
+    const students_bitmap_column* column = sbi_column_of(index, instr);
+    if (NULL != column) {
+        const uint64_t* bitmap = sbi_find_bitmap(column, instr->value);
+        if (NULL == bitmap) {
+            memset(dst, 0, sizeof(*dst) * words_num);
+        }
+        else {
+            memcpy(dst, bitmap, sizeof(*dst) * words_num);
+        }
+        return;
+    }
+    const student* students = index->collection->students;
+    for (size_t w = 0; w < words_num; ++w) {
+        size_t base = w * SBI_WORD_BITS;
+        size_t bits_num = (n - base < SBI_WORD_BITS) ? n - base : SBI_WORD_BITS;
+        uint64_t word = 0;
+        for (size_t b = 0; b < bits_num; ++b) {
+            word |= (uint64_t) stf_term_matches(instr, students + base + b) << b;
+        }
+        dst[w] = word;
+    }
+}
+
+/**
+ * dst &= term: unindexed terms are checked only for bits still set
+*/
+static void sbi_and_term(const students_bitmap_index* index, 
+                         const students_filter_instr* instr, uint64_t* dst, 
+                         size_t n) {
+    size_t words_num = sbi_words_num(n);
+    const students_bitmap_column* column = sbi_column_of(index, instr);
+    if (NULL != column) {
+        const uint64_t* bitmap = sbi_find_bitmap(column, instr->value);
+        for (size_t w = 0; w < words_num; ++w) {
+            dst[w] = (NULL == bitmap) ? 0 : (dst[w] & bitmap[w]);
+        }
+        return;
+    }
+    const student* students = index->collection->students;
+    for (size_t w = 0; w < words_num; ++w) {
+        uint64_t word = dst[w];
+        for (uint64_t bits = word; 0 != bits; bits &= bits - 1) {
+            int b = __builtin_ctzll(bits);
+            if (!stf_term_matches(instr, students + w * SBI_WORD_BITS + b)) {
+                word &= ~((uint64_t) 1 << b);
+            }
+        }
+        dst[w] = word;
+    }
+}
+
+/**
+ * Returns malloc()'ed bitmap of entries matching filter, 
+ *  NULL if memory allocation fails
+*/
+static uint64_t* sbi_eval(students_bitmap_index* index, 
+                          const students_filter* filter) {
+    assert(NULL != index);
+    assert(NULL != filter);
+    assert(stf_is_complete(filter));
+    if (0 != sbi_refresh(index)) {
+        return NULL;
+    }
+    size_t n = index->indexed_num;
+    size_t words_num = sbi_words_num(n);
+    // Room for every stack level, result ends up in the first one
+    uint64_t* stack = (uint64_t*)
+        malloc(sizeof(*stack) * ((0 == words_num) ? 1 : words_num) *
+               filter->max_depth);
+    if (NULL == stack) {
+        return NULL;
+    }
+    size_t depth = 0;
+    for (size_t i = 0; i < filter->instrs_num; ++i) {
+        const students_filter_instr* instr = filter->instrs + i;
+        uint64_t* top = (0 == depth) ? NULL : stack + (depth - 1) * words_num;
+        switch (instr->op) {
+            case STF_AND:
+                for (size_t w = 0; w < words_num; ++w) {
+                    (top - words_num)[w] &= top[w];
+                }
+                --depth;
+                break;
+            case STF_OR:
+                for (size_t w = 0; w < words_num; ++w) {
+                    (top - words_num)[w] |= top[w];
+                }
+                --depth;
+                break;
+            case STF_NOT:
+                for (size_t w = 0; w < words_num; ++w) {
+                    top[w] = ~top[w];
+                }
+                if (0 != n % SBI_WORD_BITS) {
+                    top[words_num - 1] &= 
+                        ((uint64_t) 1 << (n % SBI_WORD_BITS)) - 1;
+                }
+                break;
+            default:
+                // Term AND'ed right away narrows the top instead of
+                //  being evaluated for everything
+                if ((0 != depth) && (i + 1 < filter->instrs_num) && 
+                    (STF_AND == filter->instrs[i + 1].op)) {
+                    sbi_and_term(index, instr, top, n);
+                    ++i;
+                }
+                else {
+                    sbi_eval_term(index, instr, stack + depth * words_num, n);
+                    ++depth;
+                }
+                break;
+        }
+    }
+    return stack;
+}
+
+/******************** Results ********************/
+
+students_view* sbi_find_all(students_bitmap_index* index, 
+                            const students_filter* filter) {
+    uint64_t* bits = sbi_eval(index, filter);
+    if (NULL == bits) {
+        return NULL;
+    }
+    size_t words_num = sbi_words_num(index->indexed_num);
+    size_t matched_num = 0;
+    for (size_t w = 0; w < words_num; ++w) {
+        matched_num += __builtin_popcountll(bits[w]);
+    }
+    students_view* view = stv_new(index->collection, matched_num);
+    if (NULL != view) {
+        size_t idx = 0;
+        for (size_t w = 0; w < words_num; ++w) {
+            for (uint64_t word = bits[w]; 0 != word; word &= word - 1) {
+                view->positions[idx++] = w * SBI_WORD_BITS + __builtin_ctzll(word);
+            }
+        }
+    }
+    free(bits);
+    return view;
+}
+
+typedef struct sbi_bits {
+    const student* base;
+    const uint64_t* bits;
+} sbi_bits;
+
+static bool sbi_is_set(const student* entry, const void* ctx) {
+    const sbi_bits* bits = (const sbi_bits*) ctx;
+    size_t pos = entry - bits->base;
+    return 0 != (bits->bits[pos / SBI_WORD_BITS] & 
+                 ((uint64_t) 1 << (pos % SBI_WORD_BITS)));
+}
+
+int sbi_del_all_where(students_bitmap_index* index, 
+                      const students_filter* filter, size_t* deleted_num) {
+    assert(NULL != deleted_num);
+    *deleted_num = 0;
+    uint64_t* bits = sbi_eval(index, filter);
+    if (NULL == bits) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    sbi_bits ctx = {index->collection->students, bits};
+    *deleted_num = st_del_all_where_ctx(index->collection, sbi_is_set, &ctx);
+    free(bits);
+    return 0;
+}
+
+int sbi_replace_where(students_bitmap_index* index, 
+                      const students_filter* filter, student new_entry) {
+    uint64_t* bits = sbi_eval(index, filter);
+    if (NULL == bits) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    sbi_bits ctx = {index->collection->students, bits};
+    int result = st_replace_where_ctx(index->collection, sbi_is_set, &ctx, 
+                                      new_entry);
+    free(bits);
+    return result;
+}
@@ -0,0 +1,53 @@
+#ifndef STUDENTS_BITMAP_INDEX_W_OPS_H
+#define STUDENTS_BITMAP_INDEX_W_OPS_H
+
+#include <stddef.h>
+#include "students_bitmap_index_struct.h"
+#include "students_filter_struct.h"
+#include "students_view_struct.h"
+
+/**
+ * Bitmap indexes over low-cardinality fields (faculty and group).
+ * Filters (see students_filter_w_ops.h) are evaluated 64 entries at a time: 
+ *  equality terms over indexed columns are bitmap copies, AND, OR and NOT
+ *  are word-wide operations. Range terms and terms over columns that are
+ *  not indexed check entries one by one, and when such a term is
+ *  AND'ed right away, only entries still matching are checked.
+ * Index doesn't have to be rebuilt by hand: appended entries are added
+ *  to bitmaps before the next query, and after entries are changed, 
+ *  deleted or moved (see 'generation' field of students_array)
+ *  the index is rebuilt.
+ * 'filter' must be complete (see stf_is_complete()) in every function
+*/
+
+/**
+ * Returns NULL if memory allocation fails
+*/
+students_bitmap_index* sbi_new(students_array* collection);
+
+/**
+ * View of matching entries in array order, NULL if memory allocation fails
+*/
+students_view* sbi_find_all(students_bitmap_index* index, 
+                            const students_filter* filter);
+
+/**
+ * Same as st_del_all_where_ctx() with filter as predicate.
+ *  Number of deleted entries goes to *deleted_num.
+ *  Returns 0 or STS_MEM_ALLOC_ERROR (nothing is deleted then)
+*/
+int sbi_del_all_where(students_bitmap_index* index, 
+                      const students_filter* filter, size_t* deleted_num);
+
+/**
+ * Same as st_replace_where_ctx() with filter as predicate
+*/
+int sbi_replace_where(students_bitmap_index* index, 
+                      const students_filter* filter, student new_entry);
+
+/**
+ * Sets *index to NULL after freeing, collection is not touched
+*/
+void sbi_destroy(students_bitmap_index** index);
+
+#endif
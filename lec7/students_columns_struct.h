@@ -0,0 +1,22 @@
+#ifndef STUDENTS_COLUMNS_STRUCT_H
+#define STUDENTS_COLUMNS_STRUCT_H
+
+#include <stddef.h>
+#include "small_string_struct.h"
+
+/**
+ * Columnar (struct of arrays) layout of students collection:
+ *  i-th student is made of i-th elements of all columns.
+ * Scans by grade_book_num read nothing but a contiguous int array.
+ * Strings are small_string, so short values live inside the column
+*/
+typedef struct students_columns {
+    int* grade_book_nums;
+    small_string* surnames;
+    small_string* faculties;
+    small_string* groups;
+    size_t students_num;
+    size_t capacity;
+} students_columns;
+
+#endif
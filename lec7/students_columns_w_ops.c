@@ -0,0 +1,696 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define STC_X86
+#endif
+
+#include "students_columns_w_ops.h"
+#include "students_array_w_ops.h"
+#include "student_w_ops.h"
+#include "small_string_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+students_columns* stc_new(size_t initial_capacity) {
+    students_columns* result = (students_columns*) malloc(sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    result->grade_book_nums = NULL;
+    result->surnames = NULL;
+    result->faculties = NULL;
+    result->groups = NULL;
+    result->students_num = 0;
+    result->capacity = 0;
+    if (0 == initial_capacity) {
+        return result;
+    }
+    result->grade_book_nums = (int*) malloc(sizeof(int) * initial_capacity);
+    result->surnames = (small_string*) 
+        malloc(sizeof(small_string) * initial_capacity);
+    result->faculties = (small_string*) 
+        malloc(sizeof(small_string) * initial_capacity);
+    result->groups = (small_string*) 
+        malloc(sizeof(small_string) * initial_capacity);
+    if (NULL == result->grade_book_nums || NULL == result->surnames || 
+        NULL == result->faculties || NULL == result->groups) {
+        stc_destroy(&result);
+        return NULL;
+    }
+    result->capacity = initial_capacity;
+    return result;
+}
+
+/**
+ * Columns are reallocated one by one, so on failure some of them
+ *  may already be bigger, which is harmless
+*/
+static int stc_grow(students_columns* columns) {
+    size_t new_capacity = (0 == columns->capacity) ? 4 : columns->capacity * 2;
+    if (SIZE_MAX / sizeof(small_string) / 2 < columns->capacity) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    int* grade_book_nums = (int*)
+        realloc(columns->grade_book_nums, sizeof(int) * new_capacity);
+    if (NULL == grade_book_nums) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    columns->grade_book_nums = grade_book_nums;
+    small_string* surnames = (small_string*)
+        realloc(columns->surnames, sizeof(small_string) * new_capacity);
+    if (NULL == surnames) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    columns->surnames = surnames;
+    small_string* faculties = (small_string*)
+        realloc(columns->faculties, sizeof(small_string) * new_capacity);
+    if (NULL == faculties) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    columns->faculties = faculties;
+    small_string* groups = (small_string*)
+        realloc(columns->groups, sizeof(small_string) * new_capacity);
+    if (NULL == groups) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    columns->groups = groups;
+    columns->capacity = new_capacity;
+    return 0;
+}
+
+int stc_add(students_columns* columns, student entry) {
+    assert(NULL != columns);
+    if ((columns->students_num == columns->capacity) && 
+        (0 != stc_grow(columns))) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    size_t i = columns->students_num;
+    columns->grade_book_nums[i] = entry.grade_book_num;
+    ss_init_adopt(columns->surnames + i, entry.surname);
+    ss_init_adopt(columns->faculties + i, entry.faculty);
+    ss_init_adopt(columns->groups + i, entry.group);
+    columns->students_num++;
+    return 0;
+}
+
+int stc_add_copy(students_columns* columns, const student* entry) {
+    assert(NULL != columns);
+    assert(NULL != entry);
+    if ((columns->students_num == columns->capacity) && 
+        (0 != stc_grow(columns))) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    size_t i = columns->students_num;
+    if (0 != ss_init(columns->surnames + i, entry->surname, 
+                     strlen(entry->surname))) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (0 != ss_init(columns->faculties + i, entry->faculty, 
+                     strlen(entry->faculty))) {
+        ss_free(columns->surnames + i);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (0 != ss_init(columns->groups + i, entry->group, 
+                     strlen(entry->group))) {
+        ss_free(columns->surnames + i);
+        ss_free(columns->faculties + i);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    columns->grade_book_nums[i] = entry->grade_book_num;
+    columns->students_num++;
+    return 0;
+}
+
+/**
+ * Reads a line into reused *buf without '\n', returns its length or -1
+*/
+static ssize_t stc_read_line(FILE* istream, char** buf, size_t* buf_size) {
+    ssize_t len = getline(buf, buf_size, istream);
+    if ((0 < len) && ('\n' == (*buf)[len - 1])) {
+        (*buf)[--len] = '\0';
+    }
+    return len;
+}
+
+/**
+ * Stores 'len' bytes of 'line' to 'str' if 'len' is not -1
+*/
+static int stc_store_line(small_string* str, const char* line, ssize_t len) {
+    if (-1 == len) {
+        return STS_READING_INPUT_ERROR;
+    }
+    return (0 == ss_init(str, line, (size_t) len)) ? 0 : STS_MEM_ALLOC_ERROR;
+}
+
+int stc_interactive_add(students_columns* columns, 
+                        FILE* istream, FILE* ostream) {
+    assert(NULL != columns);
+    assert(NULL != istream);
+    assert(NULL != ostream);
+    if ((columns->students_num == columns->capacity) && 
+        (0 != stc_grow(columns))) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    size_t i = columns->students_num;
+    char* line = NULL;
+    size_t line_size = 0;
+    fprintf(ostream, "Enter surname:\n");
+    // Line is read first: getline() may move it
+    ssize_t len = stc_read_line(istream, &line, &line_size);
+    int result = stc_store_line(columns->surnames + i, line, len);
+    if (0 != result) {
+        free(line);
+        return result;
+    }
+    fprintf(ostream, "Enter grade book number:\n");
+    long long grade_book_num = -1;
+    if (-1 == stc_read_line(istream, &line, &line_size)) {
+        result = STS_READING_INPUT_ERROR;
+    }
+    else {
+        char* rest_of_converted_str = NULL;
+        grade_book_num = strtoll(line, &rest_of_converted_str, 10);
+        if ((0 > grade_book_num) || (INT_MAX < grade_book_num) || 
+            ('\0' != *rest_of_converted_str)) {
+            result = ST_INVALID_DATA;
+        }
+    }
+    if (0 != result) {
+        ss_free(columns->surnames + i);
+        free(line);
+        return result;
+    }
+    fprintf(ostream, "Enter faculty:\n");
+    len = stc_read_line(istream, &line, &line_size);
+    result = stc_store_line(columns->faculties + i, line, len);
+    if (0 != result) {
+        ss_free(columns->surnames + i);
+        free(line);
+        return result;
+    }
+    fprintf(ostream, "Enter group:\n");
+    len = stc_read_line(istream, &line, &line_size);
+    result = stc_store_line(columns->groups + i, line, len);
+    free(line);
+    if (0 != result) {
+        ss_free(columns->surnames + i);
+        ss_free(columns->faculties + i);
+        return result;
+    }
+    columns->grade_book_nums[i] = (int) grade_book_num;
+    columns->students_num++;
+    return 0;
+}
+
+students_columns* stc_new_from_array(const students_array* collection) {
+    assert(NULL != collection);
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    students_columns* result = stc_new(n);
+    if (NULL == result) {
+        return NULL;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != stc_add_copy(result, collection->students + i)) {
+            stc_destroy(&result);
+            return NULL;
+        }
+    }
+    return result;
+}
+
+void stc_get(const students_columns* columns, size_t i, student* entry) {
+    assert(NULL != columns);
+    assert(NULL != entry);
+    assert(i < columns->students_num);
+    entry->grade_book_num = columns->grade_book_nums[i];
+    // Strings are only read through 'entry', casts drop const for student
+    entry->surname = (char*) ss_cstr(columns->surnames + i);
+    entry->faculty = (char*) ss_cstr(columns->faculties + i);
+    entry->group = (char*) ss_cstr(columns->groups + i);
+}
+
+void stc_formatted_print_all(const students_columns* columns, FILE* ostream) {
+    assert(NULL != columns);
+    assert(NULL != ostream);
+    if (0 == columns->students_num) {
+        return;
+    }
+    fprintf(ostream, "students_columns collection:\n");
+    fprintf(ostream, "students_num in collection == %zu:\n", 
+            columns->students_num);
+    for (size_t i = 0; i < columns->students_num; ++i) {
+        student entry;
+        stc_get(columns, i, &entry);
+        st_formatted_print(&entry, ostream);
+    }
+}
+
+void stc_destroy(students_columns** columns) {
+    assert(NULL != columns);
+    if (NULL == *columns) {
+        return;
+    }
+    for (size_t i = 0; i < (*columns)->students_num; ++i) {
+        ss_free((*columns)->surnames + i);
+        ss_free((*columns)->faculties + i);
+        ss_free((*columns)->groups + i);
+    }
+    free((*columns)->grade_book_nums);
+    free((*columns)->surnames);
+    free((*columns)->faculties);
+    free((*columns)->groups);
+    free(*columns);
+    *columns = NULL;
+}
+
+
+
+/************** Beginning of scan kernels **************/
+
+/**
+ * Every search is either a predicate scan or a minimal distance scan.
+ * Predicate is "lo <= x <= hi" (STC_RANGE) or "x == lo || x == hi" (STC_PAIR)
+*/
+enum stc_predicate_kind {
+    STC_RANGE,
+    STC_PAIR,
+};
+
+typedef struct stc_predicate {
+    enum stc_predicate_kind kind;
+    int lo;
+    int hi;
+} stc_predicate;
+
+/**
+ * What predicate scan does with matches
+*/
+enum stc_scan_mode {
+    STC_FIRST, // Returns position of the first match or STC_NOT_FOUND
+    STC_COUNT, // Returns number of matches
+    STC_COLLECT, // Stores positions of matches to 'out', returns their number
+};
+
+static bool stc_matches(const stc_predicate* predicate, int value) {
+    if (STC_RANGE == predicate->kind) {
+        return (predicate->lo <= value) && (value <= predicate->hi);
+    }
+    return (predicate->lo == value) || (predicate->hi == value);
+}
+
+/**
+ * |a - b| never overflows as unsigned
+*/
+static unsigned stc_distance(int a, int b) {
+    return (a > b) ? (unsigned) a - (unsigned) b : (unsigned) b - (unsigned) a;
+}
+
+/**
+ * Handles matches found in 'mask' (bit i is for position from + i), 
+ *  returns true if scan should stop
+*/
+static bool stc_handle_mask(unsigned mask, size_t from, enum stc_scan_mode mode, 
+                            size_t* out, size_t* result) {
+    if (0 == mask) {
+        return false;
+    }
+    switch (mode) {
+        case STC_FIRST:
+            *result = from + __builtin_ctz(mask);
+            return true;
+        case STC_COUNT:
+            *result += __builtin_popcount(mask);
+            return false;
+        case STC_COLLECT:
+            while (0 != mask) {
+                out[(*result)++] = from + __builtin_ctz(mask);
+                mask &= mask - 1;
+            }
+            return false;
+    }
+    return false;
+}
+
+static size_t stc_scan_scalar(const int* values, size_t from, size_t n, 
+                              const stc_predicate* predicate, 
+                              enum stc_scan_mode mode, size_t* out, 
+                              size_t result) {
+    for (size_t i = from; i < n; ++i) {
+        if (stc_matches(predicate, values[i]) && 
+            stc_handle_mask(1, i, mode, out, &result)) {
+            return result;
+        }
+    }
+    return (STC_FIRST == mode) ? STC_NOT_FOUND : result;
+}
+
+static unsigned stc_min_distance_scalar(const int* values, size_t from, 
+                                        size_t n, int value, unsigned result) {
+    for (size_t i = from; i < n; ++i) {
+        unsigned distance = stc_distance(values[i], value);
+        if (distance < result) {
+            result = distance;
+        }
+    }
+    return result;
+}
+
+#ifdef STC_X86
+
+__attribute__((target("avx2")))
+static size_t stc_scan_avx2(const int* values, size_t n, 
+                            const stc_predicate* predicate, 
+                            enum stc_scan_mode mode, size_t* out) {
+    size_t result = 0;
+    const __m256i lo = _mm256_set1_epi32(predicate->lo);
+    const __m256i hi = _mm256_set1_epi32(predicate->hi);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*) (values + i));
+        __m256i matches;
+        if (STC_RANGE == predicate->kind) {
+            __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(lo, x), 
+                                              _mm256_cmpgt_epi32(x, hi));
+            matches = _mm256_xor_si256(outside, _mm256_set1_epi32(-1));
+        }
+        else {
+            matches = _mm256_or_si256(_mm256_cmpeq_epi32(x, lo), 
+                                      _mm256_cmpeq_epi32(x, hi));
+        }
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(matches));
+        if (stc_handle_mask(mask, i, mode, out, &result)) {
+            return result;
+        }
+    }
+    return stc_scan_scalar(values, i, n, predicate, mode, out, result);
+}
+
+__attribute__((target("avx2")))
+static unsigned stc_min_distance_avx2(const int* values, size_t n, int value) {
+    const __m256i v = _mm256_set1_epi32(value);
+    __m256i min_distances = _mm256_set1_epi32(-1); // UINT_MAX in all lanes
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*) (values + i));
+        __m256i distances = _mm256_sub_epi32(_mm256_max_epi32(x, v), 
+                                             _mm256_min_epi32(x, v));
+        min_distances = _mm256_min_epu32(min_distances, distances);
+    }
+    unsigned lanes[8];
+    _mm256_storeu_si256((__m256i*) lanes, min_distances);
+    unsigned result = UINT_MAX;
+    for (size_t lane = 0; lane < 8; ++lane) {
+        if (lanes[lane] < result) {
+            result = lanes[lane];
+        }
+    }
+    return stc_min_distance_scalar(values, i, n, value, result);
+}
+
+__attribute__((target("sse4.1")))
+static size_t stc_scan_sse41(const int* values, size_t n, 
+                             const stc_predicate* predicate, 
+                             enum stc_scan_mode mode, size_t* out) {
+    size_t result = 0;
+    const __m128i lo = _mm_set1_epi32(predicate->lo);
+    const __m128i hi = _mm_set1_epi32(predicate->hi);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*) (values + i));
+        __m128i matches;
+        if (STC_RANGE == predicate->kind) {
+            __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(lo, x), 
+                                           _mm_cmpgt_epi32(x, hi));
+            matches = _mm_xor_si128(outside, _mm_set1_epi32(-1));
+        }
+        else {
+            matches = _mm_or_si128(_mm_cmpeq_epi32(x, lo), 
+                                   _mm_cmpeq_epi32(x, hi));
+        }
+        unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(matches));
+        if (stc_handle_mask(mask, i, mode, out, &result)) {
+            return result;
+        }
+    }
+    return stc_scan_scalar(values, i, n, predicate, mode, out, result);
+}
+
+__attribute__((target("sse4.1")))
+static unsigned stc_min_distance_sse41(const int* values, size_t n, int value) {
+    const __m128i v = _mm_set1_epi32(value);
+    __m128i min_distances = _mm_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128((const __m128i*) (values + i));
+        __m128i distances = _mm_sub_epi32(_mm_max_epi32(x, v), 
+                                          _mm_min_epi32(x, v));
+        min_distances = _mm_min_epu32(min_distances, distances);
+    }
+    unsigned lanes[4];
+    _mm_storeu_si128((__m128i*) lanes, min_distances);
+    unsigned result = UINT_MAX;
+    for (size_t lane = 0; lane < 4; ++lane) {
+        if (lanes[lane] < result) {
+            result = lanes[lane];
+        }
+    }
+    return stc_min_distance_scalar(values, i, n, value, result);
+}
+
+#endif
+
+static size_t stc_scan(const int* values, size_t n, 
+                       const stc_predicate* predicate, 
+                       enum stc_scan_mode mode, size_t* out) {
+#ifdef STC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return stc_scan_avx2(values, n, predicate, mode, out);
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return stc_scan_sse41(values, n, predicate, mode, out);
+    }
+#endif
+    return stc_scan_scalar(values, 0, n, predicate, mode, out, 0);
+}
+
+static unsigned stc_min_distance(const int* values, size_t n, int value) {
+#ifdef STC_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return stc_min_distance_avx2(values, n, value);
+    }
+    if (__builtin_cpu_supports("sse4.1")) {
+        return stc_min_distance_sse41(values, n, value);
+    }
+#endif
+    return stc_min_distance_scalar(values, 0, n, value, UINT_MAX);
+}
+
+/*************** End of scan kernels ***************/
+
+
+
+/**
+ * Runs STC_COLLECT scan into a buffer big enough for all students, 
+ *  then shrinks it to the number of matches
+*/
+static int stc_collect(const students_columns* columns, 
+                       const stc_predicate* predicate, 
+                       size_t** positions, size_t* found_num) {
+    *positions = NULL;
+    *found_num = 0;
+    if (0 == columns->students_num) {
+        return 0;
+    }
+    size_t* buf = (size_t*) malloc(sizeof(*buf) * columns->students_num);
+    if (NULL == buf) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    size_t found = stc_scan(columns->grade_book_nums, columns->students_num, 
+                            predicate, STC_COLLECT, buf);
+    if (0 == found) {
+        free(buf);
+        return 0;
+    }
+    size_t* shrunk_buf = (size_t*) realloc(buf, sizeof(*buf) * found);
+    *positions = (NULL == shrunk_buf) ? buf : shrunk_buf;
+    *found_num = found;
+    return 0;
+}
+
+/**
+ * Builds predicate "grade_book_num is closest to 'value'"
+ *  Returns false if there are no students
+*/
+static bool stc_closest_predicate(const students_columns* columns, 
+                                  size_t value, stc_predicate* predicate) {
+    if (0 == columns->students_num) {
+        return false;
+    }
+    // All grade book numbers are not greater than INT_MAX, 
+    //  so INT_MAX has the same closest ones as any bigger value
+    int int_value = (INT_MAX < value) ? INT_MAX : (int) value;
+    unsigned min_distance = stc_min_distance(columns->grade_book_nums, 
+                                             columns->students_num, int_value);
+    // Closest values are int_value -/+ min_distance, at least one of them
+    //  exists, the other one is replaced with it if it doesn't fit into int
+    long long lower = (long long) int_value - min_distance;
+    long long upper = (long long) int_value + min_distance;
+    predicate->kind = STC_PAIR;
+    predicate->lo = (INT_MIN > lower) ? (int) upper : (int) lower;
+    predicate->hi = (INT_MAX < upper) ? (int) lower : (int) upper;
+    return true;
+}
+
+size_t stc_find_one_exact_grade_book_num(const students_columns* columns, 
+                                         size_t value) {
+    assert(NULL != columns);
+    if (INT_MAX < value) {
+        return STC_NOT_FOUND;
+    }
+    stc_predicate predicate = {STC_RANGE, (int) value, (int) value};
+    return stc_scan(columns->grade_book_nums, columns->students_num, 
+                    &predicate, STC_FIRST, NULL);
+}
+
+size_t stc_find_one_closest_grade_book_num(const students_columns* columns, 
+                                           size_t value) {
+    assert(NULL != columns);
+    stc_predicate predicate;
+    if (!stc_closest_predicate(columns, value, &predicate)) {
+        return STC_NOT_FOUND;
+    }
+    return stc_scan(columns->grade_book_nums, columns->students_num, 
+                    &predicate, STC_FIRST, NULL);
+}
+
+int stc_find_all_exact_grade_book_num(const students_columns* columns, 
+                                      size_t value, 
+                                      size_t** positions, size_t* found_num) {
+    assert(NULL != columns);
+    assert(NULL != positions);
+    assert(NULL != found_num);
+    if (INT_MAX < value) {
+        *positions = NULL;
+        *found_num = 0;
+        return 0;
+    }
+    stc_predicate predicate = {STC_RANGE, (int) value, (int) value};
+    return stc_collect(columns, &predicate, positions, found_num);
+}
+
+int stc_find_all_closest_grade_book_num(const students_columns* columns, 
+                                        size_t value, 
+                                        size_t** positions, size_t* found_num) {
+    assert(NULL != columns);
+    assert(NULL != positions);
+    assert(NULL != found_num);
+    stc_predicate predicate;
+    if (!stc_closest_predicate(columns, value, &predicate)) {
+        *positions = NULL;
+        *found_num = 0;
+        return 0;
+    }
+    return stc_collect(columns, &predicate, positions, found_num);
+}
+
+size_t stc_count_grade_book_num_in_range(const students_columns* columns, 
+                                         int min_value, int max_value) {
+    assert(NULL != columns);
+    if (min_value > max_value) {
+        return 0;
+    }
+    stc_predicate predicate = {STC_RANGE, min_value, max_value};
+    return stc_scan(columns->grade_book_nums, columns->students_num, 
+                    &predicate, STC_COUNT, NULL);
+}
+
+int stc_find_all_grade_book_num_in_range(const students_columns* columns, 
+                                         int min_value, int max_value, 
+                                         size_t** positions, size_t* found_num) {
+    assert(NULL != columns);
+    assert(NULL != positions);
+    assert(NULL != found_num);
+    if (min_value > max_value) {
+        *positions = NULL;
+        *found_num = 0;
+        return 0;
+    }
+    stc_predicate predicate = {STC_RANGE, min_value, max_value};
+    return stc_collect(columns, &predicate, positions, found_num);
+}
+
+/**
+ * Collects positions of 'column' elements equal to 'value'
+*/
+static int stc_collect_equal_strings(const students_columns* columns, 
+                                     const small_string* column, 
+                                     const char* value, 
+                                     size_t** positions, size_t* found_num) {
+    *positions = NULL;
+    *found_num = 0;
+    if (0 == columns->students_num) {
+        return 0;
+    }
+    size_t* buf = (size_t*) malloc(sizeof(*buf) * columns->students_num);
+    if (NULL == buf) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    size_t value_len = strlen(value);
+    size_t found = 0;
+    for (size_t i = 0; i < columns->students_num; ++i) {
+        if (ss_equals_cstr(column + i, value, value_len)) {
+            buf[found++] = i;
+        }
+    }
+    if (0 == found) {
+        free(buf);
+        return 0;
+    }
+    size_t* shrunk_buf = (size_t*) realloc(buf, sizeof(*buf) * found);
+    *positions = (NULL == shrunk_buf) ? buf : shrunk_buf;
+    *found_num = found;
+    return 0;
+}
+
+int stc_find_all_exact_surname(const students_columns* columns, 
+                               const char* value, 
+                               size_t** positions, size_t* found_num) {
+    assert(NULL != columns);
+    assert(NULL != value);
+    assert(NULL != positions);
+    assert(NULL != found_num);
+    return stc_collect_equal_strings(columns, columns->surnames, value, 
+                                     positions, found_num);
+}
+
+int stc_find_all_exact_faculty(const students_columns* columns, 
+                               const char* value, 
+                               size_t** positions, size_t* found_num) {
+    assert(NULL != columns);
+    assert(NULL != value);
+    assert(NULL != positions);
+    assert(NULL != found_num);
+    return stc_collect_equal_strings(columns, columns->faculties, value, 
+                                     positions, found_num);
+}
+
+int stc_find_all_exact_group(const students_columns* columns, 
+                             const char* value, 
+                             size_t** positions, size_t* found_num) {
+    assert(NULL != columns);
+    assert(NULL != value);
+    assert(NULL != positions);
+    assert(NULL != found_num);
+    return stc_collect_equal_strings(columns, columns->groups, value, 
+                                     positions, found_num);
+}
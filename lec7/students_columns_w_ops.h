@@ -0,0 +1,105 @@
+#ifndef STUDENTS_COLUMNS_W_OPS_H
+#define STUDENTS_COLUMNS_W_OPS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "students_columns_struct.h"
+#include "students_array_struct.h"
+
+/**
+ * Returned by stc_find_one_* functions when nothing is found
+*/
+#define STC_NOT_FOUND SIZE_MAX
+
+/**
+ * Return codes are the ones of students_array_ops_return_codes
+*/
+
+/**
+ * If memory allocation fails, returns NULL
+*/
+students_columns* stc_new(size_t initial_capacity);
+
+/**
+ * Makes a columnar copy of 'collection', strings are duplicated
+ * If memory allocation fails, returns NULL
+*/
+students_columns* stc_new_from_array(const students_array* collection);
+
+/**
+ * Takes ownership of entry's strings, like st_add() of default collection.
+ *  Strings not longer than SS_INLINE_CAPACITY are moved inline and freed
+*/
+int stc_add(students_columns* columns, student entry);
+
+/**
+ * Copies entry's strings, only long ones need memory allocation
+*/
+int stc_add_copy(students_columns* columns, const student* entry);
+
+/**
+ * Reads student like st_interactive_add() does, but all lines go through
+ *  one reused buffer, so short values are stored without allocations
+*/
+int stc_interactive_add(students_columns* columns, 
+                        FILE* istream, FILE* ostream);
+
+/**
+ * Fills 'entry' with i-th student, strings still belong to 'columns'
+ *  and are valid until the next addition (columns may be reallocated)
+*/
+void stc_get(const students_columns* columns, size_t i, student* entry);
+
+void stc_formatted_print_all(const students_columns* columns, FILE* ostream);
+
+/**
+ * After freeing data, sets *columns to NULL
+*/
+void stc_destroy(students_columns** columns);
+
+/**
+ * Searches by grade_book_num. They are run by AVX2 or SSE4.1 kernels
+ *  when CPU supports them and by scalar code otherwise.
+ * Distance is |grade_book_num - value| computed without overflow.
+ * stc_find_one_* return position of the first matching student
+ *  or STC_NOT_FOUND, stc_find_all_* store malloc()'ed array 
+ *  of matching positions (in increasing order) to *positions 
+ *  and their number to *found_num
+ *  (*positions is NULL if nothing is found)
+*/
+size_t stc_find_one_exact_grade_book_num(const students_columns* columns, 
+                                         size_t value);
+size_t stc_find_one_closest_grade_book_num(const students_columns* columns, 
+                                           size_t value);
+int stc_find_all_exact_grade_book_num(const students_columns* columns, 
+                                      size_t value, 
+                                      size_t** positions, size_t* found_num);
+int stc_find_all_closest_grade_book_num(const students_columns* columns, 
+                                        size_t value, 
+                                        size_t** positions, size_t* found_num);
+
+/**
+ * Numeric filter: students with min_value <= grade_book_num <= max_value
+*/
+size_t stc_count_grade_book_num_in_range(const students_columns* columns, 
+                                         int min_value, int max_value);
+int stc_find_all_grade_book_num_in_range(const students_columns* columns, 
+                                         int min_value, int max_value, 
+                                         size_t** positions, size_t* found_num);
+
+/**
+ * Searches by string fields. Short values are compared inside
+ *  16 bytes of their column element, without following a pointer.
+ * Results are stored like those of stc_find_all_exact_grade_book_num()
+*/
+int stc_find_all_exact_surname(const students_columns* columns, 
+                               const char* value, 
+                               size_t** positions, size_t* found_num);
+int stc_find_all_exact_faculty(const students_columns* columns, 
+                               const char* value, 
+                               size_t** positions, size_t* found_num);
+int stc_find_all_exact_group(const students_columns* columns, 
+                             const char* value, 
+                             size_t** positions, size_t* found_num);
+
+#endif
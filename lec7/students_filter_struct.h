@@ -0,0 +1,41 @@
+#ifndef STUDENTS_FILTER_STRUCT_H
+#define STUDENTS_FILTER_STRUCT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * Filters deeper than that are rejected
+*/
+#define STF_MAX_DEPTH 16
+
+enum students_filter_op {
+    STF_FACULTY_EQ = 0,
+    STF_GROUP_EQ,
+    STF_GRADE_BOOK_NUM_BETWEEN,
+    STF_AND,
+    STF_OR,
+    STF_NOT,
+};
+
+typedef struct students_filter_instr {
+    enum students_filter_op op;
+    char* value; // Copy, for STF_*_EQ only
+    int from; // Bounds of STF_GRADE_BOOK_NUM_BETWEEN, inclusive
+    int to;
+} students_filter_instr;
+
+/**
+ * Filter over several fields as a postfix program: 
+ *  terms push their result, operators pop operands and push result.
+ *  E.g. "faculty = X AND group = Y" is [FACULTY_EQ X, GROUP_EQ Y, AND]
+*/
+typedef struct students_filter {
+    students_filter_instr* instrs;
+    size_t instrs_num;
+    size_t capacity;
+    size_t depth; // Stack depth after the program, 1 for a complete filter
+    size_t max_depth;
+} students_filter;
+
+#endif
@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "students_filter_w_ops.h"
+#include "students_array_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+students_filter* stf_new() {
+    students_filter* filter = (students_filter*) malloc(sizeof(*filter));
+    if (NULL == filter) {
+        return NULL;
+    }
+    filter->instrs = NULL;
+    filter->instrs_num = 0;
+    filter->capacity = 0;
+    filter->depth = 0;
+    filter->max_depth = 0;
+    return filter;
+}
+
+void stf_destroy(students_filter** filter) {
+    assert(NULL != filter);
+    if (NULL == *filter) {
+        return;
+    }
+    for (size_t i = 0; i < (*filter)->instrs_num; ++i) {
+        free((*filter)->instrs[i].value);
+    }
+    free((*filter)->instrs);
+    free(*filter);
+    *filter = NULL;
+}
+
+/**
+ * Appends instruction that pops 'operands_num' results and pushes one
+*/
+static int stf_push(students_filter* filter, students_filter_instr instr, 
+                    size_t operands_num) {
+    if ((filter->depth < operands_num) || 
+        ((0 == operands_num) && (STF_MAX_DEPTH == filter->depth))) {
+        free(instr.value);
+        return ST_INVALID_DATA;
+    }
+    if (filter->instrs_num == filter->capacity) {
+        size_t new_capacity = (0 == filter->capacity) ? 4 : filter->capacity * 2;
+        students_filter_instr* instrs = (students_filter_instr*)
+            realloc(filter->instrs, sizeof(*instrs) * new_capacity);
+        if (NULL == instrs) {
+            free(instr.value);
+            return STS_MEM_ALLOC_ERROR;
+        }
+        filter->instrs = instrs;
+        filter->capacity = new_capacity;
+    }
+    filter->instrs[filter->instrs_num++] = instr;
+    filter->depth = filter->depth - operands_num + 1;
+    if (filter->depth > filter->max_depth) {
+        filter->max_depth = filter->depth;
+    }
+    return 0;
+}
+
+static int stf_push_eq(students_filter* filter, enum students_filter_op op, 
+                       const char* value) {
+    assert(NULL != filter);
+    assert(NULL != value);
+    students_filter_instr instr = {op, strdup(value), 0, 0};
+    if (NULL == instr.value) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    return stf_push(filter, instr, 0);
+}
+
+int stf_faculty_eq(students_filter* filter, const char* value) {
+    return stf_push_eq(filter, STF_FACULTY_EQ, value);
+}
+
+int stf_group_eq(students_filter* filter, const char* value) {
+    return stf_push_eq(filter, STF_GROUP_EQ, value);
+}
+
+int stf_grade_book_num_between(students_filter* filter, int from, int to) {
+    assert(NULL != filter);
+    students_filter_instr instr = {STF_GRADE_BOOK_NUM_BETWEEN, NULL, from, to};
+    return stf_push(filter, instr, 0);
+}
+
+int stf_and(students_filter* filter) {
+    assert(NULL != filter);
+    students_filter_instr instr = {STF_AND, NULL, 0, 0};
+    return stf_push(filter, instr, 2);
+}
+
+int stf_or(students_filter* filter) {
+    assert(NULL != filter);
+    students_filter_instr instr = {STF_OR, NULL, 0, 0};
+    return stf_push(filter, instr, 2);
+}
+
+int stf_not(students_filter* filter) {
+    assert(NULL != filter);
+    students_filter_instr instr = {STF_NOT, NULL, 0, 0};
+    return stf_push(filter, instr, 1);
+}
+
+bool stf_matches(const students_filter* filter, const student* entry) {
+    assert(NULL != filter);
+    assert(stf_is_complete(filter));
+    bool stack[STF_MAX_DEPTH];
+    size_t depth = 0;
+    for (size_t i = 0; i < filter->instrs_num; ++i) {
+        const students_filter_instr* instr = filter->instrs + i;
+        switch (instr->op) {
+            case STF_AND:
+                --depth;
+                stack[depth - 1] = stack[depth - 1] && stack[depth];
+                break;
+            case STF_OR:
+                --depth;
+                stack[depth - 1] = stack[depth - 1] || stack[depth];
+                break;
+            case STF_NOT:
+                stack[depth - 1] = !stack[depth - 1];
+                break;
+            default:
+                stack[depth++] = stf_term_matches(instr, entry);
+                break;
+        }
+    }
+    return stack[0];
+}
@@ -0,0 +1,73 @@
+#ifndef STUDENTS_FILTER_W_OPS_H
+#define STUDENTS_FILTER_W_OPS_H
+
+#include <stdbool.h>
+#include <string.h>
+#include "students_struct.h"
+#include "students_filter_struct.h"
+
+/**
+ * Filter is built in postfix order: 
+ *  stf_faculty_eq(f, "X"); stf_group_eq(f, "Y"); stf_and(f);
+ *  stf_grade_book_num_between(f, 10, 20); stf_and(f);
+ * Every function returns 0, STS_MEM_ALLOC_ERROR or ST_INVALID_DATA
+ *  (operator without enough operands or filter deeper than STF_MAX_DEPTH), 
+ *  filter is left unchanged on failure.
+ * Filters are evaluated over bitmap indexes, see students_bitmap_index_w_ops.h
+*/
+
+/**
+ * Returns NULL if memory allocation fails
+*/
+students_filter* stf_new();
+
+/**
+ * Terms, 'value' is copied
+*/
+int stf_faculty_eq(students_filter* filter, const char* value);
+int stf_group_eq(students_filter* filter, const char* value);
+int stf_grade_book_num_between(students_filter* filter, int from, int to);
+
+/**
+ * Operators
+*/
+int stf_and(students_filter* filter);
+int stf_or(students_filter* filter);
+int stf_not(students_filter* filter);
+
+/**
+ * Whether filter is complete (leaves exactly one result)
+*/
+static inline bool stf_is_complete(const students_filter* filter) {
+    return 1 == filter->depth;
+}
+
+/**
+ * Whether 'entry' matches term 'instr'
+*/
+static inline bool stf_term_matches(const students_filter_instr* instr, 
+                                    const student* entry) {
+    switch (instr->op) {
+        case STF_FACULTY_EQ:
+            return 0 == strcmp(entry->faculty, instr->value);
+        case STF_GROUP_EQ:
+            return 0 == strcmp(entry->group, instr->value);
+        case STF_GRADE_BOOK_NUM_BETWEEN:
+            return (instr->from <= entry->grade_book_num) && 
+                   (entry->grade_book_num <= instr->to);
+        default:
+            return false;
+    }
+}
+
+/**
+ * Evaluates complete filter for one entry
+*/
+bool stf_matches(const students_filter* filter, const student* entry);
+
+/**
+ * Sets *filter to NULL
+*/
+void stf_destroy(students_filter** filter);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef STUDENTS_GROUPS_STRUCT_H
+#define STUDENTS_GROUPS_STRUCT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "students_struct.h"
+#include "students_reducer_struct.h"
+
+#define STG_MAX_AGGREGATES 8
+
+/**
+ * Group key: string, integer or both.
+ *  String is borrowed (usually from the entry it was extracted from), 
+ *  NULL 'str' means integer key
+*/
+typedef struct students_group_key {
+    const char* str;
+    int64_t num;
+} students_group_key;
+
+typedef students_group_key (*students_key_extractor)(const student* entry);
+
+/**
+ * Result of sts_group_by(): one row per distinct key in order
+ *  of first appearance. Row holds accumulators of all aggregates, 
+ *  'acc_offsets[a]' is where a-th of them starts.
+ * Rows are found by key through open-addressing hash table 'slots'
+ *  (linear probing, group index + 1, 0 is empty)
+*/
+typedef struct students_groups {
+    size_t groups_num;
+    size_t groups_capacity;
+    students_group_key* keys;
+    uint64_t* hashes;
+    size_t* first_positions; // Of the first entry of every group
+    unsigned char* rows;
+    size_t row_size;
+    students_reducer aggregates[STG_MAX_AGGREGATES];
+    size_t acc_offsets[STG_MAX_AGGREGATES];
+    size_t aggregates_num;
+    size_t* slots;
+    size_t slots_num; // Power of 2
+} students_groups;
+
+#endif
@@ -0,0 +1,512 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+
+#include "students_groups_w_ops.h"
+#include "thread_pool_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+/**
+ * Smaller collections are grouped in the calling thread
+*/
+#define STG_PARALLEL_THRESHOLD (1 << 14)
+#define STG_INITIAL_SLOTS_NUM 16
+#define STG_INITIAL_GROUPS_CAPACITY 8
+#define STG_FNV_OFFSET 14695981039346656037ULL
+#define STG_FNV_PRIME 1099511628211ULL
+
+/******************** Keys and aggregates ********************/
+
+students_group_key stg_key_faculty(const student* entry) {
+    students_group_key key = {entry->faculty, 0};
+    return key;
+}
+
+students_group_key stg_key_group(const student* entry) {
+    students_group_key key = {entry->group, 0};
+    return key;
+}
+
+static void stg_count_step(void* acc, const student* entry) {
+    (void) entry;
+    ++*((size_t*) acc);
+}
+
+static void stg_count_combine(void* acc, const void* other) {
+    *((size_t*) acc) += *((const size_t*) other);
+}
+
+static void stg_min_step(void* acc, const student* entry) {
+    if (entry->grade_book_num < *((int*) acc)) {
+        *((int*) acc) = entry->grade_book_num;
+    }
+}
+
+static void stg_min_combine(void* acc, const void* other) {
+    if (*((const int*) other) < *((int*) acc)) {
+        *((int*) acc) = *((const int*) other);
+    }
+}
+
+static void stg_max_step(void* acc, const student* entry) {
+    if (entry->grade_book_num > *((int*) acc)) {
+        *((int*) acc) = entry->grade_book_num;
+    }
+}
+
+static void stg_max_combine(void* acc, const void* other) {
+    if (*((const int*) other) > *((int*) acc)) {
+        *((int*) acc) = *((const int*) other);
+    }
+}
+
+static void stg_sum_step(void* acc, const student* entry) {
+    *((long long*) acc) += entry->grade_book_num;
+}
+
+static void stg_sum_combine(void* acc, const void* other) {
+    *((long long*) acc) += *((const long long*) other);
+}
+
+static const size_t stg_zero_count = 0;
+static const int stg_int_max = INT_MAX;
+static const int stg_int_min = INT_MIN;
+static const long long stg_zero_sum = 0;
+
+const students_reducer stg_count = {
+    sizeof(size_t), &stg_zero_count, stg_count_step, stg_count_combine
+};
+const students_reducer stg_min_grade_book_num = {
+    sizeof(int), &stg_int_max, stg_min_step, stg_min_combine
+};
+const students_reducer stg_max_grade_book_num = {
+    sizeof(int), &stg_int_min, stg_max_step, stg_max_combine
+};
+const students_reducer stg_sum_grade_book_num = {
+    sizeof(long long), &stg_zero_sum, stg_sum_step, stg_sum_combine
+};
+
+/******************** Hash table ********************/
+
+static uint64_t stg_hash(students_group_key key) {
+    uint64_t hash = STG_FNV_OFFSET;
+    if (NULL != key.str) {
+        for (const unsigned char* c = (const unsigned char*) key.str; '\0' != *c; ++c) {
+            hash ^= *c;
+            hash *= STG_FNV_PRIME;
+        }
+    }
+    hash ^= (uint64_t) key.num;
+    hash *= STG_FNV_PRIME;
+    // FNV leaves low bits poorly mixed, and slots are picked by them
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+static bool stg_keys_equal(students_group_key key1, students_group_key key2) {
+    return (key1.num == key2.num) && 
+           ((key1.str == key2.str) || 
+            ((NULL != key1.str) && (NULL != key2.str) && 
+             (0 == strcmp(key1.str, key2.str))));
+}
+
+static students_groups* stg_new(const students_reducer* aggregates, 
+                                size_t aggregates_num) {
+    students_groups* groups = (students_groups*) malloc(sizeof(*groups));
+    if (NULL == groups) {
+        return NULL;
+    }
+    groups->groups_num = 0;
+    groups->groups_capacity = 0;
+    groups->keys = NULL;
+    groups->hashes = NULL;
+    groups->first_positions = NULL;
+    groups->rows = NULL;
+    // Accumulators are aligned like anything malloc() returns
+    size_t alignment = _Alignof(max_align_t);
+    groups->row_size = 0;
+    for (size_t i = 0; i < aggregates_num; ++i) {
+        groups->aggregates[i] = aggregates[i];
+        groups->acc_offsets[i] = groups->row_size;
+        groups->row_size += 
+            (aggregates[i].acc_size + alignment - 1) / alignment * alignment;
+    }
+    groups->aggregates_num = aggregates_num;
+    groups->slots_num = STG_INITIAL_SLOTS_NUM;
+    groups->slots = (size_t*) calloc(groups->slots_num, sizeof(*groups->slots));
+    if (NULL == groups->slots) {
+        free(groups);
+        return NULL;
+    }
+    return groups;
+}
+
+void stg_destroy(students_groups** groups) {
+    assert(NULL != groups);
+    if (NULL == *groups) {
+        return;
+    }
+    free((*groups)->keys);
+    free((*groups)->hashes);
+    free((*groups)->first_positions);
+    free((*groups)->rows);
+    free((*groups)->slots);
+    free(*groups);
+    *groups = NULL;
+}
+
+/**
+ * Slot holding group with 'key' or the empty one where it would go
+*/
+static size_t stg_find_slot(const students_groups* groups, 
+                            students_group_key key, uint64_t hash) {
+    size_t mask = groups->slots_num - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+        size_t slot = groups->slots[i];
+        if ((0 == slot) || 
+            ((groups->hashes[slot - 1] == hash) && 
+             stg_keys_equal(groups->keys[slot - 1], key))) {
+            return i;
+        }
+    }
+}
+
+static bool stg_grow_groups(students_groups* groups) {
+    size_t new_capacity = (0 == groups->groups_capacity) ? 
+        STG_INITIAL_GROUPS_CAPACITY : groups->groups_capacity * 2;
+    students_group_key* keys = (students_group_key*)
+        realloc(groups->keys, sizeof(*keys) * new_capacity);
+    if (NULL == keys) {
+        return false;
+    }
+    groups->keys = keys;
+    uint64_t* hashes = (uint64_t*)
+        realloc(groups->hashes, sizeof(*hashes) * new_capacity);
+    if (NULL == hashes) {
+        return false;
+    }
+    groups->hashes = hashes;
+    size_t* first_positions = (size_t*)
+        realloc(groups->first_positions, sizeof(*first_positions) * new_capacity);
+    if (NULL == first_positions) {
+        return false;
+    }
+    groups->first_positions = first_positions;
+    if (0 != groups->row_size) {
+        unsigned char* rows = (unsigned char*)
+            realloc(groups->rows, groups->row_size * new_capacity);
+        if (NULL == rows) {
+            return false;
+        }
+        groups->rows = rows;
+    }
+    groups->groups_capacity = new_capacity;
+    return true;
+}
+
+static bool stg_grow_slots(students_groups* groups) {
+    size_t new_slots_num = groups->slots_num * 2;
+    size_t* slots = (size_t*) calloc(new_slots_num, sizeof(*slots));
+    if (NULL == slots) {
+        return false;
+    }
+    size_t mask = new_slots_num - 1;
+    for (size_t g = 0; g < groups->groups_num; ++g) {
+        size_t i = groups->hashes[g] & mask;
+        while (0 != slots[i]) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = g + 1;
+    }
+    free(groups->slots);
+    groups->slots = slots;
+    groups->slots_num = new_slots_num;
+    return true;
+}
+
+/**
+ * Adds group that is not in table yet (its row is not initialized), 
+ *  returns its index or STG_NOT_FOUND if memory allocation fails
+*/
+static size_t stg_add_group(students_groups* groups, students_group_key key, 
+                            uint64_t hash, size_t first_position, size_t slot) {
+    if ((groups->groups_num == groups->groups_capacity) && 
+        !stg_grow_groups(groups)) {
+        return STG_NOT_FOUND;
+    }
+    // Load factor is kept at most 1/2
+    if (2 * (groups->groups_num + 1) > groups->slots_num) {
+        if (!stg_grow_slots(groups)) {
+            return STG_NOT_FOUND;
+        }
+        slot = stg_find_slot(groups, key, hash);
+    }
+    size_t g = groups->groups_num++;
+    groups->keys[g] = key;
+    groups->hashes[g] = hash;
+    groups->first_positions[g] = first_position;
+    groups->slots[slot] = g + 1;
+    return g;
+}
+
+/**
+ * Aggregates entries [from, to) into 'groups'
+*/
+static bool stg_aggregate_range(students_groups* groups, 
+                                const students_array* collection, 
+                                students_key_extractor key, 
+                                size_t from, size_t to) {
+    students_group_key last_key = {NULL, 0};
+    size_t last_group = STG_NOT_FOUND;
+    for (size_t i = from; i < to; ++i) {
+        const student* entry = collection->students + i;
+        students_group_key entry_key = key(entry);
+        size_t g = last_group;
+        // Runs of one key (e.g. in sorted collection) skip hashing, 
+        //  interned strings make equal keys equal pointers
+        if ((STG_NOT_FOUND == g) || (entry_key.str != last_key.str) || 
+            (entry_key.num != last_key.num)) {
+            uint64_t hash = stg_hash(entry_key);
+            size_t slot = stg_find_slot(groups, entry_key, hash);
+            if (0 != groups->slots[slot]) {
+                g = groups->slots[slot] - 1;
+            }
+            else {
+                g = stg_add_group(groups, entry_key, hash, i, slot);
+                if (STG_NOT_FOUND == g) {
+                    return false;
+                }
+                for (size_t a = 0; a < groups->aggregates_num; ++a) {
+                    unsigned char* row = groups->rows + g * groups->row_size;
+                    memcpy(row + groups->acc_offsets[a], groups->aggregates[a].init, 
+                           groups->aggregates[a].acc_size);
+                }
+            }
+            last_key = entry_key;
+            last_group = g;
+        }
+        for (size_t a = 0; a < groups->aggregates_num; ++a) {
+            unsigned char* row = groups->rows + g * groups->row_size;
+            groups->aggregates[a].step(row + groups->acc_offsets[a], entry);
+        }
+    }
+    return true;
+}
+
+/**
+ * Merges group 'g' of 'src' into 'dst', 'src' covers entries after
+ *  the ones already merged into 'dst'
+*/
+static bool stg_merge_group(students_groups* dst, const students_groups* src, 
+                            size_t g) {
+    students_group_key key = src->keys[g];
+    uint64_t hash = src->hashes[g];
+    size_t slot = stg_find_slot(dst, key, hash);
+    if (0 == dst->slots[slot]) {
+        size_t added = stg_add_group(dst, key, hash, src->first_positions[g], slot);
+        if (STG_NOT_FOUND == added) {
+            return false;
+        }
+        if (0 != dst->row_size) {
+            memcpy(dst->rows + added * dst->row_size, src->rows + g * src->row_size, 
+                   dst->row_size);
+        }
+        return true;
+    }
+    size_t d = dst->slots[slot] - 1;
+    for (size_t a = 0; a < dst->aggregates_num; ++a) {
+        dst->aggregates[a].combine((unsigned char*) stg_acc(dst, d, a), 
+                                   stg_acc(src, g, a));
+    }
+    if (src->first_positions[g] < dst->first_positions[d]) {
+        dst->first_positions[d] = src->first_positions[g];
+    }
+    return true;
+}
+
+/******************** Group-by ********************/
+
+typedef struct stg_job {
+    const students_array* collection;
+    students_key_extractor key;
+    const students_reducer* aggregates;
+    size_t aggregates_num;
+    size_t chunk_len;
+    size_t tasks_num;
+    students_groups** chunks; // Groups of every chunk
+    students_groups** partitions; // Groups with hash % tasks_num == index
+    bool* failed;
+} stg_job;
+
+static void stg_chunk_task(size_t task_idx, void* ctx) {
+    stg_job* job = (stg_job*) ctx;
+    size_t n = job->collection->students_num;
+    size_t from = task_idx * job->chunk_len;
+    if (from > n) {
+        from = n;
+    }
+    size_t to = (n - from > job->chunk_len) ? from + job->chunk_len : n;
+    job->chunks[task_idx] = stg_new(job->aggregates, job->aggregates_num);
+    job->failed[task_idx] = (NULL == job->chunks[task_idx]) || 
+        !stg_aggregate_range(job->chunks[task_idx], job->collection, job->key, 
+                             from, to);
+}
+
+static void stg_partition_task(size_t task_idx, void* ctx) {
+    stg_job* job = (stg_job*) ctx;
+    students_groups* partition = stg_new(job->aggregates, job->aggregates_num);
+    job->partitions[task_idx] = partition;
+    job->failed[task_idx] = (NULL == partition);
+    // High bits pick partition, low ones pick slot
+    for (size_t c = 0; (NULL != partition) && (c < job->tasks_num); ++c) {
+        const students_groups* chunk = job->chunks[c];
+        for (size_t g = 0; g < chunk->groups_num; ++g) {
+            if (((chunk->hashes[g] >> 32) % job->tasks_num == task_idx) && 
+                !stg_merge_group(partition, chunk, g)) {
+                job->failed[task_idx] = true;
+                return;
+            }
+        }
+    }
+}
+
+typedef struct stg_partition_group {
+    size_t first_position;
+    const students_groups* partition;
+    size_t g;
+} stg_partition_group;
+
+static int stg_partition_group_cmp(const void* arg1, const void* arg2) {
+    size_t pos1 = ((const stg_partition_group*) arg1)->first_position;
+    size_t pos2 = ((const stg_partition_group*) arg2)->first_position;
+    return (pos1 > pos2) - (pos1 < pos2);
+}
+
+/**
+ * Joins partitions into groups ordered by first appearance
+*/
+static students_groups* stg_join_partitions(const stg_job* job) {
+    size_t total = 0;
+    for (size_t p = 0; p < job->tasks_num; ++p) {
+        total += job->partitions[p]->groups_num;
+    }
+    stg_partition_group* order = (stg_partition_group*)
+        malloc(sizeof(*order) * (total + 1));
+    students_groups* result = stg_new(job->aggregates, job->aggregates_num);
+    if ((NULL == order) || (NULL == result)) {
+        free(order);
+        stg_destroy(&result);
+        return NULL;
+    }
+    size_t idx = 0;
+    for (size_t p = 0; p < job->tasks_num; ++p) {
+        const students_groups* partition = job->partitions[p];
+        for (size_t g = 0; g < partition->groups_num; ++g) {
+            order[idx].first_position = partition->first_positions[g];
+            order[idx].partition = partition;
+            order[idx].g = g;
+            ++idx;
+        }
+    }
+    qsort(order, total, sizeof(*order), stg_partition_group_cmp);
+    for (size_t i = 0; i < total; ++i) {
+        if (!stg_merge_group(result, order[i].partition, order[i].g)) {
+            stg_destroy(&result);
+            break;
+        }
+    }
+    free(order);
+    return result;
+}
+
+static students_groups* stg_group_by_parallel(const students_array* collection, 
+                                              students_key_extractor key, 
+                                              const students_reducer* aggregates, 
+                                              size_t aggregates_num, 
+                                              thread_pool* pool, 
+                                              size_t threads_num) {
+    stg_job job;
+    job.collection = collection;
+    job.key = key;
+    job.aggregates = aggregates;
+    job.aggregates_num = aggregates_num;
+    job.tasks_num = threads_num;
+    job.chunk_len = (collection->students_num + threads_num - 1) / threads_num;
+    job.chunks = (students_groups**) calloc(threads_num, sizeof(*job.chunks));
+    job.partitions = (students_groups**) calloc(threads_num, sizeof(*job.partitions));
+    job.failed = (bool*) calloc(threads_num, sizeof(*job.failed));
+    students_groups* result = NULL;
+    bool failed = (NULL == job.chunks) || (NULL == job.partitions) || 
+                  (NULL == job.failed);
+    if (!failed) {
+        tp_run(pool, threads_num, stg_chunk_task, &job);
+        for (size_t i = 0; i < threads_num; ++i) {
+            failed = failed || job.failed[i];
+        }
+    }
+    if (!failed) {
+        tp_run(pool, threads_num, stg_partition_task, &job);
+        for (size_t i = 0; i < threads_num; ++i) {
+            failed = failed || job.failed[i];
+        }
+    }
+    if (!failed) {
+        result = stg_join_partitions(&job);
+    }
+    for (size_t i = 0; (NULL != job.chunks) && (i < threads_num); ++i) {
+        stg_destroy(job.chunks + i);
+    }
+    for (size_t i = 0; (NULL != job.partitions) && (i < threads_num); ++i) {
+        stg_destroy(job.partitions + i);
+    }
+    free(job.chunks);
+    free(job.partitions);
+    free(job.failed);
+    return result;
+}
+
+students_groups* sts_group_by(const students_array* collection, 
+                              students_key_extractor key, 
+                              const students_reducer* aggregates, 
+                              size_t aggregates_num, size_t threads_num) {
+    assert(NULL != collection);
+    assert(NULL != key);
+    assert((NULL != aggregates) || (0 == aggregates_num));
+    assert(STG_MAX_AGGREGATES >= aggregates_num);
+    for (size_t a = 0; a < aggregates_num; ++a) {
+        assert(NULL != aggregates[a].init);
+        assert(NULL != aggregates[a].step);
+        assert(NULL != aggregates[a].combine);
+    }
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    if (0 == threads_num) {
+        threads_num = tp_cpus_num();
+    }
+    thread_pool* pool = NULL;
+    if ((1 < threads_num) && (STG_PARALLEL_THRESHOLD <= n)) {
+        pool = tp_default();
+    }
+    if (NULL != pool) {
+        return stg_group_by_parallel(collection, key, aggregates, aggregates_num, 
+                                     pool, threads_num);
+    }
+    students_groups* groups = stg_new(aggregates, aggregates_num);
+    if ((NULL != groups) && 
+        !stg_aggregate_range(groups, collection, key, 0, n)) {
+        stg_destroy(&groups);
+    }
+    return groups;
+}
+
+size_t stg_find(const students_groups* groups, students_group_key key) {
+    assert(NULL != groups);
+    size_t slot = groups->slots[stg_find_slot(groups, key, stg_hash(key))];
+    return (0 == slot) ? STG_NOT_FOUND : slot - 1;
+}
@@ -0,0 +1,67 @@
+#ifndef STUDENTS_GROUPS_W_OPS_H
+#define STUDENTS_GROUPS_W_OPS_H
+
+#include <stddef.h>
+#include "students_array_struct.h"
+#include "students_groups_struct.h"
+
+#define STG_NOT_FOUND SIZE_MAX
+
+/**
+ * Hash group-by: one pass over collection puts every entry into the row
+ *  of its key and feeds it to reducer->step of every aggregate
+ *  (see students_reducer)
+*/
+
+/**
+ * Key extractors for low-cardinality fields
+*/
+students_group_key stg_key_faculty(const student* entry);
+students_group_key stg_key_group(const student* entry);
+
+/**
+ * Ready aggregates over grade_book_num.
+ *  Accumulators: size_t for count, int for min and max, long long for sum.
+ *  Min and max of an empty group are INT_MAX and INT_MIN
+*/
+extern const students_reducer stg_count;
+extern const students_reducer stg_min_grade_book_num;
+extern const students_reducer stg_max_grade_book_num;
+extern const students_reducer stg_sum_grade_book_num;
+
+/**
+ * Groups entries of 'collection' by 'key' and computes 'aggregates_num'
+ *  (at most STG_MAX_AGGREGATES) aggregates for every group.
+ * 'threads_num' is the same as for sts_reduce(): big collections are
+ *  split into chunks aggregated concurrently, then groups are partitioned
+ *  by hash and every partition merges its groups from all chunks
+ *  (with reducer->combine, in chunk order). Result doesn't depend
+ *  on 'threads_num'.
+ * Key strings are borrowed, so result is valid while they are.
+ * Returns NULL if memory allocation fails
+*/
+students_groups* sts_group_by(const students_array* collection, 
+                              students_key_extractor key, 
+                              const students_reducer* aggregates, 
+                              size_t aggregates_num, size_t threads_num);
+
+/**
+ * Returns index of the group with 'key' or STG_NOT_FOUND
+*/
+size_t stg_find(const students_groups* groups, students_group_key key);
+
+/**
+ * Accumulator of 'aggregate' in 'group'
+*/
+static inline const void* stg_acc(const students_groups* groups, 
+                                  size_t group, size_t aggregate) {
+    return groups->rows + group * groups->row_size +
+           groups->acc_offsets[aggregate];
+}
+
+/**
+ * Sets *groups to NULL
+*/
+void stg_destroy(students_groups** groups);
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef STUDENTS_JOURNAL_STRUCT_H
+#define STUDENTS_JOURNAL_STRUCT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "students_array_struct.h"
+
+/**
+ * Journal file layout (host byte order): 
+ *  header | records
+ * Header names the snapshot journal continues: 'base_checksum' is
+ *  the checksum of that snapshot (see students_snapshot_header) or 0.
+ *  Next journal (see students_journal) is started before its snapshot
+ *  is saved, so it starts with both checksums equal to the base of
+ *  the journal it follows, 'parent_checksum' keeps that one and
+ *  'base_checksum' is set to the new snapshot before it takes the place
+ *  of the old one. Next journal whose checksums both differ from
+ *  the snapshot's is already folded into it.
+ * Record is: type (1 byte) | payload size (4 bytes)
+ *  | 32-bit FNV-1a of type and payload (4 bytes) | payload.
+ * Payload integers are LEB128 varints, positions are delta-encoded
+*/
+
+#define STS_JOURNAL_MAGIC "STJRNL\0"
+
+typedef struct students_journal_header {
+    char magic[8];
+    uint64_t base_checksum;
+    uint64_t parent_checksum; // Same as 'base_checksum' in the main journal
+} students_journal_header;
+
+enum students_journal_record_type {
+    STJ_RECORD_ADD = 1, // entry
+    STJ_RECORD_DELETE, // positions
+    STJ_RECORD_REPLACE, // entry, positions
+    STJ_RECORD_SORT, // keys of sts_sort_multi_key()
+};
+
+typedef struct students_journal_options {
+    // Every n-th commit calls fsync(), 0 leaves flushing to OS
+    size_t fsync_every_commits;
+    // Buffered records are committed once they take that many bytes
+    size_t commit_buffer_size;
+    // Journal bigger than that is folded into a new snapshot
+    //  in a background thread, 0 disables compaction
+    size_t compact_threshold;
+} students_journal_options;
+
+/**
+ * Collection persisted as snapshot 'path' plus journal 'path'.journal.
+ * While background compaction writes a new snapshot, 
+ *  records go to 'path'.journal.next, which then replaces the journal
+*/
+typedef struct students_journal {
+    students_array* collection; // Arena mode, changed only through stj_*
+    students_journal_options options;
+    char* snapshot_path;
+    char* journal_path;
+    char* next_journal_path;
+    int fd; // Journal records are appended to
+    uint64_t base_checksum; // Of the snapshot the main journal continues
+    size_t file_size;
+    unsigned char* buffer; // Records not committed yet
+    size_t buffer_used;
+    size_t buffer_capacity;
+    size_t commits_since_fsync;
+    // Background compaction
+    pthread_t compaction_thread;
+    bool compaction_running;
+    atomic_bool compaction_done;
+    int compaction_error; // Result of the last finished compaction
+    students_array* compaction_copy; // Borrowing copy being saved
+    bool writing_next; // 'fd' is the next journal, not renamed yet
+} students_journal;
+
+#endif
@@ -0,0 +1,986 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "students_journal_w_ops.h"
+#include "students_array_w_ops.h"
+#include "students_snapshot_w_ops.h"
+#include "students_snapshot_struct.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define STJ_DEFAULT_COMMIT_BUFFER_SIZE (64 * 1024)
+#define STJ_DEFAULT_COMPACT_THRESHOLD (64 * 1024 * 1024)
+#define STJ_RECORD_HEADER_SIZE 9
+#define STJ_VARINT_MAX_SIZE 10
+#define STJ_FNV_OFFSET 2166136261U
+#define STJ_FNV_PRIME 16777619U
+
+students_journal_options stj_default_options() {
+    students_journal_options options;
+    options.fsync_every_commits = 1;
+    options.commit_buffer_size = STJ_DEFAULT_COMMIT_BUFFER_SIZE;
+    options.compact_threshold = STJ_DEFAULT_COMPACT_THRESHOLD;
+    return options;
+}
+
+/******************** Encoding ********************/
+
+static uint32_t stj_checksum(const unsigned char* data, size_t size) {
+    uint32_t hash = STJ_FNV_OFFSET;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= STJ_FNV_PRIME;
+    }
+    return hash;
+}
+
+static unsigned char* stj_put_varint(unsigned char* out, uint64_t value) {
+    while (0x80 <= value) {
+        *out++ = (unsigned char) (value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char) value;
+    return out;
+}
+
+static bool stj_get_varint(const unsigned char** in, const unsigned char* end, 
+                           uint64_t* value) {
+    *value = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (*in == end) {
+            return false;
+        }
+        unsigned char byte = *(*in)++;
+        *value |= (uint64_t) (byte & 0x7F) << shift;
+        if (0 == (byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t stj_entry_max_size(const student* entry) {
+    return 4 * STJ_VARINT_MAX_SIZE + strlen(entry->surname) +
+           strlen(entry->faculty) + strlen(entry->group);
+}
+
+static unsigned char* stj_put_string(unsigned char* out, const char* str) {
+    size_t len = strlen(str);
+    out = stj_put_varint(out, len);
+    memcpy(out, str, len);
+    return out + len;
+}
+
+static unsigned char* stj_put_entry(unsigned char* out, const student* entry) {
+    out = stj_put_varint(out, (uint32_t) entry->grade_book_num);
+    out = stj_put_string(out, entry->surname);
+    out = stj_put_string(out, entry->faculty);
+    return stj_put_string(out, entry->group);
+}
+
+/**
+ * Positions of marked entries: their number, then gaps between them
+*/
+static unsigned char* stj_put_positions(unsigned char* out, const bool* marks, 
+                                        size_t marks_num, size_t marked_num) {
+    out = stj_put_varint(out, marked_num);
+    size_t next_pos = 0;
+    for (size_t i = 0; i < marks_num; ++i) {
+        if (marks[i]) {
+            out = stj_put_varint(out, i - next_pos);
+            next_pos = i + 1;
+        }
+    }
+    return out;
+}
+
+/**
+ * Makes room for a record with payload of up to 'payload_size' bytes, 
+ *  returns where payload goes or NULL if memory allocation fails
+*/
+static unsigned char* stj_begin_record(students_journal* journal, 
+                                       size_t payload_size) {
+    size_t needed = journal->buffer_used + STJ_RECORD_HEADER_SIZE + payload_size;
+    if (needed > journal->buffer_capacity) {
+        size_t new_capacity = (0 == journal->buffer_capacity) ? 
+            STJ_DEFAULT_COMMIT_BUFFER_SIZE : journal->buffer_capacity;
+        while (new_capacity < needed) {
+            new_capacity *= 2;
+        }
+        unsigned char* buffer = 
+            (unsigned char*) realloc(journal->buffer, new_capacity);
+        if (NULL == buffer) {
+            return NULL;
+        }
+        journal->buffer = buffer;
+        journal->buffer_capacity = new_capacity;
+    }
+    return journal->buffer + journal->buffer_used + STJ_RECORD_HEADER_SIZE;
+}
+
+/**
+ * Fills header of the record begun by stj_begin_record()
+*/
+static void stj_end_record(students_journal* journal, 
+                           enum students_journal_record_type type, 
+                           const unsigned char* payload_end) {
+    unsigned char* record = journal->buffer + journal->buffer_used;
+    uint32_t payload_size = 
+        (uint32_t) (payload_end - record - STJ_RECORD_HEADER_SIZE);
+    record[0] = (unsigned char) type;
+    memcpy(record + 1, &payload_size, sizeof(payload_size));
+    uint32_t checksum = stj_checksum(record + STJ_RECORD_HEADER_SIZE, 
+                                     payload_size);
+    checksum = (checksum ^ record[0]) * STJ_FNV_PRIME;
+    memcpy(record + 5, &checksum, sizeof(checksum));
+    journal->buffer_used += STJ_RECORD_HEADER_SIZE + payload_size;
+}
+
+/******************** Applying changes ********************/
+
+typedef struct stj_marks {
+    const student* base;
+    const bool* marks;
+} stj_marks;
+
+static bool stj_is_marked(const student* entry, const void* ctx) {
+    const stj_marks* marks = (const stj_marks*) ctx;
+    return marks->marks[entry - marks->base];
+}
+
+static size_t stj_apply_delete(students_array* collection, const bool* marks) {
+    stj_marks ctx = {collection->students, marks};
+    return st_del_all_where_ctx(collection, stj_is_marked, &ctx);
+}
+
+static int stj_apply_replace(students_array* collection, const bool* marks, 
+                             student new_entry) {
+    stj_marks ctx = {collection->students, marks};
+    return st_replace_where_ctx(collection, stj_is_marked, &ctx, new_entry);
+}
+
+/**
+ * Returns marks of entries where predicate is true (NULL if allocation
+ *  fails or collection is empty), their number goes to *marked_num
+*/
+static bool* stj_mark(const students_array* collection, 
+                      bool (*predicate)(const student*, const void*), 
+                      const void* ctx, size_t* marked_num) {
+    *marked_num = 0;
+    if ((NULL == collection->students) || (0 == collection->students_num)) {
+        return NULL;
+    }
+    bool* marks = (bool*) malloc(sizeof(*marks) * collection->students_num);
+    if (NULL == marks) {
+        return NULL;
+    }
+    for (size_t i = 0; i < collection->students_num; ++i) {
+        marks[i] = predicate(collection->students + i, ctx);
+        *marked_num += marks[i];
+    }
+    return marks;
+}
+
+/******************** Files ********************/
+
+static int stj_write_all(int fd, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*) data;
+    while (0 < size) {
+        ssize_t written = write(fd, bytes, size);
+        if (0 > written) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return STS_IO_ERROR;
+        }
+        bytes += written;
+        size -= (size_t) written;
+    }
+    return 0;
+}
+
+/**
+ * Reads whole file, *data is NULL if file doesn't exist
+*/
+static int stj_read_file(const char* path, unsigned char** data, size_t* size) {
+    *data = NULL;
+    *size = 0;
+    FILE* file = fopen(path, "rb");
+    if (NULL == file) {
+        return (ENOENT == errno) ? 0 : STS_IO_ERROR;
+    }
+    size_t capacity = 0;
+    int result = 0;
+    while (0 == result) {
+        if (*size == capacity) {
+            capacity = (0 == capacity) ? STJ_DEFAULT_COMMIT_BUFFER_SIZE : capacity * 2;
+            unsigned char* new_data = (unsigned char*) realloc(*data, capacity);
+            if (NULL == new_data) {
+                result = STS_MEM_ALLOC_ERROR;
+                break;
+            }
+            *data = new_data;
+        }
+        size_t read_num = fread(*data + *size, 1, capacity - *size, file);
+        *size += read_num;
+        if (0 == read_num) {
+            result = ferror(file) ? STS_IO_ERROR : 0;
+            break;
+        }
+    }
+    fclose(file);
+    if (0 != result) {
+        free(*data);
+        *data = NULL;
+        return result;
+    }
+    if (NULL == *data) {
+        // Empty file still has to be told from a missing one
+        *data = (unsigned char*) malloc(1);
+        result = (NULL == *data) ? STS_MEM_ALLOC_ERROR : 0;
+    }
+    return result;
+}
+
+static int stj_read_snapshot_checksum(const char* path, uint64_t* checksum) {
+    FILE* file = fopen(path, "rb");
+    if (NULL == file) {
+        return STS_IO_ERROR;
+    }
+    students_snapshot_header header;
+    size_t read_num = fread(&header, sizeof(header), 1, file);
+    fclose(file);
+    if (1 != read_num) {
+        return STS_BAD_SNAPSHOT;
+    }
+    *checksum = header.checksum;
+    return 0;
+}
+
+/**
+ * Creates empty journal continuing snapshot with 'base_checksum'
+ *  in place of the one at 'path': it is written to 'path'.tmp, 
+ *  fsync()'ed and renamed. Returns descriptor open for writing or -1
+*/
+static int stj_create_journal(const char* path, uint64_t base_checksum) {
+    size_t path_len = strlen(path);
+    char* tmp_path = (char*) malloc(path_len + sizeof(".tmp"));
+    if (NULL == tmp_path) {
+        return -1;
+    }
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, ".tmp", sizeof(".tmp"));
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    students_journal_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STS_JOURNAL_MAGIC, sizeof(header.magic));
+    header.base_checksum = base_checksum;
+    header.parent_checksum = base_checksum;
+    if ((-1 != fd) && 
+        ((0 != stj_write_all(fd, &header, sizeof(header))) || 
+         (0 != fsync(fd)) || (0 != rename(tmp_path, path)) || 
+         (0 != sts_fsync_dir_of(path)))) {
+        close(fd);
+        remove(tmp_path);
+        fd = -1;
+    }
+    free(tmp_path);
+    return fd;
+}
+
+static char* stj_concat(const char* str, const char* suffix) {
+    size_t str_len = strlen(str);
+    size_t suffix_len = strlen(suffix);
+    char* result = (char*) malloc(str_len + suffix_len + 1);
+    if (NULL != result) {
+        memcpy(result, str, str_len);
+        memcpy(result + str_len, suffix, suffix_len + 1);
+    }
+    return result;
+}
+
+/******************** Recovery ********************/
+
+/**
+ * Decodes entry into NUL-terminated copies of its strings in *scratch
+*/
+static bool stj_get_entry(const unsigned char** in, const unsigned char* end, 
+                          char** scratch, size_t* scratch_size, student* entry) {
+    uint64_t grade_book_num = 0;
+    uint64_t lens[3];
+    const unsigned char* strs[3];
+    if (!stj_get_varint(in, end, &grade_book_num) || (UINT32_MAX < grade_book_num)) {
+        return false;
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        if (!stj_get_varint(in, end, lens + i) || 
+            (lens[i] > (uint64_t) (end - *in))) {
+            return false;
+        }
+        strs[i] = *in;
+        *in += lens[i];
+        total += lens[i] + 1;
+    }
+    if (*scratch_size < total) {
+        char* new_scratch = (char*) realloc(*scratch, total);
+        if (NULL == new_scratch) {
+            return false;
+        }
+        *scratch = new_scratch;
+        *scratch_size = total;
+    }
+    char* out[3];
+    char* dst = *scratch;
+    for (size_t i = 0; i < 3; ++i) {
+        out[i] = dst;
+        memcpy(dst, strs[i], lens[i]);
+        dst[lens[i]] = '\0';
+        dst += lens[i] + 1;
+    }
+    entry->grade_book_num = (int) (uint32_t) grade_book_num;
+    entry->surname = out[0];
+    entry->faculty = out[1];
+    entry->group = out[2];
+    return true;
+}
+
+/**
+ * Decodes positions into marks for collection of 'marks_num' entries
+*/
+static bool stj_get_positions(const unsigned char** in, const unsigned char* end, 
+                              bool* marks, size_t marks_num) {
+    uint64_t marked_num = 0;
+    if (!stj_get_varint(in, end, &marked_num) || (marked_num > marks_num)) {
+        return false;
+    }
+    memset(marks, 0, sizeof(*marks) * marks_num);
+    uint64_t next_pos = 0;
+    for (uint64_t i = 0; i < marked_num; ++i) {
+        uint64_t gap = 0;
+        if (!stj_get_varint(in, end, &gap) || (gap >= marks_num - next_pos)) {
+            return false;
+        }
+        marks[next_pos + gap] = true;
+        next_pos += gap + 1;
+    }
+    return true;
+}
+
+typedef struct stj_replay {
+    students_array* collection;
+    char* scratch;
+    size_t scratch_size;
+    bool* marks;
+} stj_replay;
+
+/**
+ * Applies one record, returns 0, STS_MEM_ALLOC_ERROR
+ *  or STS_BAD_SNAPSHOT for a record that doesn't fit collection
+*/
+static int stj_replay_record(stj_replay* replay, unsigned char type, 
+                             const unsigned char* in, const unsigned char* end) {
+    students_array* collection = replay->collection;
+    size_t students_num = collection->students_num;
+    student entry;
+    if ((STJ_RECORD_DELETE == type) || (STJ_RECORD_REPLACE == type)) {
+        free(replay->marks);
+        replay->marks = (bool*) malloc(sizeof(bool) * (students_num + 1));
+        if (NULL == replay->marks) {
+            return STS_MEM_ALLOC_ERROR;
+        }
+    }
+    switch (type) {
+        case STJ_RECORD_ADD:
+            if (!stj_get_entry(&in, end, &replay->scratch, 
+                               &replay->scratch_size, &entry)) {
+                return STS_BAD_SNAPSHOT;
+            }
+            return st_add(collection, entry);
+        case STJ_RECORD_DELETE:
+            if (!stj_get_positions(&in, end, replay->marks, students_num)) {
+                return STS_BAD_SNAPSHOT;
+            }
+            stj_apply_delete(collection, replay->marks);
+            return 0;
+        case STJ_RECORD_REPLACE:
+            if (!stj_get_entry(&in, end, &replay->scratch, 
+                               &replay->scratch_size, &entry) || 
+                !stj_get_positions(&in, end, replay->marks, students_num)) {
+                return STS_BAD_SNAPSHOT;
+            }
+            return stj_apply_replace(collection, replay->marks, entry);
+        case STJ_RECORD_SORT: {
+            uint64_t keys_num = 0;
+            students_sort_spec keys[STS_MAX_SORT_KEYS];
+            if (!stj_get_varint(&in, end, &keys_num) || 
+                (0 == keys_num) || (STS_MAX_SORT_KEYS < keys_num) || 
+                ((uint64_t) (end - in) < 2 * keys_num)) {
+                return STS_BAD_SNAPSHOT;
+            }
+            for (size_t i = 0; i < keys_num; ++i) {
+                if ((STS_NOT_SORTED == in[2 * i]) || 
+                    (STS_SORTED_BY_GROUP < in[2 * i])) {
+                    return STS_BAD_SNAPSHOT;
+                }
+                keys[i].key = (enum students_sort_key) in[2 * i];
+                keys[i].desc = (0 != in[2 * i + 1]);
+            }
+            sts_sort_multi_key(collection, keys, keys_num);
+            return 0;
+        }
+        default:
+            return STS_BAD_SNAPSHOT;
+    }
+}
+
+/**
+ * Replays journal in 'data'. *valid_size is set to the size of its part
+ *  before the first torn or damaged record.
+ *  File that is too short to hold a header has no records
+*/
+static int stj_replay_journal(stj_replay* replay, const unsigned char* data, 
+                              size_t size, size_t* valid_size) {
+    *valid_size = 0;
+    if (sizeof(students_journal_header) > size) {
+        return 0;
+    }
+    size_t offset = sizeof(students_journal_header);
+    while (STJ_RECORD_HEADER_SIZE <= size - offset) {
+        const unsigned char* record = data + offset;
+        uint32_t payload_size = 0;
+        uint32_t checksum = 0;
+        memcpy(&payload_size, record + 1, sizeof(payload_size));
+        memcpy(&checksum, record + 5, sizeof(checksum));
+        if (payload_size > size - offset - STJ_RECORD_HEADER_SIZE) {
+            break;
+        }
+        const unsigned char* payload = record + STJ_RECORD_HEADER_SIZE;
+        uint32_t expected = stj_checksum(payload, payload_size);
+        expected = (expected ^ record[0]) * STJ_FNV_PRIME;
+        if (expected != checksum) {
+            break;
+        }
+        int result = stj_replay_record(replay, record[0], payload, 
+                                       payload + payload_size);
+        if (0 != result) {
+            return result;
+        }
+        offset += STJ_RECORD_HEADER_SIZE + payload_size;
+    }
+    *valid_size = offset;
+    return 0;
+}
+
+/**
+ * Checks journal header and tells whether journal continues snapshot
+ *  with 'snapshot_checksum'. Next journal also continues it
+ *  through the main journal (see students_journal_header)
+*/
+static int stj_check_header(const unsigned char* data, size_t size, 
+                            uint64_t snapshot_checksum, bool next, 
+                            bool* continues) {
+    students_journal_header header;
+    if (sizeof(header) > size) {
+        *continues = false;
+        return 0;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (0 != memcmp(header.magic, STS_JOURNAL_MAGIC, sizeof(header.magic))) {
+        return STS_BAD_SNAPSHOT;
+    }
+    *continues = (snapshot_checksum == header.base_checksum) || 
+        (next && (snapshot_checksum == header.parent_checksum));
+    return 0;
+}
+
+/**
+ * Fills collection from snapshot, *base_checksum is 0 if there is none
+*/
+static int stj_load_snapshot(students_journal* journal, 
+                             uint64_t* base_checksum) {
+    *base_checksum = 0;
+    if (0 != access(journal->snapshot_path, F_OK)) {
+        return 0;
+    }
+    int error = 0;
+    students_array* snapshot = 
+        sts_snapshot_load(journal->snapshot_path, true, &error);
+    if (NULL == snapshot) {
+        return error;
+    }
+    *base_checksum = 
+        ((const students_snapshot_header*) snapshot->snapshot_map)->checksum;
+    int result = st_add_bulk_copy(journal->collection, snapshot->students, 
+                                  snapshot->students_num);
+    journal->collection->sort_key = snapshot->sort_key;
+    journal->collection->sort_desc = snapshot->sort_desc;
+    sts_destroy_all(&snapshot);
+    return result;
+}
+
+/**
+ * Saves snapshot of the whole collection and starts an empty journal
+ *  after it, the next journal is not needed after that
+*/
+static int stj_compact_now(students_journal* journal) {
+    uint64_t checksum = 0;
+    int result = sts_snapshot_save(journal->collection, journal->snapshot_path);
+    if (0 == result) {
+        result = stj_read_snapshot_checksum(journal->snapshot_path, &checksum);
+    }
+    if (0 != result) {
+        return result;
+    }
+    int fd = stj_create_journal(journal->journal_path, checksum);
+    if (-1 == fd) {
+        return STS_IO_ERROR;
+    }
+    if (-1 != journal->fd) {
+        close(journal->fd);
+    }
+    journal->fd = fd;
+    journal->base_checksum = checksum;
+    journal->file_size = sizeof(students_journal_header);
+    journal->writing_next = false;
+    // Snapshot has its records, so it's skipped if removal is lost
+    remove(journal->next_journal_path);
+    return 0;
+}
+
+static int stj_recover(students_journal* journal) {
+    uint64_t base_checksum = 0;
+    int result = stj_load_snapshot(journal, &base_checksum);
+    stj_replay replay = {journal->collection, NULL, 0, NULL};
+    unsigned char* data = NULL;
+    size_t size = 0;
+    size_t valid_size = 0;
+    bool continues = false;
+    if (0 == result) {
+        result = stj_read_file(journal->journal_path, &data, &size);
+    }
+    if ((0 == result) && (NULL != data)) {
+        result = stj_check_header(data, size, base_checksum, false, &continues);
+    }
+    // Journal of an older snapshot was already folded into this one
+    if ((0 == result) && continues) {
+        result = stj_replay_journal(&replay, data, size, &valid_size);
+    }
+    free(data);
+    bool next_exists = false;
+    bool next_continues = false;
+    if (0 == result) {
+        result = stj_read_file(journal->next_journal_path, &data, &size);
+        next_exists = (NULL != data);
+    }
+    if ((0 == result) && next_exists) {
+        result = stj_check_header(data, size, base_checksum, true, 
+                                  &next_continues);
+    }
+    // Compaction may have saved snapshot with its records and crashed
+    //  before removing it
+    if ((0 == result) && next_continues) {
+        size_t next_valid_size = 0;
+        result = stj_replay_journal(&replay, data, size, &next_valid_size);
+    }
+    if (next_exists) {
+        free(data);
+    }
+    free(replay.scratch);
+    free(replay.marks);
+    if (0 != result) {
+        return result;
+    }
+    if (next_exists) {
+        return stj_compact_now(journal);
+    }
+    journal->base_checksum = base_checksum;
+    if (!continues) {
+        journal->fd = stj_create_journal(journal->journal_path, base_checksum);
+        journal->file_size = sizeof(students_journal_header);
+        return (-1 == journal->fd) ? STS_IO_ERROR : 0;
+    }
+    // Torn tail is cut off, new records go right after valid ones
+    journal->fd = open(journal->journal_path, O_WRONLY);
+    if ((-1 == journal->fd) || (0 != ftruncate(journal->fd, (off_t) valid_size)) || 
+        ((off_t) -1 == lseek(journal->fd, (off_t) valid_size, SEEK_SET))) {
+        return STS_IO_ERROR;
+    }
+    journal->file_size = valid_size;
+    return 0;
+}
+
+students_journal* stj_open(const char* path, 
+                           const students_journal_options* options, 
+                           int* error) {
+    assert(NULL != path);
+    assert(NULL != error);
+    *error = 0;
+    students_journal* journal = (students_journal*) malloc(sizeof(*journal));
+    if (NULL == journal) {
+        *error = STS_MEM_ALLOC_ERROR;
+        return NULL;
+    }
+    journal->options = (NULL == options) ? stj_default_options() : *options;
+    journal->collection = st_new_array_arena(0);
+    journal->snapshot_path = strdup(path);
+    journal->journal_path = stj_concat(path, ".journal");
+    journal->next_journal_path = stj_concat(path, ".journal.next");
+    journal->fd = -1;
+    journal->base_checksum = 0;
+    journal->file_size = 0;
+    journal->buffer = NULL;
+    journal->buffer_used = 0;
+    journal->buffer_capacity = 0;
+    journal->commits_since_fsync = 0;
+    journal->compaction_running = false;
+    atomic_init(&journal->compaction_done, false);
+    journal->compaction_error = 0;
+    journal->compaction_copy = NULL;
+    journal->writing_next = false;
+    if ((NULL == journal->collection) || (NULL == journal->snapshot_path) || 
+        (NULL == journal->journal_path) || (NULL == journal->next_journal_path)) {
+        *error = STS_MEM_ALLOC_ERROR;
+    }
+    else {
+        *error = stj_recover(journal);
+    }
+    if (0 != *error) {
+        stj_close(&journal);
+        return NULL;
+    }
+    return journal;
+}
+
+/******************** Commit and compaction ********************/
+
+/**
+ * Body of compaction thread: saves the copy as 'path'.new, lets the next
+ *  journal continue it, then puts it in place of the old snapshot
+ *  and the next journal in place of the old journal
+*/
+static void* stj_compaction_main(void* arg) {
+    students_journal* journal = (students_journal*) arg;
+    uint64_t checksum = 0;
+    char* new_snapshot_path = stj_concat(journal->snapshot_path, ".new");
+    int result = (NULL == new_snapshot_path) ? STS_MEM_ALLOC_ERROR : 
+        sts_snapshot_save(journal->compaction_copy, new_snapshot_path);
+    if (0 == result) {
+        result = stj_read_snapshot_checksum(new_snapshot_path, &checksum);
+    }
+    // Descriptor is not moved by pwrite(), so appends may go on meanwhile
+    if ((0 == result) && 
+        ((sizeof(checksum) != pwrite(journal->fd, &checksum, sizeof(checksum), 
+                                     offsetof(students_journal_header, 
+                                              base_checksum))) || 
+         (0 != fsync(journal->fd)) || 
+         (0 != rename(new_snapshot_path, journal->snapshot_path)))) {
+        result = STS_IO_ERROR;
+    }
+    if (0 == result) {
+        result = sts_fsync_dir_of(journal->snapshot_path);
+    }
+    if ((0 == result) && 
+        (0 != rename(journal->next_journal_path, journal->journal_path))) {
+        result = STS_IO_ERROR;
+    }
+    if (0 == result) {
+        result = sts_fsync_dir_of(journal->journal_path);
+    }
+    if (0 == result) {
+        journal->base_checksum = checksum;
+    } else if (NULL != new_snapshot_path) {
+        remove(new_snapshot_path);
+    }
+    free(new_snapshot_path);
+    sts_destroy_all(&journal->compaction_copy);
+    journal->compaction_error = result;
+    atomic_store(&journal->compaction_done, true);
+    return NULL;
+}
+
+static void stj_join_compaction(students_journal* journal, bool wait) {
+    if (!journal->compaction_running || 
+        (!wait && !atomic_load(&journal->compaction_done))) {
+        return;
+    }
+    pthread_join(journal->compaction_thread, NULL);
+    journal->compaction_running = false;
+    if (0 == journal->compaction_error) {
+        journal->writing_next = false;
+    }
+}
+
+/**
+ * Switches appends to the next journal and saves a copy of collection
+ *  in background. If the next journal is still in use because previous
+ *  compaction failed, compacts right away instead
+*/
+static int stj_start_compaction(students_journal* journal) {
+    if (journal->writing_next) {
+        return stj_compact_now(journal);
+    }
+    students_array* copy = 
+        st_new_array_borrowing(journal->collection->students_num);
+    if (NULL == copy) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    // Arena strings are never freed or changed, so the copy may share them
+    if (0 != journal->collection->students_num) {
+        memcpy(copy->students, journal->collection->students, 
+               sizeof(*copy->students) * journal->collection->students_num);
+    }
+    copy->students_num = journal->collection->students_num;
+    copy->sort_key = journal->collection->sort_key;
+    copy->sort_desc = journal->collection->sort_desc;
+    // Records of the old journal must be durable before any of the next one
+    int fd = -1;
+    if (0 == fsync(journal->fd)) {
+        fd = open(journal->next_journal_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    }
+    // Until the new snapshot is in place, next journal follows the old one
+    students_journal_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STS_JOURNAL_MAGIC, sizeof(header.magic));
+    header.base_checksum = journal->base_checksum;
+    header.parent_checksum = journal->base_checksum;
+    if ((-1 == fd) || (0 != stj_write_all(fd, &header, sizeof(header))) || 
+        (0 != sts_fsync_dir_of(journal->next_journal_path))) {
+        if (-1 != fd) {
+            close(fd);
+            remove(journal->next_journal_path);
+        }
+        sts_destroy_all(&copy);
+        return STS_IO_ERROR;
+    }
+    close(journal->fd);
+    journal->fd = fd;
+    journal->file_size = sizeof(header);
+    journal->writing_next = true;
+    journal->compaction_copy = copy;
+    atomic_store(&journal->compaction_done, false);
+    if (0 != pthread_create(&journal->compaction_thread, NULL, 
+                            stj_compaction_main, journal)) {
+        stj_compaction_main(journal);
+        journal->compaction_running = false;
+        if (0 == journal->compaction_error) {
+            journal->writing_next = false;
+        }
+        return journal->compaction_error;
+    }
+    journal->compaction_running = true;
+    return 0;
+}
+
+int stj_commit(students_journal* journal) {
+    assert(NULL != journal);
+    stj_join_compaction(journal, false);
+    if (0 != journal->buffer_used) {
+        if (0 != stj_write_all(journal->fd, journal->buffer, 
+                               journal->buffer_used)) {
+            // Torn part is cut off, so that retry writes right after
+            //  committed records and replay doesn't stop before it
+            int truncate_result = ftruncate(journal->fd, 
+                                            (off_t) journal->file_size);
+            (void) truncate_result;
+            lseek(journal->fd, (off_t) journal->file_size, SEEK_SET);
+            return STS_IO_ERROR;
+        }
+        journal->file_size += journal->buffer_used;
+        journal->buffer_used = 0;
+        journal->commits_since_fsync++;
+        if ((0 != journal->options.fsync_every_commits) && 
+            (journal->commits_since_fsync >= 
+             journal->options.fsync_every_commits)) {
+            if (0 != fsync(journal->fd)) {
+                return STS_IO_ERROR;
+            }
+            journal->commits_since_fsync = 0;
+        }
+    }
+    if ((0 != journal->options.compact_threshold) && 
+        (journal->file_size > journal->options.compact_threshold) && 
+        !journal->compaction_running) {
+        return stj_start_compaction(journal);
+    }
+    return 0;
+}
+
+int stj_compact(students_journal* journal) {
+    assert(NULL != journal);
+    int result = stj_commit(journal);
+    stj_join_compaction(journal, true);
+    if (0 != result) {
+        return result;
+    }
+    return stj_compact_now(journal);
+}
+
+/**
+ * Commits if buffered records have grown past the limit
+*/
+static int stj_after_record(students_journal* journal) {
+    if (journal->buffer_used >= journal->options.commit_buffer_size) {
+        return stj_commit(journal);
+    }
+    return 0;
+}
+
+int stj_close(students_journal** journal) {
+    assert(NULL != journal);
+    if (NULL == *journal) {
+        return 0;
+    }
+    students_journal* to_free = *journal;
+    int result = (-1 == to_free->fd) ? 0 : stj_commit(to_free);
+    stj_join_compaction(to_free, true);
+    if ((0 == result) && (0 != to_free->compaction_error)) {
+        result = to_free->compaction_error;
+    }
+    if (-1 != to_free->fd) {
+        close(to_free->fd);
+    }
+    sts_destroy_all(&to_free->collection);
+    free(to_free->snapshot_path);
+    free(to_free->journal_path);
+    free(to_free->next_journal_path);
+    free(to_free->buffer);
+    free(to_free);
+    *journal = NULL;
+    return result;
+}
+
+/******************** Mutations ********************/
+
+int stj_add(students_journal* journal, student entry) {
+    assert(NULL != journal);
+    unsigned char* payload = stj_begin_record(journal, stj_entry_max_size(&entry));
+    if ((NULL == payload) || (0 != st_add(journal->collection, entry))) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    stj_end_record(journal, STJ_RECORD_ADD, stj_put_entry(payload, &entry));
+    return stj_after_record(journal);
+}
+
+/**
+ * Deletes marked entries and records their positions
+*/
+static int stj_delete_marked(students_journal* journal, bool* marks, 
+                             size_t marked_num) {
+    size_t marks_num = journal->collection->students_num;
+    unsigned char* payload = stj_begin_record(journal, 
+        (marked_num + 1) * STJ_VARINT_MAX_SIZE);
+    if (NULL == payload) {
+        free(marks);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    stj_apply_delete(journal->collection, marks);
+    stj_end_record(journal, STJ_RECORD_DELETE, 
+                   stj_put_positions(payload, marks, marks_num, marked_num));
+    free(marks);
+    return stj_after_record(journal);
+}
+
+int stj_del_where(students_journal* journal, 
+                  bool (*predicate)(const student*)) {
+    assert(NULL != journal);
+    assert(NULL != predicate);
+    students_array* collection = journal->collection;
+    size_t pos = 0;
+    while ((pos < collection->students_num) && 
+           !predicate(collection->students + pos)) {
+        ++pos;
+    }
+    if (pos == collection->students_num) {
+        return 0;
+    }
+    bool* marks = (bool*) calloc(collection->students_num, sizeof(*marks));
+    if (NULL == marks) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    marks[pos] = true;
+    return stj_delete_marked(journal, marks, 1);
+}
+
+int stj_del_all_where_ctx(students_journal* journal, 
+                          bool (*predicate)(const student*, const void*), 
+                          const void* ctx) {
+    assert(NULL != journal);
+    assert(NULL != predicate);
+    size_t marked_num = 0;
+    bool* marks = stj_mark(journal->collection, predicate, ctx, &marked_num);
+    if (0 == marked_num) {
+        bool failed = (NULL == marks) && (0 != journal->collection->students_num);
+        free(marks);
+        return failed ? STS_MEM_ALLOC_ERROR : 0;
+    }
+    return stj_delete_marked(journal, marks, marked_num);
+}
+
+typedef struct stj_plain_predicate {
+    bool (*predicate)(const student*);
+} stj_plain_predicate;
+
+static bool stj_call_plain_predicate(const student* entry, const void* ctx) {
+    return ((const stj_plain_predicate*) ctx)->predicate(entry);
+}
+
+int stj_replace_where(students_journal* journal, 
+                      bool (*predicate)(const student*), 
+                      student new_entry) {
+    assert(NULL != journal);
+    assert(NULL != predicate);
+    stj_plain_predicate plain = {predicate};
+    size_t marked_num = 0;
+    bool* marks = stj_mark(journal->collection, stj_call_plain_predicate, 
+                           &plain, &marked_num);
+    if (0 == marked_num) {
+        bool failed = (NULL == marks) && (0 != journal->collection->students_num);
+        free(marks);
+        return failed ? STS_MEM_ALLOC_ERROR : 0;
+    }
+    size_t marks_num = journal->collection->students_num;
+    unsigned char* payload = stj_begin_record(journal, 
+        stj_entry_max_size(&new_entry) + (marked_num + 1) * STJ_VARINT_MAX_SIZE);
+    if ((NULL == payload) || 
+        (0 != stj_apply_replace(journal->collection, marks, new_entry))) {
+        free(marks);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    unsigned char* payload_end = stj_put_entry(payload, &new_entry);
+    payload_end = stj_put_positions(payload_end, marks, marks_num, marked_num);
+    stj_end_record(journal, STJ_RECORD_REPLACE, payload_end);
+    free(marks);
+    return stj_after_record(journal);
+}
+
+int stj_sort_multi_key(students_journal* journal, 
+                       const students_sort_spec* keys, size_t keys_num) {
+    assert(NULL != journal);
+    assert((NULL != keys) || (0 == keys_num));
+    assert(STS_MAX_SORT_KEYS >= keys_num);
+    if (0 == keys_num) {
+        return 0;
+    }
+    unsigned char* payload = stj_begin_record(journal, 
+        STJ_VARINT_MAX_SIZE + 2 * keys_num);
+    if (NULL == payload) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    sts_sort_multi_key(journal->collection, keys, keys_num);
+    unsigned char* payload_end = stj_put_varint(payload, keys_num);
+    for (size_t i = 0; i < keys_num; ++i) {
+        *payload_end++ = (unsigned char) keys[i].key;
+        *payload_end++ = (unsigned char) keys[i].desc;
+    }
+    stj_end_record(journal, STJ_RECORD_SORT, payload_end);
+    return stj_after_record(journal);
+}
@@ -0,0 +1,79 @@
+#ifndef STUDENTS_JOURNAL_W_OPS_H
+#define STUDENTS_JOURNAL_W_OPS_H
+
+#include <stdbool.h>
+#include "students_journal_struct.h"
+
+/**
+ * Write-ahead journal for students_array: every mutation made through
+ *  stj_* appends a compact record to an in-memory buffer, stj_commit()
+ *  writes buffered records at once (group commit) and calls fsync()
+ *  as often as options say. Mutations not committed are lost on crash.
+ * Return codes are the ones of students_array_ops_return_codes
+*/
+
+/**
+ * fsync() every commit, commit every 64 KiB, compact past 64 MiB
+*/
+students_journal_options stj_default_options();
+
+/**
+ * Recovers collection from snapshot 'path' (if it exists) and its journal, 
+ *  a torn record at the end of journal is dropped.
+ * 'options' may be NULL for stj_default_options().
+ * Returns NULL on failure and sets *error to STS_MEM_ALLOC_ERROR, 
+ *  STS_IO_ERROR or STS_BAD_SNAPSHOT
+*/
+students_journal* stj_open(const char* path, 
+                           const students_journal_options* options, 
+                           int* error);
+
+/**
+ * Same as st_add(), entry's strings are copied
+*/
+int stj_add(students_journal* journal, student entry);
+
+/**
+ * Same as st_del_where() and st_del_all_where_ctx(), 
+ *  journal stores positions of deleted entries
+*/
+int stj_del_where(students_journal* journal, 
+                  bool (*predicate)(const student*));
+int stj_del_all_where_ctx(students_journal* journal, 
+                          bool (*predicate)(const student*, const void*), 
+                          const void* ctx);
+
+/**
+ * Same as st_replace_where(), entry's strings are copied
+*/
+int stj_replace_where(students_journal* journal, 
+                      bool (*predicate)(const student*), 
+                      student new_entry);
+
+/**
+ * Same as sts_sort_multi_key(), which is deterministic, 
+ *  so journal stores only keys
+*/
+int stj_sort_multi_key(students_journal* journal, 
+                       const students_sort_spec* keys, size_t keys_num);
+
+/**
+ * Writes buffered records. Starts background compaction
+ *  if journal has grown past options.compact_threshold.
+ * If writing fails, records stay buffered and the next commit
+ *  writes them again in place of the failed part
+*/
+int stj_commit(students_journal* journal);
+
+/**
+ * Commits and folds everything into a new snapshot right away
+*/
+int stj_compact(students_journal* journal);
+
+/**
+ * Commits, waits for compaction and frees everything, sets *journal to NULL.
+ * Returns result of the last commit or compaction
+*/
+int stj_close(students_journal** journal);
+
+#endif
@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+
+#include "students_loader_w_ops.h"
+#include "students_array_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define STL_BLOCK_SIZE (1 << 20)
+#define STL_BATCH_SIZE 1024
+#define STL_FIELDS_NUM 4
+#define STL_LINES_PER_RECORD 4
+
+typedef struct st_loader {
+    students_array* collection;
+    enum students_input_format format;
+    FILE* errstream;
+    size_t line_num; // Number of the first line not parsed yet
+    size_t malformed_num;
+    // Entries point into read buffer until batch is flushed
+    student batch[STL_BATCH_SIZE];
+    size_t batch_num;
+} st_loader;
+
+static void stl_report(st_loader* loader, size_t line_num, const char* reason) {
+    loader->malformed_num++;
+    if (NULL != loader->errstream) {
+        fprintf(loader->errstream, "line %zu: %s\n", line_num, reason);
+    }
+}
+
+static int stl_flush(st_loader* loader) {
+    int result = st_add_bulk_copy(loader->collection, loader->batch, 
+                                  loader->batch_num);
+    loader->batch_num = 0;
+    return result;
+}
+
+/**
+ * Accepts non-negative decimal numbers fitting in int
+*/
+static bool stl_parse_grade_book_num(const char* str, int* result) {
+    if ('\0' == *str) {
+        return false;
+    }
+    long long value = 0;
+    for (; '\0' != *str; ++str) {
+        if ((*str < '0') || (*str > '9')) {
+            return false;
+        }
+        value = value * 10 + (*str - '0');
+        if (INT_MAX < value) {
+            return false;
+        }
+    }
+    *result = (int) value;
+    return true;
+}
+
+/**
+ * Puts record made of 'fields' to batch, 
+ *  'grade_line_num' is reported if grade book number is invalid
+*/
+static int stl_push(st_loader* loader, char* fields[STL_FIELDS_NUM], 
+                    size_t grade_line_num) {
+    student* entry = loader->batch + loader->batch_num;
+    if (!stl_parse_grade_book_num(fields[1], &(entry->grade_book_num))) {
+        stl_report(loader, grade_line_num, "invalid grade book number");
+        return 0;
+    }
+    entry->surname = fields[0];
+    entry->faculty = fields[2];
+    entry->group = fields[3];
+    loader->batch_num++;
+    if (STL_BATCH_SIZE == loader->batch_num) {
+        return stl_flush(loader);
+    }
+    return 0;
+}
+
+/**
+ * Turns line [begin, end) into a string, 'end' points to its '\n'
+*/
+static void stl_terminate_line(char* begin, char* end) {
+    if ((end > begin) && ('\r' == end[-1])) {
+        --end;
+    }
+    *end = '\0';
+}
+
+/**
+ * Splits null-terminated 'line' by 'separator' in place
+*/
+static bool stl_split_plain(char* line, char separator, 
+                            char* fields[STL_FIELDS_NUM]) {
+    size_t fields_num = 0;
+    char* field = line;
+    while (true) {
+        if (STL_FIELDS_NUM == fields_num) {
+            return false;
+        }
+        fields[fields_num++] = field;
+        char* next = strchr(field, separator);
+        if (NULL == next) {
+            break;
+        }
+        *next = '\0';
+        field = next + 1;
+    }
+    return STL_FIELDS_NUM == fields_num;
+}
+
+/**
+ * Unquotes field starting at '"' in place, 
+ *  returns pointer past the closing quote or NULL if there is none
+*/
+static char* stl_unquote(char* field) {
+    char* src = field + 1;
+    char* dst = field;
+    while (true) {
+        char* quote = strchr(src, '"');
+        if (NULL == quote) {
+            return NULL;
+        }
+        memmove(dst, src, quote - src);
+        dst += quote - src;
+        if ('"' != quote[1]) {
+            *dst = '\0';
+            return quote + 1;
+        }
+        *dst++ = '"';
+        src = quote + 2;
+    }
+}
+
+static bool stl_split_csv(char* line, char* fields[STL_FIELDS_NUM]) {
+    size_t fields_num = 0;
+    char* field = line;
+    while (true) {
+        if (STL_FIELDS_NUM == fields_num) {
+            return false;
+        }
+        fields[fields_num++] = field;
+        char* next = NULL;
+        if ('"' == *field) {
+            next = stl_unquote(field);
+            if ((NULL == next) || (',' != *next && '\0' != *next)) {
+                return false;
+            }
+            if ('\0' == *next) {
+                break;
+            }
+        }
+        else {
+            next = strchr(field, ',');
+            // Stray quote: most likely the rest of a quoted field
+            //  broken by a line break
+            char* quote = strchr(field, '"');
+            if ((NULL != quote) && ((NULL == next) || (quote < next))) {
+                return false;
+            }
+            if (NULL == next) {
+                break;
+            }
+        }
+        *next = '\0';
+        field = next + 1;
+    }
+    return STL_FIELDS_NUM == fields_num;
+}
+
+/**
+ * Parses complete records in data[0, data_len), 
+ *  returns number of bytes they take
+*/
+static size_t stl_parse_block(st_loader* loader, char* data, size_t data_len, 
+                              int* error) {
+    size_t lines_per_record = 
+        (STS_FORMAT_LINES == loader->format) ? STL_LINES_PER_RECORD : 1;
+    char* record = data;
+    char* data_end = data + data_len;
+    while ((0 == *error) && (record < data_end)) {
+        char* lines[STL_LINES_PER_RECORD];
+        char* line_ends[STL_LINES_PER_RECORD];
+        char* line = record;
+        size_t lines_num = 0;
+        for (; lines_num < lines_per_record; ++lines_num) {
+            line_ends[lines_num] = memchr(line, '\n', data_end - line);
+            if (NULL == line_ends[lines_num]) {
+                break;
+            }
+            lines[lines_num] = line;
+            line = line_ends[lines_num] + 1;
+        }
+        if (lines_num < lines_per_record) {
+            // Record continues in the next block, so it is left intact
+            break;
+        }
+        for (size_t i = 0; i < lines_per_record; ++i) {
+            stl_terminate_line(lines[i], line_ends[i]);
+        }
+        size_t record_line_num = loader->line_num;
+        loader->line_num += lines_per_record;
+        record = line;
+        if (STS_FORMAT_LINES == loader->format) {
+            *error = stl_push(loader, lines, record_line_num + 1);
+            continue;
+        }
+        if ('\0' == lines[0][0]) {
+            continue;
+        }
+        char* fields[STL_FIELDS_NUM];
+        bool split = (STS_FORMAT_CSV == loader->format) ?
+            stl_split_csv(lines[0], fields) : 
+            stl_split_plain(lines[0], '\t', fields);
+        if (!split) {
+            stl_report(loader, record_line_num, "expected 4 fields");
+            continue;
+        }
+        *error = stl_push(loader, fields, record_line_num);
+    }
+    return record - data;
+}
+
+int st_load(students_array* collection, FILE* istream, 
+            enum students_input_format format, FILE* errstream, 
+            size_t* malformed_num) {
+    assert(NULL != collection);
+    assert(NULL != istream);
+    assert(STS_BORROWS_STRINGS != collection->ownership);
+    st_loader* loader = (st_loader*) malloc(sizeof(*loader));
+    size_t capacity = STL_BLOCK_SIZE;
+    // One extra byte for '\n' after the last line if it has none
+    char* buf = (char*) malloc(capacity + 1);
+    if (NULL == loader || NULL == buf) {
+        free(loader);
+        free(buf);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    loader->collection = collection;
+    loader->format = format;
+    loader->errstream = errstream;
+    loader->line_num = 1;
+    loader->malformed_num = 0;
+    loader->batch_num = 0;
+    size_t data_len = 0;
+    int error = 0;
+    while (0 == error) {
+        data_len += fread(buf + data_len, 1, capacity - data_len, istream);
+        if (ferror(istream)) {
+            error = STS_READING_INPUT_ERROR;
+            break;
+        }
+        bool at_eof = feof(istream);
+        if (at_eof && (0 != data_len) && ('\n' != buf[data_len - 1])) {
+            buf[data_len++] = '\n';
+        }
+        size_t parsed_len = stl_parse_block(loader, buf, data_len, &error);
+        // Batch points into buffer, so it goes to collection before refilling
+        if (0 == error) {
+            error = stl_flush(loader);
+        }
+        if ((0 != error) || at_eof) {
+            if ((0 == error) && (parsed_len != data_len)) {
+                stl_report(loader, loader->line_num, "incomplete record");
+            }
+            break;
+        }
+        memmove(buf, buf + parsed_len, data_len - parsed_len);
+        data_len -= parsed_len;
+        if (capacity == data_len) {
+            // Single record doesn't fit in buffer
+            char* new_buf = (char*) realloc(buf, capacity * 2 + 1);
+            if (NULL == new_buf) {
+                error = STS_MEM_ALLOC_ERROR;
+                break;
+            }
+            buf = new_buf;
+            capacity *= 2;
+        }
+    }
+    if (NULL != malformed_num) {
+        *malformed_num = loader->malformed_num;
+    }
+    free(buf);
+    free(loader);
+    return error;
+}
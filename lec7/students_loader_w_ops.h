@@ -0,0 +1,43 @@
+#ifndef STUDENTS_LOADER_W_OPS_H
+#define STUDENTS_LOADER_W_OPS_H
+
+#include <stdio.h>
+#include "students_array_struct.h"
+
+/**
+ * Input formats st_load() understands. Fields always go in order
+ *  surname, grade_book_num, faculty, group
+*/
+enum students_input_format {
+    // Every field on its own line, like st_interactive_add() reads them
+    STS_FORMAT_LINES = 0,
+    // One record per line, fields separated by ',', 
+    //  fields may be quoted with '"' ("" inside stands for '"').
+    //  Parsing is line-based, so quoted fields can't span lines: 
+    //  a record broken by a line break inside quotes is reported
+    //  as malformed, and so is the line with its closing quote, 
+    //  as '"' isn't allowed in unquoted fields
+    STS_FORMAT_CSV,
+    // One record per line, fields separated by '\t', no quoting
+    STS_FORMAT_TSV,
+};
+
+/**
+ * Reads all records from 'istream' in large blocks without prompts 
+ *  and appends them to 'collection' in batches (see st_add_bulk_copy()).
+ * Malformed records are skipped and reported to 'errstream' 
+ *  (if not NULL) as "line N: reason", 
+ *  *malformed_num (if not NULL) is set to their number.
+ * Lines are counted from the current position of 'istream', 
+ *  so a header line can be consumed by caller beforehand.
+ * Arena collections load fastest: strings are copied straight 
+ *  from the read buffer, owning ones need a malloc() per string.
+ * Not applicable to borrowing collections.
+ * Returns 0, STS_MEM_ALLOC_ERROR or STS_READING_INPUT_ERROR,
+ *  records read before an error stay in collection
+*/
+int st_load(students_array* collection, FILE* istream, 
+            enum students_input_format format, FILE* errstream, 
+            size_t* malformed_num);
+
+#endif
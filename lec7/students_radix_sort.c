@@ -0,0 +1,316 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "students_radix_sort.h"
+#include "thread_pool_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define SRS_BUCKETS_NUM 256
+#define SRS_KEY_BYTES 4
+// Buckets smaller than this are finished with insertion sort
+#define SRS_INSERTION_THRESHOLD 32
+// Deeper than this common prefixes are rare, rest is left to qsort()
+#define SRS_MAX_DEPTH 64
+
+typedef struct srs_uint_item {
+    uint32_t key;
+    uint32_t pos;
+} srs_uint_item;
+
+typedef struct srs_string_item {
+    const unsigned char* str;
+    size_t pos;
+} srs_string_item;
+
+static size_t srs_uint_item_pos(const void* items, size_t i) {
+    return ((const srs_uint_item*) items)[i].pos;
+}
+
+static size_t srs_string_item_pos(const void* items, size_t i) {
+    return ((const srs_string_item*) items)[i].pos;
+}
+
+/**
+ * Puts students[pos_at(items, i)] to i-th place
+*/
+static int srs_permute(student* students, size_t students_num, 
+                       const void* items, 
+                       size_t (*pos_at)(const void*, size_t)) {
+    student* buf = (student*) malloc(sizeof(*buf) * students_num);
+    if (NULL == buf) {
+        return 1;
+    }
+    for (size_t i = 0; i < students_num; ++i) {
+        buf[i] = students[pos_at(items, i)];
+    }
+    memcpy(students, buf, sizeof(*buf) * students_num);
+    free(buf);
+    return 0;
+}
+
+/******************** LSD sort by integer key ********************/
+
+typedef struct srs_lsd_job {
+    srs_uint_item* src;
+    srs_uint_item* dst;
+    size_t items_num;
+    size_t chunk_len;
+    size_t shift;
+    // counts[task][bucket], turned into destination offsets before scatter
+    size_t (*counts)[SRS_BUCKETS_NUM];
+} srs_lsd_job;
+
+static void srs_lsd_chunk_bounds(const srs_lsd_job* job, size_t task_idx, 
+                                 size_t* from, size_t* to) {
+    *from = task_idx * job->chunk_len;
+    if (*from > job->items_num) {
+        *from = job->items_num;
+    }
+    *to = (job->items_num - *from > job->chunk_len) ?
+        *from + job->chunk_len : job->items_num;
+}
+
+static void srs_lsd_count_task(size_t task_idx, void* ctx) {
+    srs_lsd_job* job = (srs_lsd_job*) ctx;
+    size_t from = 0;
+    size_t to = 0;
+    srs_lsd_chunk_bounds(job, task_idx, &from, &to);
+    size_t* counts = job->counts[task_idx];
+    memset(counts, 0, sizeof(*counts) * SRS_BUCKETS_NUM);
+    for (size_t i = from; i < to; ++i) {
+        counts[(job->src[i].key >> job->shift) & 0xFF]++;
+    }
+}
+
+static void srs_lsd_scatter_task(size_t task_idx, void* ctx) {
+    srs_lsd_job* job = (srs_lsd_job*) ctx;
+    size_t from = 0;
+    size_t to = 0;
+    srs_lsd_chunk_bounds(job, task_idx, &from, &to);
+    size_t* offsets = job->counts[task_idx];
+    for (size_t i = from; i < to; ++i) {
+        job->dst[offsets[(job->src[i].key >> job->shift) & 0xFF]++] = 
+            job->src[i];
+    }
+}
+
+static void srs_run_tasks(thread_pool* pool, size_t tasks_num, 
+                          void (*task)(size_t, void*), void* ctx) {
+    if (NULL == pool) {
+        for (size_t i = 0; i < tasks_num; ++i) {
+            task(i, ctx);
+        }
+        return;
+    }
+    tp_run(pool, tasks_num, task, ctx);
+}
+
+int srs_sort_by_uint_key(student* students, size_t students_num, 
+                         uint32_t (*key)(const student*), bool desc, 
+                         thread_pool* pool, size_t threads_num) {
+    assert(NULL != students || 0 == students_num);
+    assert(NULL != key);
+    if ((students_num < 2) || (UINT32_MAX < students_num)) {
+        return (UINT32_MAX < students_num);
+    }
+    size_t tasks_num = (NULL == pool || 0 == threads_num) ? 1 : threads_num;
+    srs_uint_item* items = 
+        (srs_uint_item*) malloc(sizeof(*items) * students_num * 2);
+    size_t (*counts)[SRS_BUCKETS_NUM] = 
+        malloc(sizeof(*counts) * tasks_num);
+    if (NULL == items || NULL == counts) {
+        free(items);
+        free(counts);
+        return 1;
+    }
+    // Whole-array histograms tell which passes can be skipped
+    size_t totals[SRS_KEY_BYTES][SRS_BUCKETS_NUM];
+    memset(totals, 0, sizeof(totals));
+    for (size_t i = 0; i < students_num; ++i) {
+        uint32_t item_key = key(students + i);
+        items[i].key = desc ? ~item_key : item_key;
+        items[i].pos = (uint32_t) i;
+        for (size_t byte = 0; byte < SRS_KEY_BYTES; ++byte) {
+            totals[byte][(items[i].key >> (8 * byte)) & 0xFF]++;
+        }
+    }
+    srs_lsd_job job;
+    job.src = items;
+    job.dst = items + students_num;
+    job.items_num = students_num;
+    job.chunk_len = (students_num + tasks_num - 1) / tasks_num;
+    job.counts = counts;
+    for (size_t byte = 0; byte < SRS_KEY_BYTES; ++byte) {
+        size_t first_key_bucket = (items[0].key >> (8 * byte)) & 0xFF;
+        if (students_num == totals[byte][first_key_bucket]) {
+            continue;
+        }
+        job.shift = 8 * byte;
+        srs_run_tasks(pool, tasks_num, srs_lsd_count_task, &job);
+        // Bucket b of task t goes after all smaller buckets
+        //  and after bucket b of all previous tasks
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < SRS_BUCKETS_NUM; ++bucket) {
+            for (size_t task_idx = 0; task_idx < tasks_num; ++task_idx) {
+                size_t count = counts[task_idx][bucket];
+                counts[task_idx][bucket] = offset;
+                offset += count;
+            }
+        }
+        srs_run_tasks(pool, tasks_num, srs_lsd_scatter_task, &job);
+        srs_uint_item* tmp = job.src;
+        job.src = job.dst;
+        job.dst = tmp;
+    }
+    int result = srs_permute(students, students_num, job.src, 
+                             srs_uint_item_pos);
+    free(items);
+    free(counts);
+    return result;
+}
+
+/******************** MSD sort by string key ********************/
+
+static int srs_compare_strings(const void* arg1, const void* arg2) {
+    const srs_string_item* item1 = (const srs_string_item*) arg1;
+    const srs_string_item* item2 = (const srs_string_item*) arg2;
+    int cmp_result = strcmp((const char*) item1->str, (const char*) item2->str);
+    if (0 != cmp_result) {
+        return cmp_result;
+    }
+    // Keeps qsort() fallback stable
+    return (item1->pos > item2->pos) - (item1->pos < item2->pos);
+}
+
+/**
+ * Items are known to be equal in first 'depth' bytes
+*/
+static void srs_insertion_sort(srs_string_item* items, size_t items_num, 
+                               size_t depth) {
+    for (size_t i = 1; i < items_num; ++i) {
+        srs_string_item item = items[i];
+        size_t j = i;
+        while ((j > 0) && (strcmp((const char*) items[j - 1].str + depth, 
+                                  (const char*) item.str + depth) > 0)) {
+            items[j] = items[j - 1];
+            --j;
+        }
+        items[j] = item;
+    }
+}
+
+/**
+ * Distributes items by byte at 'depth', 
+ *  counts[b] is set to the number of items in bucket b
+*/
+static void srs_msd_partition(srs_string_item* items, srs_string_item* tmp, 
+                              size_t items_num, size_t depth, 
+                              size_t counts[SRS_BUCKETS_NUM]) {
+    memset(counts, 0, sizeof(*counts) * SRS_BUCKETS_NUM);
+    for (size_t i = 0; i < items_num; ++i) {
+        counts[items[i].str[depth]]++;
+    }
+    size_t offsets[SRS_BUCKETS_NUM];
+    size_t offset = 0;
+    for (size_t bucket = 0; bucket < SRS_BUCKETS_NUM; ++bucket) {
+        offsets[bucket] = offset;
+        offset += counts[bucket];
+    }
+    for (size_t i = 0; i < items_num; ++i) {
+        tmp[offsets[items[i].str[depth]]++] = items[i];
+    }
+    memcpy(items, tmp, sizeof(*items) * items_num);
+}
+
+static void srs_msd_sort(srs_string_item* items, srs_string_item* tmp, 
+                         size_t items_num, size_t depth) {
+    if (items_num < SRS_INSERTION_THRESHOLD) {
+        srs_insertion_sort(items, items_num, depth);
+        return;
+    }
+    if (depth >= SRS_MAX_DEPTH) {
+        qsort(items, items_num, sizeof(*items), srs_compare_strings);
+        return;
+    }
+    size_t counts[SRS_BUCKETS_NUM];
+    srs_msd_partition(items, tmp, items_num, depth, counts);
+    // Bucket 0 holds strings ending here, they are all equal
+    size_t offset = counts[0];
+    for (size_t bucket = 1; bucket < SRS_BUCKETS_NUM; ++bucket) {
+        if (1 < counts[bucket]) {
+            srs_msd_sort(items + offset, tmp + offset, counts[bucket], 
+                         depth + 1);
+        }
+        offset += counts[bucket];
+    }
+}
+
+typedef struct srs_msd_job {
+    srs_string_item* items;
+    srs_string_item* tmp;
+    size_t counts[SRS_BUCKETS_NUM];
+    size_t offsets[SRS_BUCKETS_NUM];
+} srs_msd_job;
+
+static void srs_msd_bucket_task(size_t task_idx, void* ctx) {
+    srs_msd_job* job = (srs_msd_job*) ctx;
+    // Task i sorts bucket i + 1, bucket 0 needs no sorting
+    size_t bucket = task_idx + 1;
+    if (1 < job->counts[bucket]) {
+        srs_msd_sort(job->items + job->offsets[bucket], 
+                     job->tmp + job->offsets[bucket], 
+                     job->counts[bucket], 1);
+    }
+}
+
+int srs_sort_by_string(student* students, size_t students_num, 
+                       size_t field_offset, bool desc, 
+                       thread_pool* pool, size_t threads_num) {
+    assert(NULL != students || 0 == students_num);
+    assert(field_offset + sizeof(char*) <= sizeof(student));
+    if (students_num < 2) {
+        return 0;
+    }
+    srs_string_item* items = 
+        (srs_string_item*) malloc(sizeof(*items) * students_num * 2);
+    if (NULL == items) {
+        return 1;
+    }
+    srs_string_item* tmp = items + students_num;
+    for (size_t i = 0; i < students_num; ++i) {
+        items[i].str = *((const unsigned char**)
+                         ((const char*) (students + i) + field_offset));
+        items[i].pos = i;
+    }
+    if ((NULL == pool) || (threads_num < 2)) {
+        srs_msd_sort(items, tmp, students_num, 0);
+    }
+    else {
+        // First byte splits the work into up to 255 independent buckets
+        srs_msd_job job;
+        job.items = items;
+        job.tmp = tmp;
+        srs_msd_partition(items, tmp, students_num, 0, job.counts);
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < SRS_BUCKETS_NUM; ++bucket) {
+            job.offsets[bucket] = offset;
+            offset += job.counts[bucket];
+        }
+        tp_run(pool, SRS_BUCKETS_NUM - 1, srs_msd_bucket_task, &job);
+    }
+    if (desc) {
+        for (size_t i = 0; i < students_num / 2; ++i) {
+            srs_string_item item = items[i];
+            items[i] = items[students_num - 1 - i];
+            items[students_num - 1 - i] = item;
+        }
+    }
+    int result = srs_permute(students, students_num, items, 
+                             srs_string_item_pos);
+    free(items);
+    return result;
+}
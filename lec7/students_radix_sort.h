@@ -0,0 +1,37 @@
+#ifndef STUDENTS_RADIX_SORT_H
+#define STUDENTS_RADIX_SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "students_struct.h"
+#include "thread_pool_struct.h"
+
+/**
+ * Radix sorts of student arrays, used by predefined sorts in
+ *  students_array_w_ops.c for big collections.
+ * Only (key, position) pairs are moved while sorting,
+ *  students are permuted once at the end.
+ * If 'pool' is not NULL, work is split into 'threads_num' tasks run on it.
+ * All functions return 0 or nonzero if memory allocation failed 
+ *  (array is left untouched then)
+*/
+
+/**
+ * Stable LSD radix sort by 32-bit key, 8 bits per pass.
+ *  Passes where all keys have the same byte are skipped
+*/
+int srs_sort_by_uint_key(student* students, size_t students_num, 
+                         uint32_t (*key)(const student*), bool desc, 
+                         thread_pool* pool, size_t threads_num);
+
+/**
+ * MSD radix sort by string field located at 'field_offset' in student
+ *  (e.g. offsetof(student, surname)), gives strcmp() order.
+ *  Stable for ascending order
+*/
+int srs_sort_by_string(student* students, size_t students_num, 
+                       size_t field_offset, bool desc, 
+                       thread_pool* pool, size_t threads_num);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef STUDENTS_REDUCER_STRUCT_H
+#define STUDENTS_REDUCER_STRUCT_H
+
+#include <stddef.h>
+#include "students_struct.h"
+
+/**
+ * Description of a reduction over students (see sts_reduce()).
+ * Accumulator is a caller-defined value of 'acc_size' bytes,
+ *  every partial result starts as a copy of 'init'.
+ * 'combine' must be associative: combine(acc, other) merges partial result
+ *  of the chunk that follows acc's chunk into acc
+*/
+typedef struct students_reducer {
+    size_t acc_size;
+    const void* init;
+    void (*step)(void* acc, const student* entry);
+    void (*combine)(void* acc, const void* other);
+} students_reducer;
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef STUDENTS_SHARED_STRUCT_H
+#define STUDENTS_SHARED_STRUCT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "students_array_struct.h"
+
+#define STSH_MAX_READERS 64
+#define STSH_CACHE_LINE 64
+
+/**
+ * Epoch announced by a reader while it is inside a read section, 
+ *  0 when it is outside. Every slot has its own cache line, 
+ *  so readers don't slow each other down
+*/
+typedef struct students_shared_reader {
+    _Alignas(STSH_CACHE_LINE) atomic_size_t epoch;
+    atomic_bool in_use;
+} students_shared_reader;
+
+/**
+ * Version replaced by a newer one together with strings of entries
+ *  the newer one doesn't have. Freed once no reader can still see it
+*/
+typedef struct students_shared_retired {
+    struct students_shared_retired* next;
+    students_array* version;
+    char** strings;
+    size_t strings_num;
+    size_t epoch; // Global epoch at the moment of replacement
+} students_shared_retired;
+
+typedef struct students_shared_deletion {
+    bool (*predicate)(const student*, const void*);
+    const void* ctx;
+} students_shared_deletion;
+
+/**
+ * Concurrent wrapper of students_array.
+ * Published versions are immutable borrowing collections, 
+ *  strings belong to the wrapper and are shared between versions.
+ * Readers announce the global epoch and read the current version
+ *  without locks; writers queue changes under 'write_mutex'
+ *  and publish them as a new version
+*/
+typedef struct students_shared {
+    _Atomic(students_array*) current;
+    atomic_size_t epoch; // Starts from 1, 0 means "not reading"
+    students_shared_reader readers[STSH_MAX_READERS];
+    enum students_sort_key sort_key;
+    pthread_mutex_t write_mutex; // Protects everything below
+    students_array* pending_adds; // Borrowing, strings are owned by wrapper
+    students_shared_deletion* pending_deletions;
+    size_t pending_deletions_num;
+    size_t pending_deletions_capacity;
+    students_shared_retired* retired; // Newest first
+} students_shared;
+
+#endif
@@ -0,0 +1,347 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "students_shared_w_ops.h"
+#include "students_array_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+/**
+ * Why freeing is safe: reader stores its epoch before loading 'current', 
+ *  writer stores new 'current' before incrementing the epoch
+ *  (all seq_cst). So a reader that can still hold a version retired
+ *  at epoch e has announced an epoch not greater than e
+*/
+
+students_shared* stsh_new(enum students_sort_key sort_key) {
+    students_shared* result = (students_shared*)
+        aligned_alloc(STSH_CACHE_LINE, sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    students_array* first_version = st_new_array_borrowing(0);
+    result->pending_adds = st_new_array_borrowing(0);
+    if ((NULL == first_version) || (NULL == result->pending_adds) || 
+        (0 != pthread_mutex_init(&result->write_mutex, NULL))) {
+        sts_destroy_all(&first_version);
+        sts_destroy_all(&result->pending_adds);
+        free(result);
+        return NULL;
+    }
+    first_version->sort_key = sort_key;
+    atomic_init(&result->current, first_version);
+    atomic_init(&result->epoch, 1);
+    for (size_t i = 0; i < STSH_MAX_READERS; ++i) {
+        atomic_init(&result->readers[i].epoch, 0);
+        atomic_init(&result->readers[i].in_use, false);
+    }
+    result->sort_key = sort_key;
+    result->pending_deletions = NULL;
+    result->pending_deletions_num = 0;
+    result->pending_deletions_capacity = 0;
+    result->retired = NULL;
+    return result;
+}
+
+students_shared* stsh_new_from_array(const students_array* collection, 
+                                     enum students_sort_key sort_key) {
+    assert(NULL != collection);
+    students_shared* result = stsh_new(sort_key);
+    if (NULL == result) {
+        return NULL;
+    }
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != stsh_add(result, collection->students + i)) {
+            stsh_destroy(&result);
+            return NULL;
+        }
+    }
+    if (0 != stsh_publish(result)) {
+        stsh_destroy(&result);
+    }
+    return result;
+}
+
+/******************** Readers ********************/
+
+size_t stsh_reader_register(students_shared* shared) {
+    assert(NULL != shared);
+    for (size_t i = 0; i < STSH_MAX_READERS; ++i) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong(&shared->readers[i].in_use, 
+                                           &expected, true)) {
+            return i;
+        }
+    }
+    return STSH_NO_READER;
+}
+
+void stsh_reader_unregister(students_shared* shared, size_t reader) {
+    assert(NULL != shared);
+    assert(STSH_MAX_READERS > reader);
+    atomic_store(&shared->readers[reader].epoch, 0);
+    atomic_store(&shared->readers[reader].in_use, false);
+}
+
+const students_array* stsh_read_begin(students_shared* shared, size_t reader) {
+    assert(NULL != shared);
+    assert(STSH_MAX_READERS > reader);
+    assert(0 == atomic_load_explicit(&shared->readers[reader].epoch, 
+                                     memory_order_relaxed));
+    atomic_store(&shared->readers[reader].epoch, atomic_load(&shared->epoch));
+    return atomic_load(&shared->current);
+}
+
+void stsh_read_end(students_shared* shared, size_t reader) {
+    assert(NULL != shared);
+    assert(STSH_MAX_READERS > reader);
+    atomic_store_explicit(&shared->readers[reader].epoch, 0, 
+                          memory_order_release);
+}
+
+/******************** Writers ********************/
+
+static void stsh_free_strings(student* entry) {
+    free(entry->surname);
+    free(entry->faculty);
+    free(entry->group);
+}
+
+int stsh_add(students_shared* shared, const student* entry) {
+    assert(NULL != shared);
+    assert(NULL != entry);
+    student copy;
+    copy.grade_book_num = entry->grade_book_num;
+    copy.surname = strdup(entry->surname);
+    copy.faculty = strdup(entry->faculty);
+    copy.group = strdup(entry->group);
+    pthread_mutex_lock(&shared->write_mutex);
+    int result = ((NULL == copy.surname) || (NULL == copy.faculty) || 
+                  (NULL == copy.group)) ? 
+        STS_MEM_ALLOC_ERROR : st_add(shared->pending_adds, copy);
+    pthread_mutex_unlock(&shared->write_mutex);
+    if (0 != result) {
+        stsh_free_strings(&copy);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    return 0;
+}
+
+int stsh_del_all_where(students_shared* shared, 
+                       bool (*predicate)(const student*, const void*), 
+                       const void* ctx) {
+    assert(NULL != shared);
+    assert(NULL != predicate);
+    pthread_mutex_lock(&shared->write_mutex);
+    if (shared->pending_deletions_num == shared->pending_deletions_capacity) {
+        size_t new_capacity = (0 == shared->pending_deletions_capacity) ? 
+            4 : shared->pending_deletions_capacity * 2;
+        students_shared_deletion* deletions = (students_shared_deletion*)
+            realloc(shared->pending_deletions, 
+                    sizeof(*deletions) * new_capacity);
+        if (NULL == deletions) {
+            pthread_mutex_unlock(&shared->write_mutex);
+            return STS_MEM_ALLOC_ERROR;
+        }
+        shared->pending_deletions = deletions;
+        shared->pending_deletions_capacity = new_capacity;
+    }
+    students_shared_deletion* deletion = 
+        shared->pending_deletions + shared->pending_deletions_num++;
+    deletion->predicate = predicate;
+    deletion->ctx = ctx;
+    // Queued additions are not visible to anybody, so they go right away
+    students_array* adds = shared->pending_adds;
+    size_t kept_num = 0;
+    for (size_t i = 0; i < adds->students_num; ++i) {
+        if (predicate(adds->students + i, ctx)) {
+            stsh_free_strings(adds->students + i);
+        }
+        else {
+            adds->students[kept_num++] = adds->students[i];
+        }
+    }
+    adds->students_num = kept_num;
+    pthread_mutex_unlock(&shared->write_mutex);
+    return 0;
+}
+
+static bool stsh_is_deleted(const students_shared* shared, 
+                            const student* entry) {
+    for (size_t i = 0; i < shared->pending_deletions_num; ++i) {
+        const students_shared_deletion* deletion = shared->pending_deletions + i;
+        if (deletion->predicate(entry, deletion->ctx)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int stsh_compare(enum students_sort_key key, 
+                        const student* s1, const student* s2) {
+    switch (key) {
+        case STS_SORTED_BY_SURNAME:
+            return strcmp(s1->surname, s2->surname);
+        case STS_SORTED_BY_GRADE_BOOK_NUM:
+            return (s1->grade_book_num > s2->grade_book_num) - 
+                   (s1->grade_book_num < s2->grade_book_num);
+        case STS_SORTED_BY_FACULTY:
+            return strcmp(s1->faculty, s2->faculty);
+        case STS_SORTED_BY_GROUP:
+            return strcmp(s1->group, s2->group);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * Frees retired versions with epoch less than every announced one.
+ *  Caller holds 'write_mutex'
+*/
+static void stsh_reclaim_locked(students_shared* shared) {
+    size_t min_epoch = SIZE_MAX;
+    for (size_t i = 0; i < STSH_MAX_READERS; ++i) {
+        size_t epoch = atomic_load(&shared->readers[i].epoch);
+        if ((0 != epoch) && (epoch < min_epoch)) {
+            min_epoch = epoch;
+        }
+    }
+    // List is newest first, so everything after the first freeable is too
+    students_shared_retired** link = &shared->retired;
+    while ((NULL != *link) && ((*link)->epoch >= min_epoch)) {
+        link = &(*link)->next;
+    }
+    students_shared_retired* retired = *link;
+    *link = NULL;
+    while (NULL != retired) {
+        students_shared_retired* next = retired->next;
+        for (size_t i = 0; i < retired->strings_num; ++i) {
+            free(retired->strings[i]);
+        }
+        free(retired->strings);
+        sts_destroy_all(&retired->version);
+        free(retired);
+        retired = next;
+    }
+}
+
+void stsh_reclaim(students_shared* shared) {
+    assert(NULL != shared);
+    pthread_mutex_lock(&shared->write_mutex);
+    stsh_reclaim_locked(shared);
+    pthread_mutex_unlock(&shared->write_mutex);
+}
+
+/**
+ * Everything is allocated before the current version is replaced, 
+ *  so on failure nothing changes
+*/
+static int stsh_publish_locked(students_shared* shared) {
+    students_array* old_version = atomic_load(&shared->current);
+    students_array* adds = shared->pending_adds;
+    size_t old_num = old_version->students_num;
+    bool* deleted = NULL;
+    size_t deleted_num = 0;
+    if ((0 != shared->pending_deletions_num) && (0 != old_num)) {
+        deleted = (bool*) malloc(sizeof(*deleted) * old_num);
+        if (NULL == deleted) {
+            return STS_MEM_ALLOC_ERROR;
+        }
+        for (size_t i = 0; i < old_num; ++i) {
+            deleted[i] = stsh_is_deleted(shared, old_version->students + i);
+            deleted_num += deleted[i];
+        }
+    }
+    students_array* new_version = 
+        st_new_array_borrowing(old_num - deleted_num + adds->students_num);
+    students_shared_retired* retired = (students_shared_retired*)
+        malloc(sizeof(*retired));
+    char** strings = (0 == deleted_num) ? NULL : 
+        (char**) malloc(sizeof(*strings) * 3 * deleted_num);
+    if ((NULL == new_version) || (NULL == retired) || 
+        ((0 != deleted_num) && (NULL == strings))) {
+        free(deleted);
+        sts_destroy_all(&new_version);
+        free(retired);
+        free(strings);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (STS_NOT_SORTED != shared->sort_key) {
+        students_sort_spec spec = {shared->sort_key, false};
+        sts_sort_multi_key(adds, &spec, 1);
+    }
+    // Merge of survivors with additions, survivors go first among equal
+    size_t strings_num = 0;
+    size_t add_idx = 0;
+    student* dst = new_version->students;
+    for (size_t i = 0; i < old_num; ++i) {
+        const student* entry = old_version->students + i;
+        if ((NULL != deleted) && deleted[i]) {
+            strings[strings_num++] = entry->surname;
+            strings[strings_num++] = entry->faculty;
+            strings[strings_num++] = entry->group;
+            continue;
+        }
+        while ((STS_NOT_SORTED != shared->sort_key) && 
+               (add_idx < adds->students_num) && 
+               (0 > stsh_compare(shared->sort_key, 
+                                 adds->students + add_idx, entry))) {
+            *dst++ = adds->students[add_idx++];
+        }
+        *dst++ = *entry;
+    }
+    while (add_idx < adds->students_num) {
+        *dst++ = adds->students[add_idx++];
+    }
+    free(deleted);
+    new_version->students_num = old_num - deleted_num + adds->students_num;
+    new_version->sort_key = shared->sort_key;
+    adds->students_num = 0;
+    shared->pending_deletions_num = 0;
+    retired->version = old_version;
+    retired->strings = strings;
+    retired->strings_num = strings_num;
+    atomic_store(&shared->current, new_version);
+    retired->epoch = atomic_fetch_add(&shared->epoch, 1);
+    retired->next = shared->retired;
+    shared->retired = retired;
+    return 0;
+}
+
+int stsh_publish(students_shared* shared) {
+    assert(NULL != shared);
+    pthread_mutex_lock(&shared->write_mutex);
+    int result = stsh_publish_locked(shared);
+    stsh_reclaim_locked(shared);
+    pthread_mutex_unlock(&shared->write_mutex);
+    return result;
+}
+
+void stsh_destroy(students_shared** shared) {
+    assert(NULL != shared);
+    if (NULL == *shared) {
+        return;
+    }
+    students_shared* to_free = *shared;
+    for (size_t i = 0; i < STSH_MAX_READERS; ++i) {
+        assert(0 == atomic_load(&to_free->readers[i].epoch));
+    }
+    stsh_reclaim_locked(to_free);
+    students_array* current = atomic_load(&to_free->current);
+    for (size_t i = 0; i < current->students_num; ++i) {
+        stsh_free_strings(current->students + i);
+    }
+    sts_destroy_all(&current);
+    for (size_t i = 0; i < to_free->pending_adds->students_num; ++i) {
+        stsh_free_strings(to_free->pending_adds->students + i);
+    }
+    sts_destroy_all(&to_free->pending_adds);
+    free(to_free->pending_deletions);
+    pthread_mutex_destroy(&to_free->write_mutex);
+    free(to_free);
+    *shared = NULL;
+}
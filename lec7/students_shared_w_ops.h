@@ -0,0 +1,78 @@
+#ifndef STUDENTS_SHARED_W_OPS_H
+#define STUDENTS_SHARED_W_OPS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "students_shared_struct.h"
+
+/**
+ * Returned by stsh_reader_register() when all slots are taken
+*/
+#define STSH_NO_READER SIZE_MAX
+
+/**
+ * Return codes are the ones of students_array_ops_return_codes
+*/
+
+/**
+ * Every published version is sorted by 'sort_key'
+ *  (STS_NOT_SORTED keeps insertion order), so readers get binary search
+ * If memory allocation fails, returns NULL
+*/
+students_shared* stsh_new(enum students_sort_key sort_key);
+
+/**
+ * Same as stsh_new(), first version holds copies of entries of 'collection'
+*/
+students_shared* stsh_new_from_array(const students_array* collection, 
+                                     enum students_sort_key sort_key);
+
+/**
+ * Every reading thread takes a slot once and gives it back when done.
+ * Returns slot number or STSH_NO_READER
+*/
+size_t stsh_reader_register(students_shared* shared);
+void stsh_reader_unregister(students_shared* shared, size_t reader);
+
+/**
+ * Returns current version. It must only be read (const st_find_*, 
+ *  views, sts_reduce(), ...) and stays valid until stsh_read_end()
+ *  even if newer versions are published meanwhile.
+ * Neither call takes locks or allocates
+*/
+const students_array* stsh_read_begin(students_shared* shared, size_t reader);
+void stsh_read_end(students_shared* shared, size_t reader);
+
+/**
+ * Queue a change for the next stsh_publish(), readers don't see it before.
+ * stsh_add() copies entry's strings.
+ * stsh_del_all_where() deletes entries where predicate(entry, ctx) is true
+ *  from the current version and added before the call, 'ctx' must live
+ *  until publication
+*/
+int stsh_add(students_shared* shared, const student* entry);
+int stsh_del_all_where(students_shared* shared, 
+                       bool (*predicate)(const student*, const void*), 
+                       const void* ctx);
+
+/**
+ * Makes a new version out of the current one and queued changes, 
+ *  replaces the current one with it and frees versions no reader
+ *  can see anymore. Queued additions are merged into sorted order
+ *  in O(n + k log k) for k additions.
+ * On failure queued changes stay queued
+*/
+int stsh_publish(students_shared* shared);
+
+/**
+ * Frees old versions no reader can see anymore
+ *  (stsh_publish() does it too)
+*/
+void stsh_reclaim(students_shared* shared);
+
+/**
+ * No thread may use 'shared' anymore. Sets *shared to NULL
+*/
+void stsh_destroy(students_shared** shared);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef STUDENTS_SNAPSHOT_STRUCT_H
+#define STUDENTS_SNAPSHOT_STRUCT_H
+
+#include <stdint.h>
+
+/**
+ * Binary snapshot file layout (host byte order):
+ *  header | records_num fixed-width records | string heap
+ * Strings are stored in heap null-terminated, records refer to them
+ *  by offset from the heap start. Checksum is 64-bit FNV-1a
+ *  of everything after the header
+*/
+
+#define STS_SNAPSHOT_MAGIC "STSNAP\0"
+#define STS_SNAPSHOT_VERSION 1
+
+typedef struct students_snapshot_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t records_num;
+    uint64_t records_offset;
+    uint64_t heap_offset;
+    uint64_t heap_size;
+    uint64_t checksum;
+    // students_array's sort state, so that loaded one can use binary search
+    uint32_t sort_key;
+    uint32_t sort_desc;
+} students_snapshot_header;
+
+typedef struct students_snapshot_record {
+    int32_t grade_book_num;
+    uint32_t surname_offset;
+    uint32_t faculty_offset;
+    uint32_t group_offset;
+} students_snapshot_record;
+
+#endif
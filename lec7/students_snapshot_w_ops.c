@@ -0,0 +1,356 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "students_snapshot_w_ops.h"
+#include "students_array_w_ops.h"
+#include "string_dict_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define SNAPSHOT_FNV_OFFSET 14695981039346656037ULL
+#define SNAPSHOT_FNV_PRIME 1099511628211ULL
+
+static uint64_t snapshot_checksum_update(uint64_t hash, const void* data, 
+                                         size_t size) {
+    const unsigned char* bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= SNAPSHOT_FNV_PRIME;
+    }
+    return hash;
+}
+
+/**
+ * Output file that keeps checksum of everything written after header
+*/
+typedef struct snapshot_writer {
+    FILE* file;
+    uint64_t checksum;
+    uint64_t heap_size;
+    int error;
+} snapshot_writer;
+
+static void snapshot_write(snapshot_writer* writer, const void* data, 
+                           size_t size) {
+    if (0 != writer->error) {
+        return;
+    }
+    if (size != fwrite(data, 1, size, writer->file)) {
+        writer->error = STS_IO_ERROR;
+        return;
+    }
+    writer->checksum = snapshot_checksum_update(writer->checksum, data, size);
+}
+
+/**
+ * Reserves 'str' a place in heap, returns its offset
+*/
+static uint32_t snapshot_heap_place(snapshot_writer* writer, const char* str) {
+    uint64_t offset = writer->heap_size;
+    writer->heap_size += strlen(str) + 1;
+    if (UINT32_MAX < writer->heap_size) {
+        writer->error = STS_SNAPSHOT_TOO_BIG;
+    }
+    return (uint32_t) offset;
+}
+
+/**
+ * Places every dictionary string in heap once, 
+ *  'offsets'[code] is set to its offset
+*/
+static void snapshot_place_dict(snapshot_writer* writer, 
+                                const string_dict* dict, uint32_t* offsets) {
+    for (size_t i = 0; i < dict->size; ++i) {
+        offsets[i] = snapshot_heap_place(writer, dict->entries[i]->str);
+    }
+}
+
+static void snapshot_write_dict(snapshot_writer* writer, 
+                                const string_dict* dict) {
+    for (size_t i = 0; i < dict->size; ++i) {
+        snapshot_write(writer, dict->entries[i]->str, 
+                       strlen(dict->entries[i]->str) + 1);
+    }
+}
+
+/**
+ * Writes records, then heap in the same order strings were placed
+*/
+static void snapshot_write_body(snapshot_writer* writer, 
+                                const students_array* collection, 
+                                uint32_t* faculty_offsets, 
+                                uint32_t* group_offsets) {
+    if (NULL != collection->faculty_dict) {
+        snapshot_place_dict(writer, collection->faculty_dict, faculty_offsets);
+        snapshot_place_dict(writer, collection->group_dict, group_offsets);
+    }
+    for (size_t i = 0; i < collection->students_num; ++i) {
+        const student* entry = collection->students + i;
+        assert(NULL != entry->surname);
+        assert(NULL != entry->faculty);
+        assert(NULL != entry->group);
+        students_snapshot_record record;
+        record.grade_book_num = entry->grade_book_num;
+        record.surname_offset = snapshot_heap_place(writer, entry->surname);
+        if (NULL != collection->faculty_dict) {
+            record.faculty_offset = faculty_offsets[sd_code_of(entry->faculty)];
+            record.group_offset = group_offsets[sd_code_of(entry->group)];
+        }
+        else {
+            record.faculty_offset = snapshot_heap_place(writer, entry->faculty);
+            record.group_offset = snapshot_heap_place(writer, entry->group);
+        }
+        snapshot_write(writer, &record, sizeof(record));
+    }
+    if (NULL != collection->faculty_dict) {
+        snapshot_write_dict(writer, collection->faculty_dict);
+        snapshot_write_dict(writer, collection->group_dict);
+    }
+    for (size_t i = 0; i < collection->students_num; ++i) {
+        const student* entry = collection->students + i;
+        snapshot_write(writer, entry->surname, strlen(entry->surname) + 1);
+        if (NULL == collection->faculty_dict) {
+            snapshot_write(writer, entry->faculty, strlen(entry->faculty) + 1);
+            snapshot_write(writer, entry->group, strlen(entry->group) + 1);
+        }
+    }
+}
+
+/**
+ * Writes header over the placeholder and makes file durable
+*/
+static void snapshot_finish(snapshot_writer* writer, 
+                            const students_array* collection) {
+    if (0 != writer->error) {
+        return;
+    }
+    students_snapshot_header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, STS_SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = STS_SNAPSHOT_VERSION;
+    header.record_size = sizeof(students_snapshot_record);
+    header.records_num = collection->students_num;
+    header.records_offset = sizeof(header);
+    header.heap_offset = 
+        sizeof(header) + sizeof(students_snapshot_record) * collection->students_num;
+    header.heap_size = writer->heap_size;
+    header.checksum = writer->checksum;
+    header.sort_key = collection->sort_key;
+    header.sort_desc = collection->sort_desc;
+    if ((0 != fseek(writer->file, 0, SEEK_SET)) || 
+        (1 != fwrite(&header, sizeof(header), 1, writer->file)) || 
+        (0 != fflush(writer->file)) || 
+        (0 != fsync(fileno(writer->file)))) {
+        writer->error = STS_IO_ERROR;
+    }
+}
+
+int sts_fsync_dir_of(const char* path) {
+    assert(NULL != path);
+    const char* slash = strrchr(path, '/');
+    size_t dir_len = (NULL == slash) ? 0 : (size_t) (slash - path);
+    char* dir = (char*) malloc(dir_len + 2);
+    if (NULL == dir) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    if (NULL == slash) {
+        memcpy(dir, ".", 2);
+    } else {
+        // Root keeps its slash
+        memcpy(dir, path, dir_len + (0 == dir_len));
+        dir[dir_len + (0 == dir_len)] = '\0';
+    }
+    int fd = open(dir, O_RDONLY);
+    free(dir);
+    if (-1 == fd) {
+        return STS_IO_ERROR;
+    }
+    int result = (0 == fsync(fd)) ? 0 : STS_IO_ERROR;
+    close(fd);
+    return result;
+}
+
+int sts_snapshot_save(const students_array* collection, const char* path) {
+    assert(NULL != collection);
+    assert(NULL != path);
+    uint32_t* faculty_offsets = NULL;
+    uint32_t* group_offsets = NULL;
+    if (NULL != collection->faculty_dict) {
+        // +1 keeps malloc() argument nonzero for empty dictionaries
+        faculty_offsets = (uint32_t*) 
+            malloc(sizeof(*faculty_offsets) * (collection->faculty_dict->size + 1));
+        group_offsets = (uint32_t*) 
+            malloc(sizeof(*group_offsets) * (collection->group_dict->size + 1));
+        if (NULL == faculty_offsets || NULL == group_offsets) {
+            free(faculty_offsets);
+            free(group_offsets);
+            return STS_MEM_ALLOC_ERROR;
+        }
+    }
+    size_t path_len = strlen(path);
+    char* tmp_path = (char*) malloc(path_len + sizeof(".tmp"));
+    if (NULL == tmp_path) {
+        free(faculty_offsets);
+        free(group_offsets);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, ".tmp", sizeof(".tmp"));
+
+    snapshot_writer writer;
+    writer.file = fopen(tmp_path, "wb");
+    writer.checksum = SNAPSHOT_FNV_OFFSET;
+    writer.heap_size = 0;
+    writer.error = (NULL == writer.file) ? STS_IO_ERROR : 0;
+    if (0 == writer.error) {
+        // Placeholder, real header is written once checksum is known
+        students_snapshot_header header;
+        memset(&header, 0, sizeof(header));
+        if (1 != fwrite(&header, sizeof(header), 1, writer.file)) {
+            writer.error = STS_IO_ERROR;
+        }
+    }
+    snapshot_write_body(&writer, collection, faculty_offsets, group_offsets);
+    snapshot_finish(&writer, collection);
+    if ((NULL != writer.file) && (0 != fclose(writer.file)) && 
+        (0 == writer.error)) {
+        writer.error = STS_IO_ERROR;
+    }
+    if ((0 == writer.error) && (0 != rename(tmp_path, path))) {
+        writer.error = STS_IO_ERROR;
+    }
+    if (0 == writer.error) {
+        // Otherwise rename itself may be lost on power failure
+        writer.error = sts_fsync_dir_of(path);
+    }
+    if (0 != writer.error) {
+        remove(tmp_path);
+    }
+    free(tmp_path);
+    free(faculty_offsets);
+    free(group_offsets);
+    return writer.error;
+}
+
+/**
+ * Checks that header describes a file of 'file_size' bytes
+*/
+static bool snapshot_header_is_valid(const students_snapshot_header* header, 
+                                     size_t file_size) {
+    if ((0 != memcmp(header->magic, STS_SNAPSHOT_MAGIC, sizeof(header->magic))) || 
+        (STS_SNAPSHOT_VERSION != header->version) || 
+        (sizeof(students_snapshot_record) != header->record_size) || 
+        (sizeof(*header) != header->records_offset) || 
+        (STS_SORTED_BY_GROUP < header->sort_key)) {
+        return false;
+    }
+    uint64_t records_space = file_size - sizeof(*header);
+    if (header->records_num > records_space / sizeof(students_snapshot_record)) {
+        return false;
+    }
+    uint64_t heap_offset = 
+        sizeof(*header) + header->records_num * sizeof(students_snapshot_record);
+    return (heap_offset == header->heap_offset) && 
+        (file_size - heap_offset == header->heap_size);
+}
+
+/**
+ * Validates snapshot in 'map' and returns collection over it
+*/
+static students_array* snapshot_collection(const void* map, size_t map_size, 
+                                           bool verify_checksum, int* error) {
+    const students_snapshot_header* header = 
+        (const students_snapshot_header*) map;
+    if (!snapshot_header_is_valid(header, map_size)) {
+        *error = STS_BAD_SNAPSHOT;
+        return NULL;
+    }
+    const char* heap = (const char*) map + header->heap_offset;
+    // Terminating zero at the end of heap keeps any offset inside it safe
+    if ((0 != header->records_num) && 
+        ((0 == header->heap_size) || ('\0' != heap[header->heap_size - 1]))) {
+        *error = STS_BAD_SNAPSHOT;
+        return NULL;
+    }
+    if (verify_checksum && 
+        (header->checksum != snapshot_checksum_update(SNAPSHOT_FNV_OFFSET, 
+                                                      (const char*) map + sizeof(*header), 
+                                                      map_size - sizeof(*header)))) {
+        *error = STS_BAD_SNAPSHOT;
+        return NULL;
+    }
+    students_array* collection = st_new_array_borrowing(header->records_num);
+    if (NULL == collection) {
+        *error = STS_MEM_ALLOC_ERROR;
+        return NULL;
+    }
+    const students_snapshot_record* records = 
+        (const students_snapshot_record*) ((const char*) map + header->records_offset);
+    for (size_t i = 0; i < header->records_num; ++i) {
+        if ((records[i].surname_offset >= header->heap_size) || 
+            (records[i].faculty_offset >= header->heap_size) || 
+            (records[i].group_offset >= header->heap_size)) {
+            sts_destroy_all(&collection);
+            *error = STS_BAD_SNAPSHOT;
+            return NULL;
+        }
+        student* entry = collection->students + i;
+        entry->grade_book_num = records[i].grade_book_num;
+        entry->surname = (char*) heap + records[i].surname_offset;
+        entry->faculty = (char*) heap + records[i].faculty_offset;
+        entry->group = (char*) heap + records[i].group_offset;
+    }
+    collection->students_num = header->records_num;
+    collection->sort_key = (enum students_sort_key) header->sort_key;
+    collection->sort_desc = (0 != header->sort_desc);
+    return collection;
+}
+
+students_array* sts_snapshot_load(const char* path, bool verify_checksum, 
+                                  int* error) {
+    assert(NULL != path);
+    assert(NULL != error);
+    *error = 0;
+    int fd = open(path, O_RDONLY);
+    if (-1 == fd) {
+        *error = STS_IO_ERROR;
+        return NULL;
+    }
+    struct stat file_stat;
+    if (0 != fstat(fd, &file_stat)) {
+        close(fd);
+        *error = STS_IO_ERROR;
+        return NULL;
+    }
+    size_t map_size = (size_t) file_stat.st_size;
+    if (map_size < sizeof(students_snapshot_header)) {
+        close(fd);
+        *error = STS_BAD_SNAPSHOT;
+        return NULL;
+    }
+    void* map = mmap(NULL, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // Mapping stays valid after descriptor is closed
+    close(fd);
+    if (MAP_FAILED == map) {
+        *error = STS_IO_ERROR;
+        return NULL;
+    }
+    students_array* collection = 
+        snapshot_collection(map, map_size, verify_checksum, error);
+    if (NULL == collection) {
+        munmap(map, map_size);
+        return NULL;
+    }
+    collection->snapshot_map = map;
+    collection->snapshot_map_size = map_size;
+    return collection;
+}
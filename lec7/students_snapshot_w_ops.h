@@ -0,0 +1,39 @@
+#ifndef STUDENTS_SNAPSHOT_W_OPS_H
+#define STUDENTS_SNAPSHOT_W_OPS_H
+
+#include <stdbool.h>
+#include "students_array_struct.h"
+#include "students_snapshot_struct.h"
+
+/**
+ * Writes 'collection' to 'path' atomically: data goes to 'path'.tmp,
+ *  which is fsync()'ed and renamed, then the directory is fsync()'ed
+ *  so that the rename is durable too.
+ * Faculty and group values are stored once if dictionaries are enabled.
+ * Returns 0, STS_MEM_ALLOC_ERROR, STS_IO_ERROR or STS_SNAPSHOT_TOO_BIG
+ *  (string heap must fit in 4 GiB)
+*/
+int sts_snapshot_save(const students_array* collection, const char* path);
+
+/**
+ * fsync()'s directory holding 'path', so that files created, renamed
+ *  or removed there survive power loss.
+ * Returns 0, STS_MEM_ALLOC_ERROR or STS_IO_ERROR
+*/
+int sts_fsync_dir_of(const char* path);
+
+/**
+ * mmap()'s snapshot file read-only and returns borrowing collection
+ *  whose strings point right into the mapping: strings are not copied, 
+ *  only the array of student structs is built.
+ * Mapping is released by sts_destroy_all().
+ * Collection is meant for queries: entries may be added or deleted, 
+ *  but stored strings can't be modified.
+ * If 'verify_checksum' is false, only the structure is validated.
+ * Returns NULL on failure and sets *error to STS_MEM_ALLOC_ERROR, 
+ *  STS_IO_ERROR or STS_BAD_SNAPSHOT
+*/
+students_array* sts_snapshot_load(const char* path, bool verify_checksum, 
+                                  int* error);
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef STUDENTS_SORT_KERNEL_H
+#define STUDENTS_SORT_KERNEL_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "students_struct.h"
+
+/**
+ * Ranges shorter than this are finished with insertion sort
+*/
+#define STS_KERNEL_INSERTION_THRESHOLD 16
+
+/**
+ * Defines 'static void name(student* base, size_t n, const ctx_type* ctx)':
+ *  introsort (median-of-three quicksort falling back to heapsort 
+ *  after 2 * log2(n) levels, insertion sort for short ranges)
+ *  ordering entries by 'less'.
+ * 'less' must be a function 
+ *  'bool less(const student*, const student*, const ctx_type*)'
+ *  visible at the point of definition, so that its calls can be inlined 
+ *  instead of going through a pointer like qsort() comparator calls do.
+ * Sort is not stable
+*/
+#define STS_DEFINE_SORT_KERNEL(name, ctx_type, less)                          \
+static void name##_swap(student* s1, student* s2) {                           \
+    student tmp = *s1;                                                        \
+    *s1 = *s2;                                                                \
+    *s2 = tmp;                                                                \
+}                                                                             \
+                                                                              \
+static void name##_insertion(student* base, size_t n, const ctx_type* ctx) {  \
+    for (size_t i = 1; i < n; ++i) {                                          \
+        student item = base[i];                                               \
+        size_t j = i;                                                         \
+        while ((0 < j) && less(&item, base + j - 1, ctx)) {                   \
+            base[j] = base[j - 1];                                            \
+            --j;                                                              \
+        }                                                                     \
+        base[j] = item;                                                       \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static void name##_sift_down(student* base, size_t n, size_t i,               \
+                             const ctx_type* ctx) {                           \
+    student item = base[i];                                                   \
+    while (true) {                                                            \
+        size_t child = 2 * i + 1;                                             \
+        if (child >= n) {                                                     \
+            break;                                                            \
+        }                                                                     \
+        if ((child + 1 < n) && less(base + child, base + child + 1, ctx)) {   \
+            ++child;                                                          \
+        }                                                                     \
+        if (!less(&item, base + child, ctx)) {                                \
+            break;                                                            \
+        }                                                                     \
+        base[i] = base[child];                                                \
+        i = child;                                                            \
+    }                                                                         \
+    base[i] = item;                                                           \
+}                                                                             \
+                                                                              \
+static void name##_heap_sort(student* base, size_t n, const ctx_type* ctx) {  \
+    for (size_t i = n / 2; 0 < i; --i) {                                      \
+        name##_sift_down(base, n, i - 1, ctx);                                \
+    }                                                                         \
+    for (size_t end = n - 1; 0 < end; --end) {                                \
+        name##_swap(base, base + end);                                        \
+        name##_sift_down(base, end, 0, ctx);                                  \
+    }                                                                         \
+}                                                                             \
+                                                                              \
+static void name##_loop(student* base, size_t n, size_t depth,                \
+                        const ctx_type* ctx) {                                \
+    while (STS_KERNEL_INSERTION_THRESHOLD < n) {                              \
+        if (0 == depth) {                                                     \
+            name##_heap_sort(base, n, ctx);                                   \
+            return;                                                           \
+        }                                                                     \
+        --depth;                                                              \
+        size_t mid = (n - 1) / 2;                                             \
+        if (less(base + mid, base, ctx)) {                                    \
+            name##_swap(base + mid, base);                                    \
+        }                                                                     \
+        if (less(base + n - 1, base + mid, ctx)) {                            \
+            name##_swap(base + n - 1, base + mid);                            \
+            if (less(base + mid, base, ctx)) {                                \
+                name##_swap(base + mid, base);                                \
+            }                                                                 \
+        }                                                                     \
+        /* Hoare partition: [0, j] <= pivot <= [j + 1, n), j < n - 1 */       \
+        student pivot = base[mid];                                            \
+        size_t i = 0;                                                         \
+        size_t j = n - 1;                                                     \
+        while (true) {                                                        \
+            while (less(base + i, &pivot, ctx)) {                             \
+                ++i;                                                          \
+            }                                                                 \
+            while (less(&pivot, base + j, ctx)) {                             \
+                --j;                                                          \
+            }                                                                 \
+            if (i >= j) {                                                     \
+                break;                                                        \
+            }                                                                 \
+            name##_swap(base + i, base + j);                                  \
+            ++i;                                                              \
+            --j;                                                              \
+        }                                                                     \
+        size_t left_n = j + 1;                                                \
+        /* Recursing into the smaller part keeps stack depth logarithmic */   \
+        if (left_n < n - left_n) {                                            \
+            name##_loop(base, left_n, depth, ctx);                            \
+            base += left_n;                                                   \
+            n -= left_n;                                                      \
+        }                                                                     \
+        else {                                                                \
+            name##_loop(base + left_n, n - left_n, depth, ctx);               \
+            n = left_n;                                                       \
+        }                                                                     \
+    }                                                                         \
+    name##_insertion(base, n, ctx);                                           \
+}                                                                             \
+                                                                              \
+static void name(student* base, size_t n, const ctx_type* ctx) {              \
+    size_t depth = 0;                                                         \
+    for (size_t i = n; 1 < i; i /= 2) {                                       \
+        depth += 2;                                                           \
+    }                                                                         \
+    name##_loop(base, n, depth, ctx);                                         \
+}
+
+#endif
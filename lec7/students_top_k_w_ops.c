@@ -0,0 +1,425 @@
+#define _GNU_SOURCE // qsort_r()
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "students_top_k_w_ops.h"
+#include "students_view_w_ops.h"
+#include "thread_pool_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+/**
+ * Smaller collections are scanned by the calling thread only
+*/
+#define STK_PARALLEL_THRESHOLD (1 << 15)
+
+typedef struct stk_candidate {
+    unsigned long long distance;
+    size_t pos;
+} stk_candidate;
+
+/**
+ * Candidate order: closer first, then earlier in array
+*/
+static int stk_is_before(const stk_candidate* c1, const stk_candidate* c2) {
+    return (c1->distance < c2->distance) || 
+        ((c1->distance == c2->distance) && (c1->pos < c2->pos));
+}
+
+/**
+ * Max-heap of at most 'capacity' candidates, root is the worst one
+*/
+typedef struct stk_heap {
+    stk_candidate* items;
+    size_t size;
+    size_t capacity;
+} stk_heap;
+
+static void stk_sift_down(stk_heap* heap, size_t i) {
+    stk_candidate item = heap->items[i];
+    while (true) {
+        size_t child = 2 * i + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if ((child + 1 < heap->size) && 
+            stk_is_before(heap->items + child, heap->items + child + 1)) {
+            ++child;
+        }
+        if (!stk_is_before(&item, heap->items + child)) {
+            break;
+        }
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    heap->items[i] = item;
+}
+
+static void stk_push(stk_heap* heap, stk_candidate candidate) {
+    if (heap->size < heap->capacity) {
+        size_t i = heap->size++;
+        while (0 < i) {
+            size_t parent = (i - 1) / 2;
+            if (!stk_is_before(heap->items + parent, &candidate)) {
+                break;
+            }
+            heap->items[i] = heap->items[parent];
+            i = parent;
+        }
+        heap->items[i] = candidate;
+        return;
+    }
+    if (stk_is_before(&candidate, heap->items)) {
+        heap->items[0] = candidate;
+        stk_sift_down(heap, 0);
+    }
+}
+
+/**
+ * Which distance the scan computes. Known keys are computed inline
+ *  instead of calling 'distance' through a pointer
+*/
+enum stk_key {
+    STK_KEY_ANY,
+    STK_KEY_GRADE_BOOK_NUM,
+    STK_KEY_SURNAME,
+};
+
+typedef struct stk_job {
+    const student* students;
+    size_t students_num;
+    enum stk_key key;
+    int (*distance)(const student*, const void*);
+    const void* arg;
+    size_t grade_book_num;
+    size_t k;
+    size_t chunk_len;
+    stk_candidate* candidates; // k per chunk
+    size_t* candidates_nums;   // One per chunk
+} stk_job;
+
+/**
+ * Maps int distance to unsigned one keeping the order
+*/
+static unsigned long long stk_from_int(int distance) {
+    return (unsigned long long) ((long long) distance - INT_MIN);
+}
+
+static unsigned long long stk_grade_book_num_distance(int grade_book_num, 
+                                                      size_t value) {
+    if (grade_book_num < 0) {
+        return (unsigned long long) value + 
+            (unsigned long long) (-(long long) grade_book_num);
+    }
+    size_t num = (size_t) grade_book_num;
+    return (num > value) ? num - value : value - num;
+}
+
+static inline unsigned long long stk_distance(const stk_job* job, 
+                                              const student* entry) {
+    switch (job->key) {
+    case STK_KEY_GRADE_BOOK_NUM:
+        return stk_grade_book_num_distance(entry->grade_book_num, 
+                                           job->grade_book_num);
+    case STK_KEY_SURNAME:
+        return stk_from_int(abs(strcmp(entry->surname, 
+                                       (const char*) job->arg)));
+    default:
+        return stk_from_int(job->distance(entry, job->arg));
+    }
+}
+
+static void stk_scan_chunk(size_t task_idx, void* ctx) {
+    stk_job* job = (stk_job*) ctx;
+    size_t from = task_idx * job->chunk_len;
+    size_t to = from;
+    if (from < job->students_num) {
+        to = (job->students_num - from > job->chunk_len) ?
+            from + job->chunk_len : job->students_num;
+    }
+    stk_heap heap;
+    heap.items = job->candidates + task_idx * job->k;
+    heap.size = 0;
+    heap.capacity = job->k;
+    for (size_t i = from; i < to; ++i) {
+        stk_candidate candidate;
+        candidate.distance = stk_distance(job, job->students + i);
+        candidate.pos = i;
+        stk_push(&heap, candidate);
+    }
+    job->candidates_nums[task_idx] = heap.size;
+}
+
+static int stk_compare_candidates(const void* arg1, const void* arg2) {
+    const stk_candidate* c1 = (const stk_candidate*) arg1;
+    const stk_candidate* c2 = (const stk_candidate*) arg2;
+    return stk_is_before(c2, c1) - stk_is_before(c1, c2);
+}
+
+static students_view* stk_top_k(const students_array* collection, 
+                                stk_job* job, size_t threads_num, 
+                                bool force_parallel) {
+    job->students = collection->students;
+    job->students_num = 
+        (NULL == collection->students) ? 0 : collection->students_num;
+    if (job->k > job->students_num) {
+        job->k = job->students_num;
+    }
+    if (0 == job->k) {
+        return stv_new(collection, 0);
+    }
+    if (0 == threads_num) {
+        threads_num = tp_cpus_num();
+    }
+    thread_pool* pool = NULL;
+    if ((1 < threads_num) && 
+        (force_parallel || (STK_PARALLEL_THRESHOLD <= job->students_num))) {
+        pool = tp_default();
+    }
+    size_t chunks_num = (NULL == pool) ? 1 : threads_num;
+    if (SIZE_MAX / sizeof(stk_candidate) / job->k < chunks_num + 1) {
+        return NULL;
+    }
+    // Chunks' candidates and one more place for merged ones
+    job->candidates = (stk_candidate*) 
+        malloc(sizeof(*(job->candidates)) * job->k * (chunks_num + 1));
+    job->candidates_nums = 
+        (size_t*) malloc(sizeof(*(job->candidates_nums)) * chunks_num);
+    students_view* result = stv_new(collection, job->k);
+    if (NULL == job->candidates || NULL == job->candidates_nums || 
+        NULL == result) {
+        free(job->candidates);
+        free(job->candidates_nums);
+        stv_destroy(&result);
+        return NULL;
+    }
+    job->chunk_len = (job->students_num + chunks_num - 1) / chunks_num;
+    if (NULL == pool) {
+        stk_scan_chunk(0, job);
+    }
+    else {
+        tp_run(pool, chunks_num, stk_scan_chunk, job);
+    }
+    stk_heap merged;
+    merged.items = job->candidates + chunks_num * job->k;
+    merged.size = 0;
+    merged.capacity = job->k;
+    for (size_t chunk = 0; chunk < chunks_num; ++chunk) {
+        for (size_t i = 0; i < job->candidates_nums[chunk]; ++i) {
+            stk_push(&merged, job->candidates[chunk * job->k + i]);
+        }
+    }
+    // k <= students_num, so there are always k candidates
+    qsort(merged.items, merged.size, sizeof(*(merged.items)), 
+          stk_compare_candidates);
+    for (size_t i = 0; i < merged.size; ++i) {
+        result->positions[i] = merged.items[i].pos;
+    }
+    free(job->candidates);
+    free(job->candidates_nums);
+    return result;
+}
+
+students_view* st_view_top_k_closest_any_parallel(
+                                const students_array* collection, 
+                                int (*distance)(const student*, const void*), 
+                                const void* arg, size_t k, 
+                                size_t threads_num) {
+    assert(NULL != collection);
+    assert(NULL != distance);
+    stk_job job;
+    job.key = STK_KEY_ANY;
+    job.distance = distance;
+    job.arg = arg;
+    job.k = k;
+    return stk_top_k(collection, &job, threads_num, true);
+}
+
+students_view* st_view_top_k_closest_any(
+                                const students_array* collection, 
+                                int (*distance)(const student*, const void*), 
+                                const void* arg, size_t k) {
+    assert(NULL != collection);
+    assert(NULL != distance);
+    stk_job job;
+    job.key = STK_KEY_ANY;
+    job.distance = distance;
+    job.arg = arg;
+    job.k = k;
+    return stk_top_k(collection, &job, 0, false);
+}
+
+students_view* st_view_top_k_closest_grade_book_num(
+                                const students_array* collection, 
+                                size_t value, size_t k) {
+    assert(NULL != collection);
+    stk_job job;
+    job.key = STK_KEY_GRADE_BOOK_NUM;
+    job.grade_book_num = value;
+    job.k = k;
+    return stk_top_k(collection, &job, 0, false);
+}
+
+students_view* st_view_top_k_closest_surname(
+                                const students_array* collection, 
+                                const char* value, size_t k) {
+    assert(NULL != collection);
+    assert(NULL != value);
+    stk_job job;
+    job.key = STK_KEY_SURNAME;
+    job.arg = value;
+    job.k = k;
+    return stk_top_k(collection, &job, 0, false);
+}
+
+/******************** Pages ********************/
+
+// Ranges this short are sorted instead of partitioned
+#define STK_SELECT_SORT_THRESHOLD 16
+
+typedef struct stk_order {
+    const student* students;
+    int (*comparator)(const void*, const void*);
+} stk_order;
+
+/**
+ * Entry order with ties broken by position, so no two positions are equal
+*/
+static int stk_compare_positions(const void* arg1, const void* arg2, 
+                                 void* ctx) {
+    const stk_order* order = (const stk_order*) ctx;
+    size_t pos1 = *((const size_t*) arg1);
+    size_t pos2 = *((const size_t*) arg2);
+    int cmp_result = order->comparator(order->students + pos1, 
+                                       order->students + pos2);
+    if (0 != cmp_result) {
+        return cmp_result;
+    }
+    return (pos1 > pos2) - (pos1 < pos2);
+}
+
+static bool stk_is_less(size_t* positions, size_t i, size_t j, 
+                        stk_order* order) {
+    return stk_compare_positions(positions + i, positions + j, order) < 0;
+}
+
+static void stk_swap(size_t* positions, size_t i, size_t j) {
+    size_t tmp = positions[i];
+    positions[i] = positions[j];
+    positions[j] = tmp;
+}
+
+static size_t stk_median_of_three(size_t* positions, size_t a, size_t b, 
+                                  size_t c, stk_order* order) {
+    if (stk_is_less(positions, a, b, order)) {
+        if (stk_is_less(positions, b, c, order)) {
+            return b;
+        }
+        return stk_is_less(positions, a, c, order) ? c : a;
+    }
+    if (stk_is_less(positions, a, c, order)) {
+        return a;
+    }
+    return stk_is_less(positions, b, c, order) ? c : b;
+}
+
+/**
+ * Rearranges positions[from..to) so that positions[nth] is the one
+ *  sorted order puts there, positions before it go before it in that order.
+ * Ranges that stay large after 2 log n partitions are sorted, 
+ *  so the worst case is O(n log n)
+*/
+static void stk_select(size_t* positions, size_t from, size_t to, 
+                       size_t nth, stk_order* order) {
+    size_t partitions_left = 0;
+    for (size_t len = to - from; 1 < len; len /= 2) {
+        partitions_left += 2;
+    }
+    while (STK_SELECT_SORT_THRESHOLD < to - from) {
+        if (0 == partitions_left--) {
+            break;
+        }
+        size_t last = to - 1;
+        size_t pivot = stk_median_of_three(positions, from, 
+                                           from + (to - from) / 2, last, order);
+        stk_swap(positions, pivot, last);
+        size_t store = from;
+        for (size_t i = from; i < last; ++i) {
+            if (stk_is_less(positions, i, last, order)) {
+                stk_swap(positions, i, store++);
+            }
+        }
+        stk_swap(positions, store, last);
+        if (nth == store) {
+            return;
+        }
+        if (nth < store) {
+            to = store;
+        }
+        else {
+            from = store + 1;
+        }
+    }
+    qsort_r(positions + from, to - from, sizeof(*positions), 
+            stk_compare_positions, order);
+}
+
+students_view* st_view_page(const students_array* collection, 
+                            int (*comparator)(const void*, const void*), 
+                            size_t offset, size_t limit) {
+    assert(NULL != collection);
+    assert(NULL != comparator);
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    if (offset > n) {
+        offset = n;
+    }
+    size_t end = (limit < n - offset) ? offset + limit : n;
+    students_view* result = stv_new(collection, end - offset);
+    if ((NULL == result) || (offset == end)) {
+        return result;
+    }
+    size_t* positions = (size_t*) malloc(sizeof(*positions) * n);
+    if (NULL == positions) {
+        stv_destroy(&result);
+        return NULL;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        positions[i] = i;
+    }
+    stk_order order;
+    order.students = collection->students;
+    order.comparator = comparator;
+    if (end < n) {
+        // First 'end' entries go before positions[end]
+        stk_select(positions, 0, n, end, &order);
+    }
+    if (0 < offset) {
+        stk_select(positions, 0, end, offset, &order);
+    }
+    qsort_r(positions + offset, end - offset, sizeof(*positions), 
+            stk_compare_positions, &order);
+    memcpy(result->positions, positions + offset, 
+           sizeof(*positions) * (end - offset));
+    free(positions);
+    return result;
+}
+
+students_view* st_view_top_k(const students_array* collection, 
+                             int (*comparator)(const void*, const void*), 
+                             size_t k) {
+    return st_view_page(collection, comparator, 0, k);
+}
+
+students_view* st_view_bottom_k(const students_array* collection, 
+                                int (*comparator)(const void*, const void*), 
+                                size_t k) {
+    assert(NULL != collection);
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    return st_view_page(collection, comparator, (k < n) ? n - k : 0, k);
+}
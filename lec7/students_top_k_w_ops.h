@@ -0,0 +1,67 @@
+#ifndef STUDENTS_TOP_K_W_OPS_H
+#define STUDENTS_TOP_K_W_OPS_H
+
+#include "students_array_struct.h"
+#include "students_view_struct.h"
+
+/**
+ * Ranked closest search: returns view of (at most) 'k' entries closest 
+ *  to the value, ordered by distance, equally distant entries 
+ *  in array order (so earlier entries win ties for the last places).
+ * Collection is scanned once with a bounded max-heap of 'k' candidates,
+ *  O(n log k). Large collections are split into chunks scanned 
+ *  on the shared thread pool, per-chunk candidates are merged afterwards.
+ * Distances are the same as in st_find_*_closest_* functions.
+ * View is freed with stv_destroy(), NULL is returned 
+ *  if memory allocation fails
+*/
+students_view* st_view_top_k_closest_any(
+                                const students_array* collection, 
+                                int (*distance)(const student*, const void*), 
+                                const void* arg, size_t k);
+students_view* st_view_top_k_closest_grade_book_num(
+                                const students_array* collection, 
+                                size_t value, size_t k);
+students_view* st_view_top_k_closest_surname(
+                                const students_array* collection, 
+                                const char* value, size_t k);
+
+/**
+ * Same as st_view_top_k_closest_any(), but with explicit number of chunks
+ *  scanned concurrently ('threads_num' == 0 means "one per CPU").
+ * Collections of any size are split, as long as threads are available
+*/
+students_view* st_view_top_k_closest_any_parallel(
+                                const students_array* collection, 
+                                int (*distance)(const student*, const void*), 
+                                const void* arg, size_t k, 
+                                size_t threads_num);
+
+/**
+ * Ordered pages of collection without sorting it: entries come in
+ *  the order stable sts_sort_any() with 'comparator' would put them
+ *  (equal entries in array order), so consecutive pages
+ *  (offset 0, limit, 2 * limit, ...) never repeat or skip entries
+ *  while collection is not changed.
+ * Positions are partitioned with quickselect around the page bounds
+ *  and only the page itself is sorted: O(n + limit log limit) on average, 
+ *  O(n log n) at worst. Collection is not changed.
+ * View is freed with stv_destroy(), NULL is returned
+ *  if memory allocation fails
+*/
+students_view* st_view_page(const students_array* collection, 
+                            int (*comparator)(const void*, const void*), 
+                            size_t offset, size_t limit);
+
+/**
+ * First and last 'k' entries of the same order
+ *  (st_view_page() from 0 and from students_num - k)
+*/
+students_view* st_view_top_k(const students_array* collection, 
+                             int (*comparator)(const void*, const void*), 
+                             size_t k);
+students_view* st_view_bottom_k(const students_array* collection, 
+                                int (*comparator)(const void*, const void*), 
+                                size_t k);
+
+#endif
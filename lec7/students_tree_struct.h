@@ -0,0 +1,76 @@
+#ifndef STUDENTS_TREE_STRUCT_H
+#define STUDENTS_TREE_STRUCT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "students_struct.h"
+#include "students_array_struct.h"
+
+#define STT_LEAF_CAPACITY 32
+#define STT_FANOUT 32
+// Nodes are at least half full, so 2^64 entries fit into this many levels
+#define STT_MAX_HEIGHT 32
+
+/**
+ * Separator of inner node: copy of key field of some entry
+ *  ('str' is owned by the node)
+*/
+typedef union students_tree_key {
+    int num;
+    char* str;
+} students_tree_key;
+
+/**
+ * Common beginning of leaves and inner nodes.
+ * 'size' is the number of entries of a leaf
+ *  or the number of children of an inner node
+*/
+typedef struct students_tree_node {
+    bool is_leaf;
+    size_t size;
+} students_tree_node;
+
+/**
+ * Leaves hold the entries themselves and are linked in key order
+*/
+typedef struct students_tree_leaf {
+    students_tree_node header;
+    struct students_tree_leaf* prev;
+    struct students_tree_leaf* next;
+    student entries[STT_LEAF_CAPACITY];
+} students_tree_leaf;
+
+/**
+ * All entries under children[i] are not less than keys[i - 1]
+ *  and not greater than keys[i]: equal keys may be split between leaves
+*/
+typedef struct students_tree_inner {
+    students_tree_node header;
+    students_tree_key keys[STT_FANOUT - 1];
+    students_tree_node* children[STT_FANOUT];
+} students_tree_inner;
+
+/**
+ * B+ tree of students ordered by one field (ascending), 
+ *  entries with equal keys keep insertion order.
+ * Tree owns strings of its entries like default students_array does
+*/
+typedef struct students_tree {
+    students_tree_node* root; // NULL while tree is empty
+    students_tree_leaf* first_leaf;
+    students_tree_leaf* last_leaf;
+    size_t students_num;
+    size_t height; // Number of levels, 0 for empty tree
+    enum students_sort_key key;
+} students_tree;
+
+/**
+ * Position of an entry in tree, 'leaf' is NULL past the last entry.
+ * Cursor is invalidated by any insertion or deletion
+*/
+typedef struct students_tree_cursor {
+    const students_tree_leaf* leaf;
+    size_t pos;
+} students_tree_cursor;
+
+#endif
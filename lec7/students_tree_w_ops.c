@@ -0,0 +1,797 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include "students_tree_w_ops.h"
+#include "students_array_w_ops.h"
+#include "student_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+#define STT_LEAF_MIN (STT_LEAF_CAPACITY / 2)
+#define STT_INNER_MIN (STT_FANOUT / 2)
+
+/**
+ * Inner nodes passed on the way from root to a leaf
+ *  and indices of children taken in them
+*/
+typedef struct stt_path {
+    students_tree_inner* nodes[STT_MAX_HEIGHT];
+    size_t child_idx[STT_MAX_HEIGHT];
+    size_t depth;
+} stt_path;
+
+/******************** Keys ********************/
+
+static const char* stt_string_field(const students_tree* tree, 
+                                    const student* entry) {
+    switch (tree->key) {
+        case STS_SORTED_BY_SURNAME:
+            return entry->surname;
+        case STS_SORTED_BY_FACULTY:
+            return entry->faculty;
+        case STS_SORTED_BY_GROUP:
+            return entry->group;
+        default:
+            return NULL;
+    }
+}
+
+static bool stt_is_numeric(const students_tree* tree) {
+    return STS_SORTED_BY_GRADE_BOOK_NUM == tree->key;
+}
+
+static int stt_compare_entries(const students_tree* tree, 
+                               const student* s1, const student* s2) {
+    if (stt_is_numeric(tree)) {
+        return (s1->grade_book_num > s2->grade_book_num) - 
+               (s1->grade_book_num < s2->grade_book_num);
+    }
+    return strcmp(stt_string_field(tree, s1), stt_string_field(tree, s2));
+}
+
+/**
+ * Compares key of 'entry' with separator 'key'
+*/
+static int stt_compare_to_key(const students_tree* tree, 
+                              const student* entry, 
+                              const students_tree_key* key) {
+    if (stt_is_numeric(tree)) {
+        return (entry->grade_book_num > key->num) - 
+               (entry->grade_book_num < key->num);
+    }
+    return strcmp(stt_string_field(tree, entry), key->str);
+}
+
+static int stt_copy_key(const students_tree* tree, const student* entry, 
+                        students_tree_key* key) {
+    if (stt_is_numeric(tree)) {
+        key->num = entry->grade_book_num;
+        return 0;
+    }
+    key->str = strdup(stt_string_field(tree, entry));
+    return (NULL == key->str) ? STS_MEM_ALLOC_ERROR : 0;
+}
+
+static void stt_free_key(const students_tree* tree, students_tree_key* key) {
+    if (!stt_is_numeric(tree)) {
+        free(key->str);
+    }
+}
+
+/**
+ * Number of leaf entries less than 'probe'
+ *  (or not greater than it if 'or_equal')
+*/
+static size_t stt_leaf_rank(const students_tree* tree, 
+                            const students_tree_leaf* leaf, 
+                            const student* probe, bool or_equal) {
+    size_t lo = 0;
+    size_t hi = leaf->header.size;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp_result = stt_compare_entries(tree, leaf->entries + mid, probe);
+        if ((0 > cmp_result) || (or_equal && (0 == cmp_result))) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Same as stt_leaf_rank() for separators, which is the index of child
+ *  to descend into
+*/
+static size_t stt_inner_rank(const students_tree* tree, 
+                             const students_tree_inner* inner, 
+                             const student* probe, bool or_equal) {
+    size_t lo = 0;
+    size_t hi = inner->header.size - 1;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp_result = stt_compare_to_key(tree, probe, inner->keys + mid);
+        if ((0 < cmp_result) || (or_equal && (0 == cmp_result))) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/******************** Navigation ********************/
+
+/**
+ * Returns leaf where entries equal to 'probe' start
+ *  (or end if 'or_equal'), 'path' may be NULL
+*/
+static students_tree_leaf* stt_descend(const students_tree* tree, 
+                                       const student* probe, bool or_equal, 
+                                       stt_path* path) {
+    students_tree_node* node = tree->root;
+    if (NULL != path) {
+        path->depth = 0;
+    }
+    for (size_t level = 1; level < tree->height; ++level) {
+        students_tree_inner* inner = (students_tree_inner*) node;
+        size_t idx = stt_inner_rank(tree, inner, probe, or_equal);
+        if (NULL != path) {
+            path->nodes[path->depth] = inner;
+            path->child_idx[path->depth] = idx;
+            path->depth++;
+        }
+        node = inner->children[idx];
+    }
+    assert(node->is_leaf);
+    return (students_tree_leaf*) node;
+}
+
+/**
+ * Moves 'path' to the next leaf and returns it, NULL after the last leaf
+*/
+static students_tree_leaf* stt_path_next(stt_path* path) {
+    while ((0 < path->depth) && 
+           (path->child_idx[path->depth - 1] + 1 >= 
+            path->nodes[path->depth - 1]->header.size)) {
+        path->depth--;
+    }
+    if (0 == path->depth) {
+        return NULL;
+    }
+    students_tree_inner* inner = path->nodes[path->depth - 1];
+    students_tree_node* node = 
+        inner->children[++path->child_idx[path->depth - 1]];
+    while (!node->is_leaf) {
+        path->nodes[path->depth] = (students_tree_inner*) node;
+        path->child_idx[path->depth] = 0;
+        path->depth++;
+        node = ((students_tree_inner*) node)->children[0];
+    }
+    return (students_tree_leaf*) node;
+}
+
+/**
+ * Skips leaves with no entries left at or after cursor's position
+*/
+static void stt_cursor_normalize(students_tree_cursor* cursor) {
+    while ((NULL != cursor->leaf) && 
+           (cursor->pos >= cursor->leaf->header.size)) {
+        cursor->leaf = cursor->leaf->next;
+        cursor->pos = 0;
+    }
+}
+
+students_tree_cursor stt_begin(const students_tree* tree) {
+    assert(NULL != tree);
+    students_tree_cursor cursor = {tree->first_leaf, 0};
+    stt_cursor_normalize(&cursor);
+    return cursor;
+}
+
+students_tree_cursor stt_lower_bound(const students_tree* tree, 
+                                     const student* probe) {
+    assert(NULL != tree);
+    assert(NULL != probe);
+    students_tree_cursor cursor = {NULL, 0};
+    if (NULL == tree->root) {
+        return cursor;
+    }
+    cursor.leaf = stt_descend(tree, probe, false, NULL);
+    cursor.pos = stt_leaf_rank(tree, cursor.leaf, probe, false);
+    stt_cursor_normalize(&cursor);
+    return cursor;
+}
+
+void stt_cursor_next(students_tree_cursor* cursor) {
+    assert(NULL != cursor);
+    assert(NULL != cursor->leaf);
+    cursor->pos++;
+    stt_cursor_normalize(cursor);
+}
+
+/**
+ * Cursor at the entry before the one under 'cursor' ('leaf' is NULL
+ *  if there is none), 'cursor' may be past the last entry
+*/
+static students_tree_cursor stt_cursor_prev(const students_tree* tree, 
+                                            students_tree_cursor cursor) {
+    if (NULL == cursor.leaf) {
+        cursor.leaf = tree->last_leaf;
+        cursor.pos = (NULL == cursor.leaf) ? 0 : cursor.leaf->header.size;
+    }
+    while ((NULL != cursor.leaf) && (0 == cursor.pos)) {
+        cursor.leaf = cursor.leaf->prev;
+        cursor.pos = (NULL == cursor.leaf) ? 0 : cursor.leaf->header.size;
+    }
+    if (NULL != cursor.leaf) {
+        cursor.pos--;
+    }
+    return cursor;
+}
+
+/******************** Creation ********************/
+
+students_tree* stt_new(enum students_sort_key key) {
+    assert(STS_NOT_SORTED != key);
+    students_tree* result = (students_tree*) malloc(sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    result->root = NULL;
+    result->first_leaf = NULL;
+    result->last_leaf = NULL;
+    result->students_num = 0;
+    result->height = 0;
+    result->key = key;
+    return result;
+}
+
+students_tree* stt_new_from_array(const students_array* collection, 
+                                  enum students_sort_key key) {
+    assert(NULL != collection);
+    students_tree* result = stt_new(key);
+    if (NULL == result) {
+        return NULL;
+    }
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != stt_insert_copy(result, collection->students + i)) {
+            stt_destroy(&result);
+            return NULL;
+        }
+    }
+    return result;
+}
+
+/******************** Insertion ********************/
+
+static students_tree_leaf* stt_new_leaf() {
+    students_tree_leaf* leaf = (students_tree_leaf*) malloc(sizeof(*leaf));
+    if (NULL != leaf) {
+        leaf->header.is_leaf = true;
+        leaf->header.size = 0;
+        leaf->prev = NULL;
+        leaf->next = NULL;
+    }
+    return leaf;
+}
+
+static students_tree_inner* stt_new_inner() {
+    students_tree_inner* inner = (students_tree_inner*) malloc(sizeof(*inner));
+    if (NULL != inner) {
+        inner->header.is_leaf = false;
+        inner->header.size = 0;
+    }
+    return inner;
+}
+
+/**
+ * Splits full 'leaf' with 'entry' inserted at 'pos' into 'leaf' and 'right'
+*/
+static void stt_split_leaf(students_tree* tree, students_tree_leaf* leaf, 
+                           size_t pos, const student* entry, 
+                           students_tree_leaf* right) {
+    student all[STT_LEAF_CAPACITY + 1];
+    memcpy(all, leaf->entries, sizeof(*all) * pos);
+    all[pos] = *entry;
+    memcpy(all + pos + 1, leaf->entries + pos, 
+           sizeof(*all) * (STT_LEAF_CAPACITY - pos));
+    size_t left_num = (STT_LEAF_CAPACITY + 1) / 2;
+    memcpy(leaf->entries, all, sizeof(*all) * left_num);
+    leaf->header.size = left_num;
+    memcpy(right->entries, all + left_num, 
+           sizeof(*all) * (STT_LEAF_CAPACITY + 1 - left_num));
+    right->header.size = STT_LEAF_CAPACITY + 1 - left_num;
+    right->prev = leaf;
+    right->next = leaf->next;
+    if (NULL != leaf->next) {
+        leaf->next->prev = right;
+    }
+    else {
+        tree->last_leaf = right;
+    }
+    leaf->next = right;
+}
+
+/**
+ * Inserts 'key' at 'idx' and 'child' at 'idx' + 1 into full 'inner', 
+ *  upper half goes to 'right', *key is set to the key moving up
+*/
+static void stt_split_inner(students_tree_inner* inner, size_t idx, 
+                            students_tree_key* key, students_tree_node* child, 
+                            students_tree_inner* right) {
+    students_tree_key keys[STT_FANOUT];
+    students_tree_node* children[STT_FANOUT + 1];
+    memcpy(keys, inner->keys, sizeof(*keys) * idx);
+    keys[idx] = *key;
+    memcpy(keys + idx + 1, inner->keys + idx, 
+           sizeof(*keys) * (STT_FANOUT - 1 - idx));
+    memcpy(children, inner->children, sizeof(*children) * (idx + 1));
+    children[idx + 1] = child;
+    memcpy(children + idx + 2, inner->children + idx + 1, 
+           sizeof(*children) * (STT_FANOUT - 1 - idx));
+    size_t left_num = (STT_FANOUT + 1) / 2;
+    size_t right_num = STT_FANOUT + 1 - left_num;
+    memcpy(inner->keys, keys, sizeof(*keys) * (left_num - 1));
+    memcpy(inner->children, children, sizeof(*children) * left_num);
+    inner->header.size = left_num;
+    *key = keys[left_num - 1];
+    memcpy(right->keys, keys + left_num, sizeof(*keys) * (right_num - 1));
+    memcpy(right->children, children + left_num, 
+           sizeof(*children) * right_num);
+    right->header.size = right_num;
+}
+
+/**
+ * Everything that may fail is allocated before the tree is touched, 
+ *  so on failure tree stays as it was
+*/
+int stt_insert(students_tree* tree, student entry) {
+    assert(NULL != tree);
+    if (NULL == tree->root) {
+        students_tree_leaf* leaf = stt_new_leaf();
+        if (NULL == leaf) {
+            return STS_MEM_ALLOC_ERROR;
+        }
+        leaf->entries[0] = entry;
+        leaf->header.size = 1;
+        tree->root = &leaf->header;
+        tree->first_leaf = leaf;
+        tree->last_leaf = leaf;
+        tree->height = 1;
+        tree->students_num = 1;
+        return 0;
+    }
+    stt_path path;
+    students_tree_leaf* leaf = stt_descend(tree, &entry, true, &path);
+    size_t pos = stt_leaf_rank(tree, leaf, &entry, true);
+    if (STT_LEAF_CAPACITY > leaf->header.size) {
+        memmove(leaf->entries + pos + 1, leaf->entries + pos, 
+                sizeof(*leaf->entries) * (leaf->header.size - pos));
+        leaf->entries[pos] = entry;
+        leaf->header.size++;
+        tree->students_num++;
+        return 0;
+    }
+    // Full inner nodes above the leaf split too, root split adds a level
+    size_t full_num = 0;
+    while ((full_num < path.depth) && 
+           (STT_FANOUT == path.nodes[path.depth - 1 - full_num]->header.size)) {
+        ++full_num;
+    }
+    bool new_root = (full_num == path.depth);
+    if (new_root && (STT_MAX_HEIGHT == tree->height)) {
+        return STS_MEM_ALLOC_ERROR;
+    }
+    students_tree_inner* spare[STT_MAX_HEIGHT];
+    size_t spare_num = full_num + (new_root ? 1 : 0);
+    students_tree_leaf* right_leaf = stt_new_leaf();
+    size_t allocated = 0;
+    while ((NULL != right_leaf) && (allocated < spare_num) && 
+           (NULL != (spare[allocated] = stt_new_inner()))) {
+        ++allocated;
+    }
+    // Separator is the key of the first entry of the right leaf
+    size_t left_num = (STT_LEAF_CAPACITY + 1) / 2;
+    const student* first_right = (left_num == pos) ? &entry : 
+        leaf->entries + left_num - (left_num > pos ? 1 : 0);
+    students_tree_key key;
+    if ((NULL == right_leaf) || (allocated < spare_num) || 
+        (0 != stt_copy_key(tree, first_right, &key))) {
+        free(right_leaf);
+        for (size_t i = 0; i < allocated; ++i) {
+            free(spare[i]);
+        }
+        return STS_MEM_ALLOC_ERROR;
+    }
+    stt_split_leaf(tree, leaf, pos, &entry, right_leaf);
+    students_tree_node* carry = &right_leaf->header;
+    size_t level = path.depth;
+    size_t spare_idx = 0;
+    while (0 < level) {
+        students_tree_inner* inner = path.nodes[level - 1];
+        size_t idx = path.child_idx[level - 1];
+        if (STT_FANOUT > inner->header.size) {
+            memmove(inner->keys + idx + 1, inner->keys + idx, 
+                    sizeof(*inner->keys) * (inner->header.size - 1 - idx));
+            memmove(inner->children + idx + 2, inner->children + idx + 1, 
+                    sizeof(*inner->children) * (inner->header.size - 1 - idx));
+            inner->keys[idx] = key;
+            inner->children[idx + 1] = carry;
+            inner->header.size++;
+            carry = NULL;
+            break;
+        }
+        students_tree_inner* right_inner = spare[spare_idx++];
+        stt_split_inner(inner, idx, &key, carry, right_inner);
+        carry = &right_inner->header;
+        --level;
+    }
+    if (NULL != carry) {
+        students_tree_inner* root = spare[spare_idx++];
+        root->keys[0] = key;
+        root->children[0] = tree->root;
+        root->children[1] = carry;
+        root->header.size = 2;
+        tree->root = &root->header;
+        tree->height++;
+    }
+    assert(spare_idx == spare_num);
+    tree->students_num++;
+    return 0;
+}
+
+int stt_insert_copy(students_tree* tree, const student* entry) {
+    assert(NULL != tree);
+    assert(NULL != entry);
+    student copy;
+    copy.grade_book_num = entry->grade_book_num;
+    copy.surname = strdup(entry->surname);
+    copy.faculty = strdup(entry->faculty);
+    copy.group = strdup(entry->group);
+    if ((NULL == copy.surname) || (NULL == copy.faculty) || 
+        (NULL == copy.group) || (0 != stt_insert(tree, copy))) {
+        free(copy.surname);
+        free(copy.faculty);
+        free(copy.group);
+        return STS_MEM_ALLOC_ERROR;
+    }
+    return 0;
+}
+
+/******************** Deletion ********************/
+
+static void stt_remove_from_inner(students_tree_inner* inner, 
+                                  size_t key_idx, size_t child_idx) {
+    size_t size = inner->header.size;
+    memmove(inner->keys + key_idx, inner->keys + key_idx + 1, 
+            sizeof(*inner->keys) * (size - 2 - key_idx));
+    memmove(inner->children + child_idx, inner->children + child_idx + 1, 
+            sizeof(*inner->children) * (size - 1 - child_idx));
+    inner->header.size--;
+}
+
+static void stt_unlink_leaf(students_tree* tree, students_tree_leaf* leaf) {
+    if (NULL != leaf->prev) {
+        leaf->prev->next = leaf->next;
+    }
+    else {
+        tree->first_leaf = leaf->next;
+    }
+    if (NULL != leaf->next) {
+        leaf->next->prev = leaf->prev;
+    }
+    else {
+        tree->last_leaf = leaf->prev;
+    }
+    free(leaf);
+}
+
+/**
+ * Fixes underflow of path->nodes[level] by borrowing from or merging with
+ *  a sibling, goes up while parents underflow
+*/
+static void stt_rebalance_inner(students_tree* tree, stt_path* path, 
+                                size_t level) {
+    students_tree_inner* inner = path->nodes[level];
+    if (0 == level) {
+        if (1 == inner->header.size) {
+            tree->root = inner->children[0];
+            tree->height--;
+            free(inner);
+        }
+        return;
+    }
+    if (STT_INNER_MIN <= inner->header.size) {
+        return;
+    }
+    students_tree_inner* parent = path->nodes[level - 1];
+    size_t idx = path->child_idx[level - 1];
+    students_tree_inner* left = (0 < idx) ? 
+        (students_tree_inner*) parent->children[idx - 1] : NULL;
+    students_tree_inner* right = (idx + 1 < parent->header.size) ? 
+        (students_tree_inner*) parent->children[idx + 1] : NULL;
+    size_t size = inner->header.size;
+    if ((NULL != left) && (STT_INNER_MIN < left->header.size)) {
+        memmove(inner->keys + 1, inner->keys, sizeof(*inner->keys) * (size - 1));
+        memmove(inner->children + 1, inner->children, 
+                sizeof(*inner->children) * size);
+        inner->children[0] = left->children[left->header.size - 1];
+        inner->keys[0] = parent->keys[idx - 1];
+        parent->keys[idx - 1] = left->keys[left->header.size - 2];
+        left->header.size--;
+        inner->header.size++;
+        return;
+    }
+    if ((NULL != right) && (STT_INNER_MIN < right->header.size)) {
+        inner->children[size] = right->children[0];
+        inner->keys[size - 1] = parent->keys[idx];
+        parent->keys[idx] = right->keys[0];
+        memmove(right->keys, right->keys + 1, 
+                sizeof(*right->keys) * (right->header.size - 2));
+        memmove(right->children, right->children + 1, 
+                sizeof(*right->children) * (right->header.size - 1));
+        right->header.size--;
+        inner->header.size++;
+        return;
+    }
+    // Separator between merged nodes moves down between their children
+    students_tree_inner* dst = (NULL != left) ? left : inner;
+    students_tree_inner* src = (NULL != left) ? inner : right;
+    size_t key_idx = (NULL != left) ? idx - 1 : idx;
+    if (NULL == src) {
+        return;
+    }
+    size_t dst_size = dst->header.size;
+    dst->keys[dst_size - 1] = parent->keys[key_idx];
+    memcpy(dst->keys + dst_size, src->keys, 
+           sizeof(*src->keys) * (src->header.size - 1));
+    memcpy(dst->children + dst_size, src->children, 
+           sizeof(*src->children) * src->header.size);
+    dst->header.size += src->header.size;
+    free(src);
+    stt_remove_from_inner(parent, key_idx, key_idx + 1);
+    stt_rebalance_inner(tree, path, level - 1);
+}
+
+/**
+ * Same as stt_rebalance_inner() for a leaf.
+ * Borrowing needs a copy of the new separator, if it can't be allocated
+ *  the leaf is left underfull, which only costs some space
+*/
+static void stt_rebalance_leaf(students_tree* tree, stt_path* path, 
+                               students_tree_leaf* leaf) {
+    if (0 == path->depth) {
+        if (0 == leaf->header.size) {
+            free(leaf);
+            tree->root = NULL;
+            tree->first_leaf = NULL;
+            tree->last_leaf = NULL;
+            tree->height = 0;
+        }
+        return;
+    }
+    if (STT_LEAF_MIN <= leaf->header.size) {
+        return;
+    }
+    students_tree_inner* parent = path->nodes[path->depth - 1];
+    size_t idx = path->child_idx[path->depth - 1];
+    students_tree_leaf* left = (0 < idx) ? 
+        (students_tree_leaf*) parent->children[idx - 1] : NULL;
+    students_tree_leaf* right = (idx + 1 < parent->header.size) ? 
+        (students_tree_leaf*) parent->children[idx + 1] : NULL;
+    students_tree_key key;
+    if ((NULL != left) && (STT_LEAF_MIN < left->header.size)) {
+        const student* moved = left->entries + left->header.size - 1;
+        if (0 != stt_copy_key(tree, moved, &key)) {
+            return;
+        }
+        memmove(leaf->entries + 1, leaf->entries, 
+                sizeof(*leaf->entries) * leaf->header.size);
+        leaf->entries[0] = *moved;
+        leaf->header.size++;
+        left->header.size--;
+        stt_free_key(tree, parent->keys + idx - 1);
+        parent->keys[idx - 1] = key;
+        return;
+    }
+    if ((NULL != right) && (STT_LEAF_MIN < right->header.size)) {
+        if (0 != stt_copy_key(tree, right->entries + 1, &key)) {
+            return;
+        }
+        leaf->entries[leaf->header.size++] = right->entries[0];
+        memmove(right->entries, right->entries + 1, 
+                sizeof(*right->entries) * (right->header.size - 1));
+        right->header.size--;
+        stt_free_key(tree, parent->keys + idx);
+        parent->keys[idx] = key;
+        return;
+    }
+    students_tree_leaf* dst = (NULL != left) ? left : leaf;
+    students_tree_leaf* src = (NULL != left) ? leaf : right;
+    size_t key_idx = (NULL != left) ? idx - 1 : idx;
+    if (NULL == src) {
+        return;
+    }
+    memcpy(dst->entries + dst->header.size, src->entries, 
+           sizeof(*src->entries) * src->header.size);
+    dst->header.size += src->header.size;
+    stt_unlink_leaf(tree, src);
+    stt_free_key(tree, parent->keys + key_idx);
+    stt_remove_from_inner(parent, key_idx, key_idx + 1);
+    stt_rebalance_inner(tree, path, path->depth - 1);
+}
+
+bool stt_delete_first(students_tree* tree, const student* probe) {
+    assert(NULL != tree);
+    assert(NULL != probe);
+    if (NULL == tree->root) {
+        return false;
+    }
+    stt_path path;
+    students_tree_leaf* leaf = stt_descend(tree, probe, false, &path);
+    size_t pos = stt_leaf_rank(tree, leaf, probe, false);
+    // First equal entry may start the next leaf
+    while ((NULL != leaf) && (pos >= leaf->header.size)) {
+        leaf = stt_path_next(&path);
+        pos = 0;
+    }
+    if ((NULL == leaf) || 
+        (0 != stt_compare_entries(tree, leaf->entries + pos, probe))) {
+        return false;
+    }
+    student* removed = leaf->entries + pos;
+    free(removed->surname);
+    free(removed->faculty);
+    free(removed->group);
+    memmove(leaf->entries + pos, leaf->entries + pos + 1, 
+            sizeof(*leaf->entries) * (leaf->header.size - 1 - pos));
+    leaf->header.size--;
+    tree->students_num--;
+    stt_rebalance_leaf(tree, &path, leaf);
+    return true;
+}
+
+/******************** Lookups ********************/
+
+const student* stt_find_first(const students_tree* tree, 
+                              const student* probe) {
+    students_tree_cursor cursor = stt_lower_bound(tree, probe);
+    const student* found = stt_cursor_get(&cursor);
+    if ((NULL == found) || (0 != stt_compare_entries(tree, found, probe))) {
+        return NULL;
+    }
+    return found;
+}
+
+/**
+ * Distance between keys of 'entry' and 'probe', 
+ *  computed without overflow like in students_columns
+*/
+static unsigned stt_distance(const students_tree* tree, 
+                             const student* entry, const student* probe) {
+    if (stt_is_numeric(tree)) {
+        int a = entry->grade_book_num;
+        int b = probe->grade_book_num;
+        return (a > b) ? (unsigned) a - (unsigned) b : 
+                         (unsigned) b - (unsigned) a;
+    }
+    int cmp_result = strcmp(stt_string_field(tree, entry), 
+                            stt_string_field(tree, probe));
+    return (0 > cmp_result) ? 0U - (unsigned) cmp_result : 
+                              (unsigned) cmp_result;
+}
+
+const student* stt_find_closest(const students_tree* tree, 
+                                const student* probe) {
+    students_tree_cursor next = stt_lower_bound(tree, probe);
+    students_tree_cursor prev = stt_cursor_prev(tree, next);
+    const student* after = stt_cursor_get(&next);
+    const student* before = stt_cursor_get(&prev);
+    if ((NULL == after) || (NULL == before)) {
+        return (NULL == after) ? before : after;
+    }
+    // 'before' is smaller, so it wins a tie
+    return (stt_distance(tree, before, probe) <= 
+            stt_distance(tree, after, probe)) ? before : after;
+}
+
+/******************** Iteration ********************/
+
+void stt_for_each_in_range(const students_tree* tree, 
+                           const student* from, const student* to, 
+                           void (*action)(const student*, void*), void* ctx) {
+    assert(NULL != tree);
+    assert(NULL != action);
+    students_tree_cursor cursor = (NULL == from) ? 
+        stt_begin(tree) : stt_lower_bound(tree, from);
+    for (const student* entry = stt_cursor_get(&cursor); NULL != entry;
+         stt_cursor_next(&cursor), entry = stt_cursor_get(&cursor)) {
+        if ((NULL != to) && (0 < stt_compare_entries(tree, entry, to))) {
+            break;
+        }
+        action(entry, ctx);
+    }
+}
+
+void stt_formatted_print_all(const students_tree* tree, FILE* ostream) {
+    assert(NULL != tree);
+    assert(NULL != ostream);
+    if (0 == tree->students_num) {
+        return;
+    }
+    fprintf(ostream, "students_tree collection:\n");
+    fprintf(ostream, "students_num in collection == %zu:\n", 
+            tree->students_num);
+    for (students_tree_cursor cursor = stt_begin(tree);
+         NULL != cursor.leaf; stt_cursor_next(&cursor)) {
+        st_formatted_print(stt_cursor_get(&cursor), ostream);
+    }
+}
+
+void* stt_fold(const students_tree* tree, 
+               void* operation(const student*, void*)) {
+    assert(NULL != tree);
+    assert(NULL != operation);
+    void* accumulator = NULL;
+    for (students_tree_cursor cursor = stt_begin(tree);
+         NULL != cursor.leaf; stt_cursor_next(&cursor)) {
+        accumulator = operation(stt_cursor_get(&cursor), accumulator);
+    }
+    return accumulator;
+}
+
+void stt_reduce(const students_tree* tree, 
+                const students_reducer* reducer, void* result) {
+    assert(NULL != tree);
+    assert(NULL != reducer);
+    assert(NULL != reducer->init);
+    assert(NULL != reducer->step);
+    assert(NULL != result);
+    memcpy(result, reducer->init, reducer->acc_size);
+    for (students_tree_cursor cursor = stt_begin(tree);
+         NULL != cursor.leaf; stt_cursor_next(&cursor)) {
+        reducer->step(result, stt_cursor_get(&cursor));
+    }
+}
+
+/******************** Destruction ********************/
+
+static void stt_destroy_node(students_tree* tree, students_tree_node* node) {
+    if (node->is_leaf) {
+        students_tree_leaf* leaf = (students_tree_leaf*) node;
+        for (size_t i = 0; i < leaf->header.size; ++i) {
+            free(leaf->entries[i].surname);
+            free(leaf->entries[i].faculty);
+            free(leaf->entries[i].group);
+        }
+        free(leaf);
+        return;
+    }
+    students_tree_inner* inner = (students_tree_inner*) node;
+    for (size_t i = 0; i < inner->header.size; ++i) {
+        stt_destroy_node(tree, inner->children[i]);
+    }
+    for (size_t i = 0; i + 1 < inner->header.size; ++i) {
+        stt_free_key(tree, inner->keys + i);
+    }
+    free(inner);
+}
+
+void stt_destroy(students_tree** tree) {
+    assert(NULL != tree);
+    if (NULL == *tree) {
+        return;
+    }
+    if (NULL != (*tree)->root) {
+        stt_destroy_node(*tree, (*tree)->root);
+    }
+    free(*tree);
+    *tree = NULL;
+}
@@ -0,0 +1,107 @@
+#ifndef STUDENTS_TREE_W_OPS_H
+#define STUDENTS_TREE_W_OPS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "students_tree_struct.h"
+#include "students_reducer_struct.h"
+
+/**
+ * Ordered collection for workloads mixing insertions with ordered reads: 
+ *  insertion, deletion and lookups take O(log n), 
+ *  so nothing has to be re-sorted after adding entries.
+ * Lookups take a 'probe' student, only its field of tree's key is read.
+ * Return codes are the ones of students_array_ops_return_codes
+*/
+
+/**
+ * 'key' is any key but STS_NOT_SORTED
+ * If memory allocation fails, returns NULL
+*/
+students_tree* stt_new(enum students_sort_key key);
+
+/**
+ * Makes a tree of copies of all entries of 'collection'
+ * If memory allocation fails, returns NULL
+*/
+students_tree* stt_new_from_array(const students_array* collection, 
+                                  enum students_sort_key key);
+
+/**
+ * Takes ownership of entry's strings, like st_add() of default collection
+ *  (on failure they still belong to caller).
+ * Entry goes after all entries with equal key
+*/
+int stt_insert(students_tree* tree, student entry);
+
+/**
+ * Like stt_insert(), but entry's strings are copied
+*/
+int stt_insert_copy(students_tree* tree, const student* entry);
+
+/**
+ * Deletes the first entry with the key of 'probe', frees its strings.
+ * Returns false if there is no such entry
+*/
+bool stt_delete_first(students_tree* tree, const student* probe);
+
+/**
+ * Returns the first entry with the key of 'probe' or NULL.
+ * Pointer is valid until the tree is changed
+*/
+const student* stt_find_first(const students_tree* tree, const student* probe);
+
+/**
+ * Returns entry whose key is the closest to the key of 'probe' or NULL
+ *  if tree is empty. Only neighbours of 'probe' in key order are compared: 
+ *  by |difference| for grade_book_num and by |strcmp()| for strings
+ *  (see st_find_one_closest_surname()), the smaller one wins a tie
+*/
+const student* stt_find_closest(const students_tree* tree, 
+                                const student* probe);
+
+/**
+ * Cursor at the first entry / at the first entry with key
+ *  not less than the key of 'probe'
+*/
+students_tree_cursor stt_begin(const students_tree* tree);
+students_tree_cursor stt_lower_bound(const students_tree* tree, 
+                                     const student* probe);
+
+/**
+ * Returns entry under cursor or NULL if cursor is past the last entry
+*/
+static inline const student* stt_cursor_get(const students_tree_cursor* cursor) {
+    return (NULL == cursor->leaf) ? NULL : cursor->leaf->entries + cursor->pos;
+}
+
+void stt_cursor_next(students_tree_cursor* cursor);
+
+/**
+ * Calls action(entry, ctx) in key order for every entry with key
+ *  between keys of 'from' and 'to' (inclusive), NULL bound means no bound
+*/
+void stt_for_each_in_range(const students_tree* tree, 
+                           const student* from, const student* to, 
+                           void (*action)(const student*, void*), void* ctx);
+
+void stt_formatted_print_all(const students_tree* tree, FILE* ostream);
+
+/**
+ * Same as sts_fold(), entries are visited in key order
+*/
+void* stt_fold(const students_tree* tree, 
+               void* operation(const student*, void*));
+
+/**
+ * Same as sts_reduce() run in one thread, entries are visited in key order
+*/
+void stt_reduce(const students_tree* tree, 
+                const students_reducer* reducer, void* result);
+
+/**
+ * Frees all entries and nodes, sets *tree to NULL
+*/
+void stt_destroy(students_tree** tree);
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef STUDENTS_VIEW_STRUCT_H
+#define STUDENTS_VIEW_STRUCT_H
+
+#include <stddef.h>
+#include "students_array_struct.h"
+
+/**
+ * Result set of a query: positions of matching entries in 'parent'.
+ * View owns nothing but itself, entries stay in 'parent'.
+ * Positions stay valid while entries are only appended to 'parent',
+ *  deleting or sorting them invalidates the view.
+ * View and its positions are a single allocation
+*/
+typedef struct students_view {
+    const students_array* parent;
+    size_t positions_num;
+    size_t positions[];
+} students_view;
+
+#endif
@@ -0,0 +1,127 @@
+#define _GNU_SOURCE // qsort_r()
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <stdint.h>
+
+#include "students_view_w_ops.h"
+#include "students_array_w_ops.h"
+#include "student_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+students_view* stv_new(const students_array* parent, size_t positions_num) {
+    assert(NULL != parent);
+    if ((SIZE_MAX - sizeof(students_view)) / sizeof(size_t) < positions_num) {
+        return NULL;
+    }
+    students_view* result = (students_view*) 
+        malloc(sizeof(*result) + sizeof(*(result->positions)) * positions_num);
+    if (NULL == result) {
+        return NULL;
+    }
+    result->parent = parent;
+    result->positions_num = positions_num;
+    return result;
+}
+
+students_view* stv_truncate(students_view* view, size_t positions_num) {
+    assert(NULL != view);
+    assert(positions_num <= view->positions_num);
+    view->positions_num = positions_num;
+    students_view* shrunk_view = (students_view*) 
+        realloc(view, sizeof(*view) + sizeof(*(view->positions)) * positions_num);
+    return (NULL == shrunk_view) ? view : shrunk_view;
+}
+
+void stv_destroy(students_view** view) {
+    assert(NULL != view);
+    free(*view);
+    *view = NULL;
+}
+
+void stv_for_each(const students_view* view, 
+                  void (*action)(const student*, void*), void* ctx) {
+    assert(NULL != view);
+    assert(NULL != action);
+    for (size_t i = 0; i < view->positions_num; ++i) {
+        action(stv_get(view, i), ctx);
+    }
+}
+
+typedef struct stv_sort_ctx {
+    const student* students;
+    int (*comparator)(const void*, const void*);
+} stv_sort_ctx;
+
+static int stv_compare_positions(const void* arg1, const void* arg2, 
+                                 void* ctx) {
+    const stv_sort_ctx* sort_ctx = (const stv_sort_ctx*) ctx;
+    size_t pos1 = *((const size_t*) arg1);
+    size_t pos2 = *((const size_t*) arg2);
+    int cmp_result = sort_ctx->comparator(sort_ctx->students + pos1, 
+                                          sort_ctx->students + pos2);
+    if (0 != cmp_result) {
+        return cmp_result;
+    }
+    // Positions are unique, so qsort_r() result is stable
+    return (pos1 > pos2) - (pos1 < pos2);
+}
+
+void stv_sort(students_view* view, 
+              int (*comparator)(const void*, const void*)) {
+    assert(NULL != view);
+    assert(NULL != comparator);
+    if (view->positions_num < 2) {
+        return;
+    }
+    stv_sort_ctx sort_ctx;
+    sort_ctx.students = view->parent->students;
+    sort_ctx.comparator = comparator;
+    qsort_r(view->positions, view->positions_num, sizeof(*(view->positions)), 
+            stv_compare_positions, &sort_ctx);
+}
+
+students_view* stv_filter(const students_view* view, 
+                          bool (*predicate)(const student*, const void*), 
+                          const void* ctx) {
+    assert(NULL != view);
+    assert(NULL != predicate);
+    // Single pass: predicate is called once per entry
+    students_view* result = stv_new(view->parent, view->positions_num);
+    if (NULL == result) {
+        return NULL;
+    }
+    size_t matches_num = 0;
+    for (size_t i = 0; i < view->positions_num; ++i) {
+        if (predicate(stv_get(view, i), ctx)) {
+            result->positions[matches_num++] = view->positions[i];
+        }
+    }
+    return stv_truncate(result, matches_num);
+}
+
+students_array* stv_to_array(const students_view* view) {
+    assert(NULL != view);
+    students_array* result = st_new_array_borrowing(view->positions_num);
+    if (NULL == result) {
+        return NULL;
+    }
+    for (size_t i = 0; i < view->positions_num; ++i) {
+        result->students[i] = *stv_get(view, i);
+    }
+    result->students_num = view->positions_num;
+    return result;
+}
+
+void stv_formatted_print_all(const students_view* view, FILE* ostream) {
+    assert(NULL != view);
+    assert(NULL != ostream);
+    fprintf(ostream, "students_view:\n");
+    fprintf(ostream, "positions_num in view == %zu:\n", view->positions_num);
+    for (size_t i = 0; i < view->positions_num; ++i) {
+        st_formatted_print(stv_get(view, i), ostream);
+    }
+}
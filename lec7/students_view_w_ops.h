@@ -0,0 +1,64 @@
+#ifndef STUDENTS_VIEW_W_OPS_H
+#define STUDENTS_VIEW_W_OPS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "students_view_struct.h"
+
+/**
+ * Returns view of 'parent' with room for 'positions_num' positions, 
+ *  they are left for caller to fill. NULL if allocation fails
+*/
+students_view* stv_new(const students_array* parent, size_t positions_num);
+
+/**
+ * Keeps first 'positions_num' positions of view and gives back
+ *  memory of the rest. Returns view, which may have moved
+*/
+students_view* stv_truncate(students_view* view, size_t positions_num);
+
+/**
+ * Frees view only, sets *view to NULL
+*/
+void stv_destroy(students_view** view);
+
+/**
+ * Returns i-th entry of view
+*/
+static inline const student* stv_get(const students_view* view, size_t i) {
+    return view->parent->students + view->positions[i];
+}
+
+/**
+ * Calls action(entry, ctx) for every entry in view order
+*/
+void stv_for_each(const students_view* view, 
+                  void (*action)(const student*, void*), void* ctx);
+
+/**
+ * Sorts view's positions, 'parent' is not changed.
+ * 'comparator' is the same as for sts_sort_any(), 
+ *  entries it considers equal keep their relative order
+*/
+void stv_sort(students_view* view, 
+              int (*comparator)(const void*, const void*));
+
+/**
+ * Returns new view of entries of 'view' where predicate(entry, ctx) is true.
+ * Predicate is called once per entry.
+ * 'view' stays valid and has to be destroyed separately.
+ * NULL is returned if memory allocation fails
+*/
+students_view* stv_filter(const students_view* view, 
+                          bool (*predicate)(const student*, const void*), 
+                          const void* ctx);
+
+/**
+ * Returns borrowing collection with copies of view's entries
+ *  (see st_new_array_borrowing()), NULL if memory allocation fails
+*/
+students_array* stv_to_array(const students_view* view);
+
+void stv_formatted_print_all(const students_view* view, FILE* ostream);
+
+#endif
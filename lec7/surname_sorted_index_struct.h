@@ -0,0 +1,18 @@
+#ifndef SURNAME_SORTED_INDEX_STRUCT_H
+#define SURNAME_SORTED_INDEX_STRUCT_H
+
+#include <stddef.h>
+#include "students_array_struct.h"
+
+/**
+ * Positions of entries ordered by surname (strcmp() order),
+ *  equal surnames in array order
+*/
+typedef struct surname_sorted_index {
+    const students_array* collection;
+    size_t generation; // collection->generation index was built for
+    size_t indexed_num; // Entries after these are not indexed yet
+    size_t* positions; // 'indexed_num' of them
+} surname_sorted_index;
+
+#endif
@@ -0,0 +1,341 @@
+#define _GNU_SOURCE // qsort_r()
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdbool.h>
+
+#include "surname_sorted_index_w_ops.h"
+#include "students_view_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+// Appended entries are checked without index until there are more of them
+#define SSI_MIN_UNINDEXED_LIMIT 1024
+
+/******************** Bounds ********************/
+
+/**
+ * Matching surnames form one run in strcmp() order: 
+ *  surnames before it are "below", surnames after it are "above"
+*/
+typedef struct ssi_bounds {
+    const char* from; // Prefix itself when searching by prefix
+    const char* to;
+    size_t prefix_len; // 0 when searching by range
+} ssi_bounds;
+
+static ssi_bounds ssi_prefix_bounds(const char* prefix) {
+    ssi_bounds bounds = {prefix, NULL, strlen(prefix)};
+    return bounds;
+}
+
+static ssi_bounds ssi_range_bounds(const char* from, const char* to) {
+    ssi_bounds bounds = {from, to, 0};
+    return bounds;
+}
+
+static bool ssi_is_below(const ssi_bounds* bounds, const char* surname) {
+    return (NULL != bounds->from) && (strcmp(surname, bounds->from) < 0);
+}
+
+static bool ssi_is_above(const ssi_bounds* bounds, const char* surname) {
+    if (0 != bounds->prefix_len) {
+        return strncmp(surname, bounds->from, bounds->prefix_len) > 0;
+    }
+    return (NULL != bounds->to) && (strcmp(surname, bounds->to) >= 0);
+}
+
+static bool ssi_matches(const ssi_bounds* bounds, const char* surname) {
+    return !ssi_is_below(bounds, surname) && !ssi_is_above(bounds, surname);
+}
+
+/******************** Positions ********************/
+
+static int ssi_compare_positions(const void* arg1, const void* arg2, 
+                                 void* ctx) {
+    const student* students = (const student*) ctx;
+    size_t pos1 = *((const size_t*) arg1);
+    size_t pos2 = *((const size_t*) arg2);
+    int cmp_result = strcmp(students[pos1].surname, students[pos2].surname);
+    if (0 != cmp_result) {
+        return cmp_result;
+    }
+    return (pos1 > pos2) - (pos1 < pos2);
+}
+
+static void ssi_sort_positions(const students_array* collection, 
+                               size_t* positions, size_t positions_num) {
+    if (positions_num < 2) {
+        return;
+    }
+    qsort_r(positions, positions_num, sizeof(*positions), 
+            ssi_compare_positions, collection->students);
+}
+
+/**
+ * Merges two lists sorted by (surname, position) into 'result'
+*/
+static void ssi_merge(const students_array* collection, 
+                      const size_t* list1, size_t list1_num, 
+                      const size_t* list2, size_t list2_num, size_t* result) {
+    size_t i = 0;
+    size_t j = 0;
+    while (i < list1_num && j < list2_num) {
+        if (ssi_compare_positions(list1 + i, list2 + j, 
+                                  collection->students) <= 0) {
+            *(result++) = list1[i++];
+        } else {
+            *(result++) = list2[j++];
+        }
+    }
+    memcpy(result, list1 + i, sizeof(*result) * (list1_num - i));
+    memcpy(result + (list1_num - i), list2 + j, sizeof(*result) * (list2_num - j));
+}
+
+/**
+ * Positions from 'from' to 'to' having matching surnames, 
+ *  sorted by (surname, position). Returns NULL if memory allocation fails
+*/
+static size_t* ssi_scan(const students_array* collection, 
+                        const ssi_bounds* bounds, size_t from, size_t to, 
+                        size_t* matches_num) {
+    size_t* matches = (size_t*) malloc(sizeof(*matches) * (to - from + 1));
+    if (NULL == matches) {
+        return NULL;
+    }
+    *matches_num = 0;
+    for (size_t pos = from; pos < to; ++pos) {
+        if (ssi_matches(bounds, collection->students[pos].surname)) {
+            matches[(*matches_num)++] = pos;
+        }
+    }
+    ssi_sort_positions(collection, matches, *matches_num);
+    return matches;
+}
+
+/******************** Search without index ********************/
+
+/**
+ * First of 'n' entries starting at 'students' for which 'above'
+ *  (ssi_is_above() if true, !ssi_is_below() otherwise) holds, 
+ *  entries are sorted by surname ascending
+*/
+static size_t ssi_partition_point(const student* students, size_t n, 
+                                  const ssi_bounds* bounds, bool above) {
+    size_t left = 0;
+    size_t right = n;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        const char* surname = students[mid].surname;
+        bool holds = above ? 
+            ssi_is_above(bounds, surname) : !ssi_is_below(bounds, surname);
+        if (holds) {
+            right = mid;
+        } else {
+            left = mid + 1;
+        }
+    }
+    return left;
+}
+
+static students_view* ssi_view_without_index(const students_array* collection, 
+                                             const ssi_bounds* bounds) {
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    if ((STS_SORTED_BY_SURNAME == collection->sort_key) && 
+        !collection->sort_desc) {
+        size_t begin = 
+            ssi_partition_point(collection->students, n, bounds, false);
+        size_t end = begin + ssi_partition_point(collection->students + begin, 
+                                                 n - begin, bounds, true);
+        students_view* result = stv_new(collection, end - begin);
+        for (size_t i = 0; (NULL != result) && (i < end - begin); ++i) {
+            result->positions[i] = begin + i;
+        }
+        return result;
+    }
+    size_t matches_num = 0;
+    size_t* matches = ssi_scan(collection, bounds, 0, n, &matches_num);
+    if (NULL == matches) {
+        return NULL;
+    }
+    students_view* result = stv_new(collection, matches_num);
+    if (NULL != result) {
+        memcpy(result->positions, matches, sizeof(*matches) * matches_num);
+    }
+    free(matches);
+    return result;
+}
+
+students_view* st_view_surname_prefix(const students_array* collection, 
+                                      const char* prefix) {
+    assert(NULL != collection);
+    assert(NULL != prefix);
+    ssi_bounds bounds = ssi_prefix_bounds(prefix);
+    return ssi_view_without_index(collection, &bounds);
+}
+
+students_view* st_view_surname_range(const students_array* collection, 
+                                     const char* from, const char* to) {
+    assert(NULL != collection);
+    ssi_bounds bounds = ssi_range_bounds(from, to);
+    return ssi_view_without_index(collection, &bounds);
+}
+
+/******************** Index ********************/
+
+/**
+ * (Re)builds index for all current entries.
+ * Returns nonzero if memory allocation fails, index is empty then
+*/
+static int ssi_build(surname_sorted_index* index) {
+    const students_array* collection = index->collection;
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    free(index->positions);
+    index->indexed_num = 0;
+    index->generation = collection->generation;
+    index->positions = (size_t*) malloc(sizeof(*(index->positions)) * (n + 1));
+    if (NULL == index->positions) {
+        return 1;
+    }
+    for (size_t pos = 0; pos < n; ++pos) {
+        index->positions[pos] = pos;
+    }
+    ssi_sort_positions(collection, index->positions, n);
+    index->indexed_num = n;
+    return 0;
+}
+
+/**
+ * Sorts appended entries and merges them into index.
+ * Returns nonzero if memory allocation fails, index is not changed then
+*/
+static int ssi_merge_appended(surname_sorted_index* index) {
+    const students_array* collection = index->collection;
+    size_t n = collection->students_num;
+    size_t appended_num = n - index->indexed_num;
+    size_t* positions = (size_t*) malloc(sizeof(*positions) * (n + appended_num));
+    if (NULL == positions) {
+        return 1;
+    }
+    size_t* appended = positions + n;
+    for (size_t i = 0; i < appended_num; ++i) {
+        appended[i] = index->indexed_num + i;
+    }
+    ssi_sort_positions(collection, appended, appended_num);
+    ssi_merge(collection, index->positions, index->indexed_num, 
+              appended, appended_num, positions);
+    free(index->positions);
+    index->positions = positions;
+    index->indexed_num = n;
+    return 0;
+}
+
+/**
+ * Rebuilds index if it is stale, merges appended entries
+ *  if there are too many of them
+*/
+static int ssi_refresh(surname_sorted_index* index) {
+    const students_array* collection = index->collection;
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    if ((index->generation != collection->generation) || 
+        (NULL == index->positions)) {
+        return ssi_build(index);
+    }
+    size_t unindexed_limit = index->indexed_num / 8;
+    if (unindexed_limit < SSI_MIN_UNINDEXED_LIMIT) {
+        unindexed_limit = SSI_MIN_UNINDEXED_LIMIT;
+    }
+    if (n - index->indexed_num <= unindexed_limit) {
+        return 0;
+    }
+    return ssi_merge_appended(index);
+}
+
+surname_sorted_index* ssi_new(const students_array* collection) {
+    assert(NULL != collection);
+    surname_sorted_index* result = 
+        (surname_sorted_index*) malloc(sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    result->collection = collection;
+    result->positions = NULL;
+    if (0 != ssi_build(result)) {
+        ssi_destroy(&result);
+    }
+    return result;
+}
+
+void ssi_destroy(surname_sorted_index** index) {
+    assert(NULL != index);
+    if (NULL == *index) {
+        return;
+    }
+    free((*index)->positions);
+    free(*index);
+    *index = NULL;
+}
+
+/**
+ * First indexed position for which 'above'
+ *  (see ssi_partition_point()) holds
+*/
+static size_t ssi_index_partition_point(const surname_sorted_index* index, 
+                                        size_t from, const ssi_bounds* bounds, 
+                                        bool above) {
+    const student* students = index->collection->students;
+    size_t left = from;
+    size_t right = index->indexed_num;
+    while (left < right) {
+        size_t mid = left + (right - left) / 2;
+        const char* surname = students[index->positions[mid]].surname;
+        bool holds = above ? 
+            ssi_is_above(bounds, surname) : !ssi_is_below(bounds, surname);
+        if (holds) {
+            right = mid;
+        } else {
+            left = mid + 1;
+        }
+    }
+    return left;
+}
+
+static students_view* ssi_find(surname_sorted_index* index, 
+                               const ssi_bounds* bounds) {
+    if (0 != ssi_refresh(index)) {
+        return NULL;
+    }
+    const students_array* collection = index->collection;
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    size_t begin = ssi_index_partition_point(index, 0, bounds, false);
+    size_t end = ssi_index_partition_point(index, begin, bounds, true);
+    size_t appended_num = 0;
+    size_t* appended = ssi_scan(collection, bounds, index->indexed_num, n, 
+                                &appended_num);
+    if (NULL == appended) {
+        return NULL;
+    }
+    students_view* result = stv_new(collection, end - begin + appended_num);
+    if (NULL != result) {
+        ssi_merge(collection, index->positions + begin, end - begin, 
+                  appended, appended_num, result->positions);
+    }
+    free(appended);
+    return result;
+}
+
+students_view* ssi_find_prefix(surname_sorted_index* index, const char* prefix) {
+    assert(NULL != index);
+    assert(NULL != prefix);
+    ssi_bounds bounds = ssi_prefix_bounds(prefix);
+    return ssi_find(index, &bounds);
+}
+
+students_view* ssi_find_range(surname_sorted_index* index, 
+                              const char* from, const char* to) {
+    assert(NULL != index);
+    ssi_bounds bounds = ssi_range_bounds(from, to);
+    return ssi_find(index, &bounds);
+}
@@ -0,0 +1,49 @@
+#ifndef SURNAME_SORTED_INDEX_W_OPS_H
+#define SURNAME_SORTED_INDEX_W_OPS_H
+
+#include <stddef.h>
+#include "surname_sorted_index_struct.h"
+#include "students_view_struct.h"
+
+/**
+ * Prefix and range search on surname.
+ * Range is [from, to) in strcmp() order, NULL bound means no bound, 
+ *  e.g. surnames starting with K, L or M are ["K", "N").
+ * Results are views (see students_view_struct.h) ordered by surname, 
+ *  equal surnames in array order.
+ * NULL is returned if memory allocation fails
+*/
+
+/**
+ * Without index: binary search if collection is sorted by surname
+ *  ascending (see 'sort_key' of students_array), full scan otherwise
+*/
+students_view* st_view_surname_prefix(const students_array* collection, 
+                                      const char* prefix);
+students_view* st_view_surname_range(const students_array* collection, 
+                                     const char* from, const char* to);
+
+/**
+ * Builds index over surnames of 'collection'.
+ * Index only reads collection and doesn't have to be rebuilt by hand: 
+ *  it is rebuilt after entries are changed, deleted or moved
+ *  (see 'generation' field of students_array), entries appended
+ *  since the build are checked without index until there are enough
+ *  of them to merge into it.
+ * Returns NULL if memory allocation fails
+*/
+surname_sorted_index* ssi_new(const students_array* collection);
+
+/**
+ * Same as st_view_surname_*() in O(log n + k) on indexed collection
+*/
+students_view* ssi_find_prefix(surname_sorted_index* index, const char* prefix);
+students_view* ssi_find_range(surname_sorted_index* index, 
+                              const char* from, const char* to);
+
+/**
+ * Sets *index to NULL after freeing, collection is not touched
+*/
+void ssi_destroy(surname_sorted_index** index);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef SURNAME_TRIGRAM_INDEX_STRUCT_H
+#define SURNAME_TRIGRAM_INDEX_STRUCT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "students_array_struct.h"
+
+/**
+ * Inverted index from trigrams of lowercased surnames 
+ *  to positions of entries having them.
+ * Trigram of bytes b0 b1 b2 is (b0 << 16) | (b1 << 8) | b2, 
+ *  surnames are padded with two zero bytes in front and one at the end.
+ * Posting lists are stored one after another ("compressed rows"):
+ *  positions with trigrams[i] are postings[offsets[i]..offsets[i + 1]),
+ *  ascending
+*/
+typedef struct surname_trigram_index {
+    const students_array* collection;
+    size_t generation; // collection->generation index was built for
+    size_t indexed_num; // Entries after these are not indexed yet
+    uint32_t* trigrams; // Distinct, ascending
+    size_t* offsets;
+    size_t trigrams_num;
+    uint32_t* postings;
+} surname_trigram_index;
+
+#endif
@@ -0,0 +1,489 @@
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "surname_trigram_index_w_ops.h"
+#include "students_view_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+// Appended entries are checked without index until there are more of them
+#define STI_MIN_UNINDEXED_LIMIT 1024
+#define STI_BUCKETS_NUM 256
+
+static unsigned char sti_fold(unsigned char c) {
+    return ('A' <= c && c <= 'Z') ? c - 'A' + 'a' : c;
+}
+
+/**
+ * Writes strlen(str) + 1 trigrams of padded 'str' to 'trigrams'
+*/
+static size_t sti_trigrams_of(const char* str, uint32_t* trigrams) {
+    uint32_t window = 0;
+    size_t trigrams_num = 0;
+    for (const unsigned char* c = (const unsigned char*) str; '\0' != *c; ++c) {
+        window = ((window << 8) | sti_fold(*c)) & 0xFFFFFF;
+        trigrams[trigrams_num++] = window;
+    }
+    trigrams[trigrams_num++] = (window << 8) & 0xFFFFFF;
+    return trigrams_num;
+}
+
+/******************** Scoring ********************/
+
+typedef struct sti_match {
+    size_t distance;
+    size_t pos;
+} sti_match;
+
+/**
+ * Scores surnames against 'value' and collects those close enough
+*/
+typedef struct sti_matcher {
+    const students_array* collection;
+    const char* value;
+    size_t value_len;
+    size_t max_edits;
+    size_t* rows; // Two rows of value_len + 1 cells
+    sti_match* matches;
+    size_t matches_num;
+    size_t matches_capacity;
+} sti_matcher;
+
+static int sti_matcher_init(sti_matcher* matcher, 
+                            const students_array* collection, 
+                            const char* value, size_t max_edits) {
+    matcher->collection = collection;
+    matcher->value = value;
+    matcher->value_len = strlen(value);
+    matcher->max_edits = max_edits;
+    matcher->rows = 
+        (size_t*) malloc(sizeof(*(matcher->rows)) * 2 * (matcher->value_len + 1));
+    matcher->matches = NULL;
+    matcher->matches_num = 0;
+    matcher->matches_capacity = 0;
+    return (NULL == matcher->rows);
+}
+
+/**
+ * Levenshtein distance between 'str' and matcher's value 
+ *  or max_edits + 1 if it is greater than max_edits
+*/
+static size_t sti_edit_distance(const sti_matcher* matcher, const char* str, 
+                                size_t str_len) {
+    size_t len = matcher->value_len;
+    size_t limit = matcher->max_edits + 1;
+    size_t* prev = matcher->rows;
+    size_t* cur = matcher->rows + len + 1;
+    for (size_t j = 0; j <= len; ++j) {
+        prev[j] = j;
+    }
+    for (size_t i = 1; i <= str_len; ++i) {
+        unsigned char c = sti_fold((unsigned char) str[i - 1]);
+        cur[0] = i;
+        size_t row_min = cur[0];
+        for (size_t j = 1; j <= len; ++j) {
+            size_t cost = 
+                (c == sti_fold((unsigned char) matcher->value[j - 1])) ? 0 : 1;
+            size_t best = prev[j - 1] + cost;
+            if (prev[j] + 1 < best) {
+                best = prev[j] + 1;
+            }
+            if (cur[j - 1] + 1 < best) {
+                best = cur[j - 1] + 1;
+            }
+            cur[j] = best;
+            if (best < row_min) {
+                row_min = best;
+            }
+        }
+        if (row_min >= limit) {
+            // Distances never decrease from row to row
+            return limit;
+        }
+        size_t* tmp = prev;
+        prev = cur;
+        cur = tmp;
+    }
+    return (prev[len] < limit) ? prev[len] : limit;
+}
+
+/**
+ * Returns nonzero if memory allocation fails
+*/
+static int sti_try(sti_matcher* matcher, size_t pos) {
+    const char* surname = matcher->collection->students[pos].surname;
+    size_t surname_len = strlen(surname);
+    size_t len_diff = (surname_len > matcher->value_len) ? 
+        surname_len - matcher->value_len : matcher->value_len - surname_len;
+    if (len_diff > matcher->max_edits) {
+        return 0;
+    }
+    size_t distance = sti_edit_distance(matcher, surname, surname_len);
+    if (distance > matcher->max_edits) {
+        return 0;
+    }
+    if (matcher->matches_num == matcher->matches_capacity) {
+        size_t new_capacity = (0 == matcher->matches_capacity) ? 
+            16 : matcher->matches_capacity * 2;
+        sti_match* new_matches = (sti_match*) 
+            realloc(matcher->matches, sizeof(*new_matches) * new_capacity);
+        if (NULL == new_matches) {
+            return 1;
+        }
+        matcher->matches = new_matches;
+        matcher->matches_capacity = new_capacity;
+    }
+    matcher->matches[matcher->matches_num].distance = distance;
+    matcher->matches[matcher->matches_num].pos = pos;
+    matcher->matches_num++;
+    return 0;
+}
+
+static int sti_try_range(sti_matcher* matcher, size_t from, size_t to) {
+    for (size_t pos = from; pos < to; ++pos) {
+        if (0 != sti_try(matcher, pos)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int sti_compare_matches(const void* arg1, const void* arg2) {
+    const sti_match* match1 = (const sti_match*) arg1;
+    const sti_match* match2 = (const sti_match*) arg2;
+    if (match1->distance != match2->distance) {
+        return (match1->distance > match2->distance) - 
+            (match1->distance < match2->distance);
+    }
+    return (match1->pos > match2->pos) - (match1->pos < match2->pos);
+}
+
+/**
+ * Turns matches into a view and frees matcher, 
+ *  'failed' tells that matching was not finished
+*/
+static students_view* sti_matcher_finish(sti_matcher* matcher, bool failed) {
+    students_view* result = NULL;
+    if (!failed) {
+        if (1 < matcher->matches_num) {
+            qsort(matcher->matches, matcher->matches_num, 
+                  sizeof(*(matcher->matches)), sti_compare_matches);
+        }
+        result = stv_new(matcher->collection, matcher->matches_num);
+        for (size_t i = 0; (NULL != result) && (i < matcher->matches_num); ++i) {
+            result->positions[i] = matcher->matches[i].pos;
+        }
+    }
+    free(matcher->rows);
+    free(matcher->matches);
+    return result;
+}
+
+students_view* st_view_fuzzy_surname(const students_array* collection, 
+                                     const char* value, size_t max_edits) {
+    assert(NULL != collection);
+    assert(NULL != value);
+    sti_matcher matcher;
+    if (0 != sti_matcher_init(&matcher, collection, value, max_edits)) {
+        return sti_matcher_finish(&matcher, true);
+    }
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    return sti_matcher_finish(&matcher, 0 != sti_try_range(&matcher, 0, n));
+}
+
+/******************** Index building ********************/
+
+/**
+ * Pairs are (trigram << 32) | pos, stably sorted by trigram 
+ *  (bits 32..55) with LSD radix sort, so positions stay ascending
+*/
+static void sti_sort_pairs(uint64_t* pairs, uint64_t* tmp, size_t pairs_num) {
+    for (size_t shift = 32; shift < 56; shift += 8) {
+        size_t offsets[STI_BUCKETS_NUM];
+        memset(offsets, 0, sizeof(offsets));
+        for (size_t i = 0; i < pairs_num; ++i) {
+            offsets[(pairs[i] >> shift) & 0xFF]++;
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < STI_BUCKETS_NUM; ++bucket) {
+            size_t count = offsets[bucket];
+            offsets[bucket] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < pairs_num; ++i) {
+            tmp[offsets[(pairs[i] >> shift) & 0xFF]++] = pairs[i];
+        }
+        memcpy(pairs, tmp, sizeof(*pairs) * pairs_num);
+    }
+}
+
+static void sti_free_lists(surname_trigram_index* index) {
+    free(index->trigrams);
+    free(index->offsets);
+    free(index->postings);
+    index->trigrams = NULL;
+    index->offsets = NULL;
+    index->postings = NULL;
+    index->trigrams_num = 0;
+}
+
+/**
+ * (Re)builds posting lists for all current entries.
+ * Returns nonzero if memory allocation fails, index is empty then
+*/
+static int sti_build(surname_trigram_index* index) {
+    const students_array* collection = index->collection;
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    sti_free_lists(index);
+    index->indexed_num = 0;
+    index->generation = collection->generation;
+    if (UINT32_MAX < n) {
+        return 1;
+    }
+    size_t pairs_num = 0;
+    size_t max_len = 0;
+    for (size_t i = 0; i < n; ++i) {
+        size_t len = strlen(collection->students[i].surname);
+        pairs_num += len + 1;
+        if (len > max_len) {
+            max_len = len;
+        }
+    }
+    uint64_t* pairs = (uint64_t*) malloc(sizeof(*pairs) * (2 * pairs_num + 1));
+    uint32_t* trigrams = (uint32_t*) malloc(sizeof(*trigrams) * (max_len + 1));
+    if (NULL == pairs || NULL == trigrams) {
+        free(pairs);
+        free(trigrams);
+        return 1;
+    }
+    size_t pair_idx = 0;
+    for (size_t i = 0; i < n; ++i) {
+        size_t trigrams_num = 
+            sti_trigrams_of(collection->students[i].surname, trigrams);
+        for (size_t j = 0; j < trigrams_num; ++j) {
+            pairs[pair_idx++] = ((uint64_t) trigrams[j] << 32) | i;
+        }
+    }
+    free(trigrams);
+    sti_sort_pairs(pairs, pairs + pairs_num, pairs_num);
+    // Same trigram can occur in a surname more than once
+    size_t distinct_pairs_num = 0;
+    size_t distinct_trigrams_num = 0;
+    for (size_t i = 0; i < pairs_num; ++i) {
+        if ((0 == i) || (pairs[i] != pairs[i - 1])) {
+            distinct_pairs_num++;
+            if ((0 == i) || ((pairs[i] >> 32) != (pairs[i - 1] >> 32))) {
+                distinct_trigrams_num++;
+            }
+        }
+    }
+    index->trigrams = (uint32_t*) 
+        malloc(sizeof(*(index->trigrams)) * (distinct_trigrams_num + 1));
+    index->offsets = (size_t*) 
+        malloc(sizeof(*(index->offsets)) * (distinct_trigrams_num + 1));
+    index->postings = (uint32_t*) 
+        malloc(sizeof(*(index->postings)) * (distinct_pairs_num + 1));
+    if (NULL == index->trigrams || NULL == index->offsets || 
+        NULL == index->postings) {
+        sti_free_lists(index);
+        free(pairs);
+        return 1;
+    }
+    size_t postings_num = 0;
+    size_t trigrams_num = 0;
+    for (size_t i = 0; i < pairs_num; ++i) {
+        if ((0 != i) && (pairs[i] == pairs[i - 1])) {
+            continue;
+        }
+        uint32_t trigram = (uint32_t) (pairs[i] >> 32);
+        if ((0 == trigrams_num) || (index->trigrams[trigrams_num - 1] != trigram)) {
+            index->trigrams[trigrams_num] = trigram;
+            index->offsets[trigrams_num] = postings_num;
+            trigrams_num++;
+        }
+        index->postings[postings_num++] = (uint32_t) pairs[i];
+    }
+    index->offsets[trigrams_num] = postings_num;
+    index->trigrams_num = trigrams_num;
+    index->indexed_num = n;
+    free(pairs);
+    return 0;
+}
+
+surname_trigram_index* sti_new(const students_array* collection) {
+    assert(NULL != collection);
+    surname_trigram_index* result = 
+        (surname_trigram_index*) malloc(sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    result->collection = collection;
+    result->trigrams = NULL;
+    result->offsets = NULL;
+    result->postings = NULL;
+    result->trigrams_num = 0;
+    if (0 != sti_build(result)) {
+        sti_destroy(&result);
+    }
+    return result;
+}
+
+void sti_destroy(surname_trigram_index** index) {
+    assert(NULL != index);
+    if (NULL == *index) {
+        return;
+    }
+    sti_free_lists(*index);
+    free(*index);
+    *index = NULL;
+}
+
+/**
+ * Rebuilds index if it is stale or too many entries are not indexed
+*/
+static int sti_refresh(surname_trigram_index* index) {
+    const students_array* collection = index->collection;
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    if (index->generation == collection->generation) {
+        size_t unindexed_limit = index->indexed_num / 8;
+        if (unindexed_limit < STI_MIN_UNINDEXED_LIMIT) {
+            unindexed_limit = STI_MIN_UNINDEXED_LIMIT;
+        }
+        if (n - index->indexed_num <= unindexed_limit) {
+            return 0;
+        }
+    }
+    return sti_build(index);
+}
+
+/******************** Index lookup ********************/
+
+typedef struct sti_list {
+    const uint32_t* begin;
+    const uint32_t* end;
+} sti_list;
+
+static int sti_compare_uint32(const void* arg1, const void* arg2) {
+    uint32_t val1 = *((const uint32_t*) arg1);
+    uint32_t val2 = *((const uint32_t*) arg2);
+    return (val1 > val2) - (val1 < val2);
+}
+
+static int sti_compare_lists_len(const void* arg1, const void* arg2) {
+    const sti_list* list1 = (const sti_list*) arg1;
+    const sti_list* list2 = (const sti_list*) arg2;
+    size_t len1 = list1->end - list1->begin;
+    size_t len2 = list2->end - list2->begin;
+    return (len1 > len2) - (len1 < len2);
+}
+
+static sti_list sti_posting_list(const surname_trigram_index* index, 
+                                 uint32_t trigram) {
+    sti_list result = {NULL, NULL};
+    if (0 == index->trigrams_num) {
+        return result;
+    }
+    const uint32_t* found = (const uint32_t*) bsearch(&trigram, index->trigrams, 
+        index->trigrams_num, sizeof(*(index->trigrams)), sti_compare_uint32);
+    if (NULL != found) {
+        size_t i = found - index->trigrams;
+        result.begin = index->postings + index->offsets[i];
+        result.end = index->postings + index->offsets[i + 1];
+    }
+    return result;
+}
+
+/**
+ * Finds entries having at least 'threshold' of 'lists_num' trigrams 
+ *  and scores them. Lists are sorted by length: any such entry 
+ *  is in one of the first lists_num - threshold + 1 lists, 
+ *  so only they are merged, the longer ones are binary searched
+*/
+static int sti_try_candidates(sti_matcher* matcher, sti_list* lists, 
+                              size_t lists_num, size_t threshold) {
+    size_t merged_num = lists_num - threshold + 1;
+    while (true) {
+        uint32_t pos = UINT32_MAX;
+        bool found = false;
+        for (size_t i = 0; i < merged_num; ++i) {
+            if ((lists[i].begin != lists[i].end) && 
+                (!found || *(lists[i].begin) < pos)) {
+                pos = *(lists[i].begin);
+                found = true;
+            }
+        }
+        if (!found) {
+            return 0;
+        }
+        size_t count = 0;
+        for (size_t i = 0; i < merged_num; ++i) {
+            if ((lists[i].begin != lists[i].end) && (*(lists[i].begin) == pos)) {
+                lists[i].begin++;
+                count++;
+            }
+        }
+        for (size_t i = merged_num; 
+             (i < lists_num) && (count < threshold) && 
+             (count + (lists_num - i) >= threshold); ++i) {
+            count += (lists[i].begin != lists[i].end) && 
+                (NULL != bsearch(&pos, lists[i].begin, 
+                                 lists[i].end - lists[i].begin, 
+                                 sizeof(pos), sti_compare_uint32));
+        }
+        if ((count >= threshold) && (0 != sti_try(matcher, pos))) {
+            return 1;
+        }
+    }
+}
+
+students_view* sti_find_fuzzy(surname_trigram_index* index, 
+                              const char* value, size_t max_edits) {
+    assert(NULL != index);
+    assert(NULL != value);
+    if (0 != sti_refresh(index)) {
+        return NULL;
+    }
+    const students_array* collection = index->collection;
+    size_t n = (NULL == collection->students) ? 0 : collection->students_num;
+    sti_matcher matcher;
+    if (0 != sti_matcher_init(&matcher, collection, value, max_edits)) {
+        return sti_matcher_finish(&matcher, true);
+    }
+    uint32_t* trigrams = (uint32_t*) 
+        malloc(sizeof(*trigrams) * (matcher.value_len + 1));
+    sti_list* lists = (sti_list*) malloc(sizeof(*lists) * (matcher.value_len + 1));
+    if (NULL == trigrams || NULL == lists) {
+        free(trigrams);
+        free(lists);
+        return sti_matcher_finish(&matcher, true);
+    }
+    size_t trigrams_num = sti_trigrams_of(value, trigrams);
+    qsort(trigrams, trigrams_num, sizeof(*trigrams), sti_compare_uint32);
+    size_t distinct_num = 0;
+    for (size_t i = 0; i < trigrams_num; ++i) {
+        if ((0 == i) || (trigrams[i] != trigrams[i - 1])) {
+            lists[distinct_num++] = sti_posting_list(index, trigrams[i]);
+        }
+    }
+    free(trigrams);
+    int failed = 0;
+    if ((SIZE_MAX / 3 < max_edits) || (distinct_num <= 3 * max_edits)) {
+        // Every entry may be close enough
+        failed = sti_try_range(&matcher, 0, n);
+    }
+    else {
+        qsort(lists, distinct_num, sizeof(*lists), sti_compare_lists_len);
+        failed = sti_try_candidates(&matcher, lists, distinct_num, 
+                                    distinct_num - 3 * max_edits);
+        if (0 == failed) {
+            failed = sti_try_range(&matcher, index->indexed_num, n);
+        }
+    }
+    free(lists);
+    return sti_matcher_finish(&matcher, 0 != failed);
+}
@@ -0,0 +1,52 @@
+#ifndef SURNAME_TRIGRAM_INDEX_W_OPS_H
+#define SURNAME_TRIGRAM_INDEX_W_OPS_H
+
+#include <stddef.h>
+#include "surname_trigram_index_struct.h"
+#include "students_view_struct.h"
+
+/**
+ * Fuzzy surname search.
+ * Distance is Levenshtein distance (insertions, deletions and 
+ *  substitutions of single bytes) ignoring ASCII letter case,
+ *  so "John" matches "john" exactly and "Bohn" with one edit.
+ * Results are views (see students_view_struct.h) of entries 
+ *  within 'max_edits' edits from the value, 
+ *  ordered by distance, equally distant ones in array order.
+ * NULL is returned if memory allocation fails
+*/
+
+/**
+ * Scans the whole collection, no index needed
+*/
+students_view* st_view_fuzzy_surname(const students_array* collection, 
+                                     const char* value, size_t max_edits);
+
+/**
+ * Builds index over surnames of 'collection'.
+ * Index only reads collection and doesn't have to be rebuilt by hand:
+ *  sti_find_fuzzy() rebuilds it after entries are changed, deleted or moved 
+ *  (see 'generation' field of students_array), 
+ *  entries appended since the build are checked without index 
+ *  until there are enough of them to rebuild.
+ * Collections of more than UINT32_MAX entries are not supported.
+ * Returns NULL if memory allocation fails
+*/
+surname_trigram_index* sti_new(const students_array* collection);
+
+/**
+ * Same as st_view_fuzzy_surname() on indexed collection.
+ * String within d edits from value shares all but at most 3 * d 
+ *  of value's distinct trigrams, so only entries sharing enough of them 
+ *  are scored. If value is too short for that to filter anything,
+ *  the whole collection is scanned
+*/
+students_view* sti_find_fuzzy(surname_trigram_index* index, 
+                              const char* value, size_t max_edits);
+
+/**
+ * Sets *index to NULL after freeing, collection is not touched
+*/
+void sti_destroy(surname_trigram_index** index);
+
+#endif
@@ -4,6 +4,20 @@
 
 #include "student_w_ops.h"
 #include "students_array_w_ops.h"
+#include "students_columns_w_ops.h"
+#include "students_snapshot_w_ops.h"
+#include "students_loader_w_ops.h"
+#include "students_view_w_ops.h"
+#include "students_top_k_w_ops.h"
+#include "surname_trigram_index_w_ops.h"
+#include "students_tree_w_ops.h"
+#include "students_shared_w_ops.h"
+#include "students_journal_w_ops.h"
+#include "students_groups_w_ops.h"
+#include "students_filter_w_ops.h"
+#include "students_bitmap_index_w_ops.h"
+#include "surname_sorted_index_w_ops.h"
+#include "students_aggregates_w_ops.h"
 
 bool predicate_to_delete(const student* s) {
     return s->grade_book_num == 55;
@@ -13,6 +27,10 @@ bool predicate_to_replace(const student* s) {
     return s->grade_book_num == 22;
 }
 
+bool has_faculty(const student* s, const void* faculty) {
+    return 0 == strcmp(s->faculty, (const char*) faculty);
+}
+
 void* group_numbers_sum(const student* s, void* acc) {
     void* result = acc;
     /**
@@ -34,6 +52,38 @@ void* group_numbers_sum(const student* s, void* acc) {
     return result_casted;
 }
 
+int surname_desc(const void* arg1, const void* arg2) {
+    return strcmp(((const student*) arg2)->surname, 
+                  ((const student*) arg1)->surname);
+}
+
+void sum_step(void* acc, const student* s) {
+    *((size_t*) acc) += s->grade_book_num;
+}
+
+void sum_combine(void* acc, const void* other) {
+    *((size_t*) acc) += *((const size_t*) other);
+}
+
+bool copy_file(const char* from, const char* to) {
+    FILE* in = fopen(from, "rb");
+    FILE* out = fopen(to, "wb");
+    bool copied = (NULL != in) && (NULL != out);
+    char buffer[4096];
+    size_t read_num = 0;
+    while (copied && (0 < (read_num = fread(buffer, 1, sizeof(buffer), in)))) {
+        copied = (read_num == fwrite(buffer, 1, read_num, out));
+    }
+    if (NULL != in) {
+        copied = copied && !ferror(in);
+        fclose(in);
+    }
+    if (NULL != out) {
+        copied = (0 == fclose(out)) && copied;
+    }
+    return copied;
+}
+
 int main() {
     students_array* array = st_new_array(0);
     if (NULL == array) {
@@ -50,6 +100,32 @@ int main() {
         }
     }
 
+    size_t count_id = 0;
+    size_t sum_id = 0;
+    size_t faculty_counts_id = 0;
+    if ((0 != st_register_aggregate(array, &sag_count, &count_id)) || 
+        (0 != st_register_aggregate(array, &sag_sum_grade_book_num, &sum_id)) || 
+        (0 != st_register_aggregate(array, &sag_faculty_counts, &faculty_counts_id))) {
+        fprintf(stderr, "st_register_aggregate failed\n");
+        sts_destroy_all(&array);
+        return 22;
+    }
+
+    if (0 != st_build_grade_book_index(array)) {
+        fprintf(stderr, "st_build_grade_book_index failed\n");
+        sts_destroy_all(&array);
+        return 7;
+    }
+
+    // Building index doesn't add entries, so aggregates must not change
+    const size_t* materialized_count = st_aggregate(array, count_id);
+    if ((NULL == materialized_count) || 
+        (*materialized_count != array->students_num)) {
+        fprintf(stderr, "Aggregates changed by st_build_grade_book_index\n");
+        sts_destroy_all(&array);
+        return 22;
+    }
+
     sts_formatted_print_all(array, stdout);
 
     FILE* file = fopen("./build/out.txt", "w");
@@ -102,6 +178,27 @@ int main() {
     printf("Folding result: %zu\n", *((size_t*) folding_result));
     free(folding_result);
 
+    const long long* materialized_sum = st_aggregate(array, sum_id);
+    const students_key_counts* faculty_counts = 
+        st_aggregate(array, faculty_counts_id);
+    if (NULL == materialized_sum || NULL == faculty_counts) {
+        fprintf(stderr, "st_aggregate failed\n");
+        sts_destroy_all(&array);
+        return 22;
+    }
+    printf("Materialized sum: %lld, entries with faculty DDD: %zu\n", 
+           *materialized_sum, sag_key_count(faculty_counts, "DDD"));
+
+    size_t zero = 0;
+    students_reducer sum_reducer = {sizeof(size_t), &zero, sum_step, sum_combine};
+    size_t reducing_result = 0;
+    if (0 != sts_reduce(array, &sum_reducer, &reducing_result, 0)) {
+        fprintf(stderr, "sts_reduce failed\n");
+        sts_destroy_all(&array);
+        return 8;
+    }
+    printf("Reducing result: %zu\n", reducing_result);
+
     sts_sort_surname_desc(array);
 
     printf("Surname desc\n");
@@ -126,6 +223,12 @@ int main() {
 
     sts_formatted_print_all(array, stdout);
 
+    if (0 != st_enable_dictionary(array)) {
+        fprintf(stderr, "st_enable_dictionary failed\n");
+        sts_destroy_all(&array);
+        return 6;
+    }
+
     sts_sort_faculty_asc(array);
 
     printf("Faculty asc\n");
@@ -150,6 +253,12 @@ int main() {
 
     sts_formatted_print_all(array, stdout);
 
+    student* student_with_faculty = st_find_one_exact_faculty(array, "DDD");
+
+    printf("Student found: \n");
+
+    st_formatted_print(student_with_faculty, stdout);
+
     student* student_with_surname = st_find_one_exact_surname(array, "def");
 
     printf("Student found: \n");
@@ -160,10 +269,335 @@ int main() {
 
     sts_formatted_print_all(students_with_close_book, stdout);
     
-    // Not calling sts_destroy_all on subarray to avoid double-free of strings
+    // Subarray only borrows strings, so this frees just its buffer
+    sts_destroy_all(&students_with_close_book);
+
+    students_array* students_with_book = st_find_all_exact_grade_book_num(array, 33);
+
+    printf("Students with grade book 33: \n");
+
+    sts_formatted_print_all(students_with_book, stdout);
+
+    sts_destroy_all(&students_with_book);
+
+    students_view* faculty_view = st_view_all_closest_faculty(array, "CCD");
+    if (NULL == faculty_view) {
+        fprintf(stderr, "st_view_all_closest_faculty failed\n");
+        sts_destroy_all(&array);
+        return 12;
+    }
+    stv_sort(faculty_view, surname_desc);
+    students_view* filtered_view = stv_filter(faculty_view, has_faculty, "DDD");
+    stv_destroy(&faculty_view);
+    if (NULL == filtered_view) {
+        fprintf(stderr, "stv_filter failed\n");
+        sts_destroy_all(&array);
+        return 12;
+    }
+    printf("Closest to faculty CCD with faculty DDD: \n");
+
+    stv_formatted_print_all(filtered_view, stdout);
+
+    stv_destroy(&filtered_view);
+
+    students_view* top_view = st_view_top_k_closest_grade_book_num(array, 30, 3);
+    if (NULL == top_view) {
+        fprintf(stderr, "st_view_top_k_closest_grade_book_num failed\n");
+        sts_destroy_all(&array);
+        return 13;
+    }
+    printf("3 closest to grade book 30: \n");
+
+    stv_formatted_print_all(top_view, stdout);
+
+    stv_destroy(&top_view);
+
+    surname_trigram_index* trigram_index = sti_new(array);
+    students_view* fuzzy_view = 
+        (NULL == trigram_index) ? NULL : sti_find_fuzzy(trigram_index, "DEG", 1);
+    sti_destroy(&trigram_index);
+    if (NULL == fuzzy_view) {
+        fprintf(stderr, "Fuzzy surname search failed\n");
+        sts_destroy_all(&array);
+        return 14;
+    }
+    printf("Surnames within 1 edit from DEG: \n");
+
+    stv_formatted_print_all(fuzzy_view, stdout);
+
+    stv_destroy(&fuzzy_view);
+
+    students_tree* tree = stt_new_from_array(array, STS_SORTED_BY_GRADE_BOOK_NUM);
+    if (NULL == tree) {
+        fprintf(stderr, "stt_new_from_array failed\n");
+        sts_destroy_all(&array);
+        return 15;
+    }
+    student tree_probe = {NULL, 30, NULL, NULL};
+    const student* tree_closest = stt_find_closest(tree, &tree_probe);
+    if (NULL != tree_closest) {
+        printf("Closest to 30 in tree: \n");
+        st_formatted_print(tree_closest, stdout);
+        tree_probe.grade_book_num = tree_closest->grade_book_num;
+        stt_delete_first(tree, &tree_probe);
+    }
+    printf("Tree without it: \n");
+
+    stt_formatted_print_all(tree, stdout);
+
+    stt_destroy(&tree);
 
-    free(students_with_close_book->students);
-    free(students_with_close_book);
+    students_shared* shared = 
+        stsh_new_from_array(array, STS_SORTED_BY_GRADE_BOOK_NUM);
+    student shared_entry = {"xyz", 1, "AAA", "99"};
+    if ((NULL == shared) || (0 != stsh_add(shared, &shared_entry)) || 
+        (0 != stsh_del_all_where(shared, has_faculty, "DDD")) || 
+        (0 != stsh_publish(shared))) {
+        fprintf(stderr, "students_shared update failed\n");
+        stsh_destroy(&shared);
+        sts_destroy_all(&array);
+        return 16;
+    }
+    size_t reader = stsh_reader_register(shared);
+    const students_array* version = stsh_read_begin(shared, reader);
+    printf("Published version without faculty DDD: \n");
+
+    sts_formatted_print_all(version, stdout);
+
+    stsh_read_end(shared, reader);
+    stsh_reader_unregister(shared, reader);
+    stsh_destroy(&shared);
+
+    remove("./build/test_journal.bin");
+    remove("./build/test_journal.bin.journal");
+    remove("./build/test_journal.bin.journal.next");
+    int journal_error = 0;
+    students_journal* journal = 
+        stj_open("./build/test_journal.bin", NULL, &journal_error);
+    students_sort_spec journal_keys[1] = {{STS_SORTED_BY_SURNAME, false}};
+    for (size_t i = 0; (NULL != journal) && (0 == journal_error) && 
+                       (i < array->students_num); ++i) {
+        journal_error = stj_add(journal, array->students[i]);
+    }
+    if ((NULL != journal) && (0 == journal_error)) {
+        journal_error = stj_del_all_where_ctx(journal, has_faculty, "DDD");
+    }
+    if ((NULL != journal) && (0 == journal_error)) {
+        journal_error = stj_sort_multi_key(journal, journal_keys, 1);
+    }
+    if ((NULL != journal) && (0 == journal_error)) {
+        journal_error = stj_close(&journal);
+        journal = stj_open("./build/test_journal.bin", NULL, &journal_error);
+    }
+    if (NULL == journal) {
+        fprintf(stderr, "Journal round trip failed with code %d\n", journal_error);
+        sts_destroy_all(&array);
+        return 17;
+    }
+    printf("Recovered from journal, by surname, without faculty DDD: \n");
+
+    sts_formatted_print_all(journal->collection, stdout);
+
+    // Next journal left by a crash after compaction saved its records
+    size_t journal_students_num = journal->collection->students_num;
+    if (!copy_file("./build/test_journal.bin.journal", 
+                   "./build/test_journal.bin.stale") || 
+        (0 != stj_compact(journal)) || (0 != stj_close(&journal)) || 
+        (0 != rename("./build/test_journal.bin.stale", 
+                     "./build/test_journal.bin.journal.next"))) {
+        fprintf(stderr, "Journal compaction failed\n");
+        stj_close(&journal);
+        sts_destroy_all(&array);
+        return 17;
+    }
+    journal = stj_open("./build/test_journal.bin", NULL, &journal_error);
+    if ((NULL == journal) || 
+        (journal_students_num != journal->collection->students_num)) {
+        fprintf(stderr, "Stale next journal was replayed\n");
+        stj_close(&journal);
+        sts_destroy_all(&array);
+        return 17;
+    }
+
+    stj_close(&journal);
+
+    students_reducer group_aggregates[3] = {
+        stg_count, stg_min_grade_book_num, stg_max_grade_book_num
+    };
+    students_groups* faculty_groups = 
+        sts_group_by(array, stg_key_faculty, group_aggregates, 3, 0);
+    if (NULL == faculty_groups) {
+        fprintf(stderr, "sts_group_by failed\n");
+        sts_destroy_all(&array);
+        return 18;
+    }
+    printf("Faculties: count, min and max grade book number: \n");
+    for (size_t i = 0; i < faculty_groups->groups_num; ++i) {
+        printf("%s: %zu %d %d\n", faculty_groups->keys[i].str, 
+               *((const size_t*) stg_acc(faculty_groups, i, 0)), 
+               *((const int*) stg_acc(faculty_groups, i, 1)), 
+               *((const int*) stg_acc(faculty_groups, i, 2)));
+    }
+    stg_destroy(&faculty_groups);
+
+    students_bitmap_index* bitmap_index = sbi_new(array);
+    students_filter* filter = stf_new();
+    students_view* filtered = NULL;
+    if ((NULL != bitmap_index) && (NULL != filter) && 
+        (0 == stf_faculty_eq(filter, "DDD")) && 
+        (0 == stf_grade_book_num_between(filter, 10, 30)) && 
+        (0 == stf_or(filter))) {
+        filtered = sbi_find_all(bitmap_index, filter);
+    }
+    stf_destroy(&filter);
+    sbi_destroy(&bitmap_index);
+    if (NULL == filtered) {
+        fprintf(stderr, "sbi_find_all failed\n");
+        sts_destroy_all(&array);
+        return 19;
+    }
+    printf("Faculty DDD or grade book number in [10, 30]: \n");
+
+    stv_formatted_print_all(filtered, stdout);
+
+    stv_destroy(&filtered);
+
+    surname_sorted_index* surname_index = ssi_new(array);
+    students_view* surname_range = NULL;
+    if (NULL != surname_index) {
+        surname_range = ssi_find_range(surname_index, "a", "n");
+    }
+    ssi_destroy(&surname_index);
+    if (NULL == surname_range) {
+        fprintf(stderr, "ssi_find_range failed\n");
+        sts_destroy_all(&array);
+        return 20;
+    }
+    printf("Surnames in [a, n): \n");
+
+    stv_formatted_print_all(surname_range, stdout);
+
+    stv_destroy(&surname_range);
+
+    students_view* page = st_view_page(array, surname_desc, 2, 2);
+    if (NULL == page) {
+        fprintf(stderr, "st_view_page failed\n");
+        sts_destroy_all(&array);
+        return 21;
+    }
+    printf("By surname descending, page 2 of 2 entries: \n");
+
+    stv_formatted_print_all(page, stdout);
+
+    stv_destroy(&page);
+
+    students_columns* columns = stc_new_from_array(array);
+    if (NULL == columns) {
+        fprintf(stderr, "stc_new_from_array failed\n");
+        sts_destroy_all(&array);
+        return 9;
+    }
+    size_t closest_pos = stc_find_one_closest_grade_book_num(columns, 30);
+    if (STC_NOT_FOUND != closest_pos) {
+        student closest_student;
+        stc_get(columns, closest_pos, &closest_student);
+        printf("Closest to 30 in columns: \n");
+        st_formatted_print(&closest_student, stdout);
+    }
+    size_t* surname_positions = NULL;
+    size_t surname_found_num = 0;
+    if (0 == stc_find_all_exact_surname(columns, "def", 
+                                        &surname_positions, &surname_found_num)) {
+        printf("Surname def in columns: %zu times\n", surname_found_num);
+    }
+    free(surname_positions);
+    // Long lines make getline() move its buffer between fields
+    char columns_input[] = "klm\n44\n"
+        "FACULTY_NAME_LONGER_THAN_INITIAL_GETLINE_BUFFER_"
+        "FACULTY_NAME_LONGER_THAN_INITIAL_GETLINE_BUFFER_"
+        "FACULTY_NAME_LONGER_THAN_INITIAL_GETLINE_BUFFER\n55\n";
+    FILE* columns_stream = fmemopen(columns_input, strlen(columns_input), "r");
+    student added_student;
+    if ((NULL == columns_stream) || 
+        (0 != stc_interactive_add(columns, columns_stream, stdout))) {
+        fprintf(stderr, "stc_interactive_add failed\n");
+        if (NULL != columns_stream) {
+            fclose(columns_stream);
+        }
+        stc_destroy(&columns);
+        sts_destroy_all(&array);
+        return 9;
+    }
+    fclose(columns_stream);
+    stc_get(columns, columns->students_num - 1, &added_student);
+    printf("Added to columns: \n");
+    st_formatted_print(&added_student, stdout);
+    stc_destroy(&columns);
+
+    int snapshot_error = sts_snapshot_save(array, "./build/test_snapshot.bin");
+    students_array* mapped_array = (0 == snapshot_error) ?
+        sts_snapshot_load("./build/test_snapshot.bin", true, &snapshot_error) : NULL;
+    if (NULL == mapped_array) {
+        fprintf(stderr, "Snapshot round trip failed with code %d\n", snapshot_error);
+        sts_destroy_all(&array);
+        return 10;
+    }
+    printf("Snapshot has %zu entries, with faculty DDD: \n", mapped_array->students_num);
+    st_formatted_print(st_find_one_exact_faculty(mapped_array, "DDD"), stdout);
+    sts_destroy_all(&mapped_array);
+
+    students_array* arena_array = st_new_array_arena(0);
+    if (NULL == arena_array) {
+        fprintf(stderr, "st_new_array_arena failed\n");
+        sts_destroy_all(&array);
+        return 4;
+    }
+    for (size_t i = 0; i < array->students_num; ++i) {
+        // Arena collection copies strings, array keeps its own ones
+        if (0 != st_add(arena_array, array->students[i])) {
+            fprintf(stderr, "st_add to arena collection failed\n");
+            sts_destroy_all(&arena_array);
+            sts_destroy_all(&array);
+            return 5;
+        }
+    }
+    size_t deleted_num = st_del_all_where_ctx(arena_array, has_faculty, "BBB");
+    printf("Deleted %zu entries with faculty BBB\n", deleted_num);
+
+    printf("Arena collection\n");
+
+    sts_formatted_print_all(arena_array, stdout);
+
+    sts_destroy_all(&arena_array);
+
+    char csv_data[] = "pqr,66,FFF,77\n\"s,t\",77,GGG,88\nbad,-1,HHH,99\n";
+    FILE* csv_stream = fmemopen(csv_data, strlen(csv_data), "r");
+    students_array* loaded_array = st_new_array_arena(0);
+    size_t malformed_num = 0;
+    if ((NULL == csv_stream) || (NULL == loaded_array) || 
+        (0 != st_load(loaded_array, csv_stream, STS_FORMAT_CSV, stdout, &malformed_num))) {
+        fprintf(stderr, "st_load failed\n");
+        if (NULL != csv_stream) {
+            fclose(csv_stream);
+        }
+        sts_destroy_all(&loaded_array);
+        sts_destroy_all(&array);
+        return 11;
+    }
+    fclose(csv_stream);
+    printf("Loaded from CSV, %zu malformed\n", malformed_num);
+
+    sts_formatted_print_all(loaded_array, stdout);
+
+    sts_destroy_all(&loaded_array);
+
+    students_sort_spec sort_keys[] = {
+        {STS_SORTED_BY_FACULTY, false}, {STS_SORTED_BY_GRADE_BOOK_NUM, true}
+    };
+    sts_sort_multi_key(array, sort_keys, sizeof(sort_keys) / sizeof(*sort_keys));
+    printf("Sorted by faculty, then by grade book number descending: \n");
+
+    sts_formatted_print_all(array, stdout);
 
     sts_destroy_all(&array);
     
@@ -0,0 +1,28 @@
+#ifndef THREAD_POOL_STRUCT_H
+#define THREAD_POOL_STRUCT_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/**
+ * Fixed set of worker threads executing one job at a time.
+ * Job is a number of independent tasks, 
+ *  task(i, ctx) is called once for every i in [0, tasks_num)
+*/
+typedef struct thread_pool {
+    pthread_t* threads;
+    size_t threads_num;
+    pthread_mutex_t run_mutex; // Held by tp_run() caller for the whole job
+    pthread_mutex_t mutex; // Protects everything below
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    void (*task)(size_t, void*);
+    void* ctx;
+    size_t tasks_num;
+    size_t next_task;
+    size_t done_tasks;
+    bool stopping;
+} thread_pool;
+
+#endif
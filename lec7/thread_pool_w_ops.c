@@ -0,0 +1,152 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "thread_pool_w_ops.h"
+
+/**
+ * All general comments are in header file
+*/
+
+/**
+ * Executes tasks of current job until there are none left,
+ *  pool->mutex must be locked on call and is locked on return
+*/
+static void tp_work_locked(thread_pool* pool) {
+    while ((NULL != pool->task) && (pool->next_task < pool->tasks_num)) {
+        size_t task_idx = pool->next_task++;
+        void (*task)(size_t, void*) = pool->task;
+        void* ctx = pool->ctx;
+        pthread_mutex_unlock(&(pool->mutex));
+        task(task_idx, ctx);
+        pthread_mutex_lock(&(pool->mutex));
+        pool->done_tasks++;
+        if (pool->done_tasks == pool->tasks_num) {
+            pthread_cond_broadcast(&(pool->done_cond));
+        }
+    }
+}
+
+static void* tp_worker(void* arg) {
+    thread_pool* pool = (thread_pool*) arg;
+    pthread_mutex_lock(&(pool->mutex));
+    while (!pool->stopping) {
+        if ((NULL == pool->task) || (pool->next_task >= pool->tasks_num)) {
+            pthread_cond_wait(&(pool->work_cond), &(pool->mutex));
+            continue;
+        }
+        tp_work_locked(pool);
+    }
+    pthread_mutex_unlock(&(pool->mutex));
+    return NULL;
+}
+
+static void tp_stop_workers(thread_pool* pool, size_t started_num) {
+    pthread_mutex_lock(&(pool->mutex));
+    pool->stopping = true;
+    pthread_cond_broadcast(&(pool->work_cond));
+    pthread_mutex_unlock(&(pool->mutex));
+    for (size_t i = 0; i < started_num; ++i) {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+
+thread_pool* tp_new(size_t threads_num) {
+    thread_pool* result = (thread_pool*) malloc(sizeof(*result));
+    if (NULL == result) {
+        return NULL;
+    }
+    result->threads = NULL;
+    if (0 != threads_num) {
+        result->threads = (pthread_t*) malloc(sizeof(pthread_t) * threads_num);
+        if (NULL == result->threads) {
+            free(result);
+            return NULL;
+        }
+    }
+    result->threads_num = threads_num;
+    pthread_mutex_init(&(result->run_mutex), NULL);
+    pthread_mutex_init(&(result->mutex), NULL);
+    pthread_cond_init(&(result->work_cond), NULL);
+    pthread_cond_init(&(result->done_cond), NULL);
+    result->task = NULL;
+    result->ctx = NULL;
+    result->tasks_num = 0;
+    result->next_task = 0;
+    result->done_tasks = 0;
+    result->stopping = false;
+    for (size_t i = 0; i < threads_num; ++i) {
+        if (0 != pthread_create(result->threads + i, NULL, tp_worker, result)) {
+            tp_stop_workers(result, i);
+            result->threads_num = 0;
+            tp_destroy(&result);
+            return NULL;
+        }
+    }
+    return result;
+}
+
+void tp_run(thread_pool* pool, size_t tasks_num, 
+            void (*task)(size_t, void*), void* ctx) {
+    assert(NULL != pool);
+    assert(NULL != task);
+    if (0 == tasks_num) {
+        return;
+    }
+    pthread_mutex_lock(&(pool->run_mutex));
+    pthread_mutex_lock(&(pool->mutex));
+    pool->task = task;
+    pool->ctx = ctx;
+    pool->tasks_num = tasks_num;
+    pool->next_task = 0;
+    pool->done_tasks = 0;
+    pthread_cond_broadcast(&(pool->work_cond));
+    tp_work_locked(pool);
+    while (pool->done_tasks < pool->tasks_num) {
+        pthread_cond_wait(&(pool->done_cond), &(pool->mutex));
+    }
+    pool->task = NULL;
+    pool->ctx = NULL;
+    pthread_mutex_unlock(&(pool->mutex));
+    pthread_mutex_unlock(&(pool->run_mutex));
+}
+
+void tp_destroy(thread_pool** pool) {
+    assert(NULL != pool);
+    if (NULL == *pool) {
+        return;
+    }
+    tp_stop_workers(*pool, (*pool)->threads_num);
+    pthread_mutex_destroy(&((*pool)->run_mutex));
+    pthread_mutex_destroy(&((*pool)->mutex));
+    pthread_cond_destroy(&((*pool)->work_cond));
+    pthread_cond_destroy(&((*pool)->done_cond));
+    free((*pool)->threads);
+    free(*pool);
+    *pool = NULL;
+}
+
+size_t tp_cpus_num() {
+    long cpus_num = sysconf(_SC_NPROCESSORS_ONLN);
+    return (cpus_num < 1) ? 1 : (size_t) cpus_num;
+}
+
+static thread_pool* default_pool = NULL;
+static pthread_once_t default_pool_once = PTHREAD_ONCE_INIT;
+
+static void tp_destroy_default() {
+    tp_destroy(&default_pool);
+}
+
+static void tp_create_default() {
+    default_pool = tp_new(tp_cpus_num() - 1);
+    if (NULL != default_pool) {
+        atexit(tp_destroy_default);
+    }
+}
+
+thread_pool* tp_default() {
+    pthread_once(&default_pool_once, tp_create_default);
+    return default_pool;
+}
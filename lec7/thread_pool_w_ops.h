@@ -0,0 +1,40 @@
+#ifndef THREAD_POOL_W_OPS_H
+#define THREAD_POOL_W_OPS_H
+
+#include <stddef.h>
+#include "thread_pool_struct.h"
+
+/**
+ * Starts 'threads_num' workers (0 is allowed: then tp_run() 
+ *  executes everything in the calling thread)
+ * If memory allocation or thread creation fails, returns NULL
+*/
+thread_pool* tp_new(size_t threads_num);
+
+/**
+ * Runs task(i, ctx) for all i in [0, tasks_num) and waits for them to finish.
+ *  Calling thread executes tasks too.
+ * Jobs from different threads are executed one after another,
+ *  so tasks must not call tp_run() on the same pool
+*/
+void tp_run(thread_pool* pool, size_t tasks_num, 
+            void (*task)(size_t, void*), void* ctx);
+
+/**
+ * Stops and joins workers, sets *pool to NULL
+*/
+void tp_destroy(thread_pool** pool);
+
+/**
+ * Number of online CPUs (at least 1)
+*/
+size_t tp_cpus_num();
+
+/**
+ * Process-wide pool with tp_cpus_num() - 1 workers,
+ *  created on first call and destroyed at exit.
+ * Returns NULL if it cannot be created
+*/
+thread_pool* tp_default();
+
+#endif